@@ -1,7 +1,9 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
+import esphome.final_validate as fv
 from esphome.components import binary_sensor, switch, select, text_sensor, i2c, sensor
-from esphome.const import CONF_ID
+from esphome.const import CONF_ADDRESS, CONF_ID, CONF_INVERTED, CONF_PLATFORM
+from esphome.core import CORE
 
 CODEOWNERS = ["@jlacasse"]
 DEPENDENCIES = []
@@ -21,12 +23,52 @@ CONF_OB = "ob"
 CONF_DAMPER_OPEN = "damper_open"
 CONF_DAMPER_CLOSE = "damper_close"
 CONF_STATE_SENSOR = "state_sensor"
+CONF_DAMPER_OPEN_PIN = "damper_open_pin"
+CONF_DAMPER_CLOSE_PIN = "damper_close_pin"
 
 # Configuration keys — timing
 CONF_MIN_CYCLE_TIME = "min_cycle_time"
 CONF_PURGE_DURATION = "purge_duration"
 CONF_STAGE2_ESCALATION_DELAY = "stage2_escalation_delay"
 
+# Configuration keys — event-driven evaluation
+CONF_EVENT_DRIVEN = "event_driven"
+CONF_EVENT_LATENCY = "event_latency"
+
+# Configuration keys — event log
+CONF_LIVE_EVENT_LOG = "live_event_log"
+
+# Configuration keys — stage timing (compiled in only with the block)
+CONF_STAGE_TIMING = "stage_timing"
+CONF_PUBLISH_INTERVAL = "publish_interval"
+CONF_MAX = "max"
+CONF_MEAN = "mean"
+
+# open_zoning::Stage order
+TIMING_STAGES = (
+    "i2c_health",
+    "pass1",
+    "pass1_5",
+    "pass2",
+    "pass2_5",
+    "pass3",
+    "pass4",
+    "pass5",
+    "commit",
+    "apply_dampers",
+    "apply_outputs",
+    "apply_mode",
+    "publish",
+    "pipeline",
+    "damper_op",
+    "input_sample",
+)
+
+# Configuration keys — heap allocation monitor (debug)
+CONF_ALLOC_MONITOR = "alloc_monitor"
+CONF_ALLOCATIONS = "allocations"
+CONF_MIN_FREE_HEAP = "min_free_heap"
+
 # Configuration keys — outputs
 CONF_OUT_Y1 = "out_y1"
 CONF_OUT_Y2 = "out_y2"
@@ -36,6 +78,12 @@ CONF_OUT_W1E = "out_w1e"
 CONF_OUT_W2 = "out_w2"
 CONF_OUT_W3 = "out_w3"
 
+# Configuration keys — additional central units (the out_* keys above are unit 1)
+CONF_ADDITIONAL_UNITS = "additional_units"
+CONF_UNIT = "unit"
+# Units per controller: each unit's outputs take one byte of the output word
+MAX_UNITS = 3
+
 # Configuration keys — LEDs
 CONF_LED_HEAT = "led_heat"
 CONF_LED_COOL = "led_cool"
@@ -46,10 +94,111 @@ CONF_LED_ERROR = "led_error"
 CONF_MODE_SELECT = "mode_select"
 CONF_AUTO_MODE = "auto_mode"
 
+# Configuration keys — damper motion (concurrent per-motor scheduling)
+CONF_MAX_MOVING_DAMPERS = "max_moving_dampers"
+CONF_DAMPER_INRUSH_WINDOW = "damper_inrush_window"
+
+# Configuration keys — damper policy (PASS 4: fewer actuations)
+CONF_DAMPER_MIN_DWELL = "damper_min_dwell"
+CONF_DAMPER_IDLE_HOLD = "damper_idle_hold"
+CONF_DAMPER_CLOSE_LOOKAHEAD = "damper_close_lookahead"
+
+# Configuration keys — runtime counter sensors
+CONF_RUNTIME_SENSORS = "runtime_sensors"
+CONF_RUNTIME_PUBLISH_INTERVAL = "runtime_publish_interval"
+CONF_SENSOR = "sensor"
+CONF_ZONE = "zone"
+CONF_STATE = "state"
+CONF_MODE = "mode"
+CONF_MEASURE = "measure"
+# ZoneState values
+ZONE_STATES = {
+    "off": 0,
+    "fan_only": 1,
+    "cooling_stage1": 2,
+    "cooling_stage2": 3,
+    "heating_stage1": 4,
+    "heating_stage2": 5,
+    "purge": 6,
+    "wait": 7,
+    "error": 99,
+}
+# Mode indices (select option order)
+UNIT_MODES = {
+    "arret": 0,
+    "fan": 1,
+    "clim_stage1": 2,
+    "clim_stage2": 3,
+    "chauffage_stage1": 4,
+    "chauffage_stage2": 5,
+    "purge_chauffage": 6,
+    "purge_clim": 7,
+}
+RUNTIME_UNIT = 0xFF
+
+# Configuration keys — state journal (flash persistence)
+CONF_PERSIST_INTERVAL = "persist_interval"
+CONF_PERSIST_SLOTS = "persist_slots"
+
+# Configuration keys — damper port (batched MCP23017 OLAT writes)
+CONF_DAMPER_PORT = "damper_port"
+CONF_LED_HEAT_PIN = "led_heat_pin"
+CONF_LED_COOL_PIN = "led_cool_pin"
+CONF_LED_FAN_PIN = "led_fan_pin"
+CONF_LED_ERROR_PIN = "led_error_pin"
+NO_PIN = 255
+
+# Configuration keys — output port (central unit outputs as one OLAT write)
+CONF_OUTPUT_PORT = "output_port"
+CONF_OUT_Y1_PIN = "out_y1_pin"
+CONF_OUT_Y2_PIN = "out_y2_pin"
+CONF_OUT_G_PIN = "out_g_pin"
+CONF_OUT_OB_PIN = "out_ob_pin"
+CONF_OUT_W1E_PIN = "out_w1e_pin"
+CONF_OUT_W2_PIN = "out_w2_pin"
+CONF_OUT_W3_PIN = "out_w3_pin"
+OUTPUT_PIN_KEYS = (
+    CONF_OUT_Y1_PIN,
+    CONF_OUT_Y2_PIN,
+    CONF_OUT_G_PIN,
+    CONF_OUT_OB_PIN,
+    CONF_OUT_W1E_PIN,
+    CONF_OUT_W2_PIN,
+    CONF_OUT_W3_PIN,
+)
+
+# Configuration keys — thermostat input ports (bulk GPIO reads)
+CONF_THERMOSTAT_INPUTS = "thermostat_inputs"
+CONF_PORTS = "ports"
+CONF_PORT = "port"
+CONF_DEBOUNCE = "debounce"
+CONF_SAMPLE_INTERVAL = "sample_interval"
+CONF_PREPOSITION_DAMPERS = "preposition_dampers"
+CONF_INPUT_PINS = "input_pins"
+
+# Zones per controller: every zone mask is 16 bits wide. The codegen sizes
+# the per-zone storage to the configured count (OPEN_ZONING_MAX_ZONES).
+MAX_ZONES = 16
+
+# Thermostat input wiring of the openZoningPannel board (packages/binary_sensors.yml):
+# zones 1–4 on the first port (0x20), zones 5–6 on the second (0x21), four
+# pins per zone from the top: Y2, Y1, G, OB. Used for zones without input_pins.
+PANEL_INPUT_PINS = [
+    {CONF_PORT: 0, CONF_Y1: 14, CONF_Y2: 15, CONF_G: 13, CONF_OB: 12},
+    {CONF_PORT: 0, CONF_Y1: 10, CONF_Y2: 11, CONF_G: 9, CONF_OB: 8},
+    {CONF_PORT: 0, CONF_Y1: 6, CONF_Y2: 7, CONF_G: 5, CONF_OB: 4},
+    {CONF_PORT: 0, CONF_Y1: 2, CONF_Y2: 3, CONF_G: 1, CONF_OB: 0},
+    {CONF_PORT: 1, CONF_Y1: 14, CONF_Y2: 15, CONF_G: 13, CONF_OB: 12},
+    {CONF_PORT: 1, CONF_Y1: 10, CONF_Y2: 11, CONF_G: 9, CONF_OB: 8},
+]
+
 # Configuration keys — I2C watchdog
 CONF_I2C_BUS = "i2c_bus"
 CONF_I2C_HEALTH_SENSOR = "i2c_health_sensor"
 CONF_I2C_ERROR_THRESHOLD = "i2c_error_threshold"
+CONF_I2C_WATCHDOG_ADDRESSES = "i2c_watchdog_addresses"
+CONF_I2C_TRAFFIC_WINDOW = "i2c_traffic_window"
+CONF_I2C_REBOOT_ADDRESSES = "i2c_reboot_addresses"
 
 # Configuration keys — minimum zone demand
 CONF_MIN_ACTIVE_ZONES = "min_active_zones"
@@ -61,30 +210,343 @@ CONF_STAGE1_ELAPSED_SENSOR  = "stage1_elapsed_sensor"
 CONF_MODE_CHANGES_SENSOR    = "mode_changes_sensor"
 CONF_SHORT_CYCLE_SENSOR     = "short_cycle_sensor"
 
+# Configuration keys — diagnostic publish policies
+CONF_DIAGNOSTIC_PUBLISH = "diagnostic_publish"
+CONF_ACTIVE_ZONES = "active_zones"
+CONF_STAGE1_ELAPSED = "stage1_elapsed"
+CONF_MODE_CHANGES = "mode_changes"
+CONF_SHORT_CYCLE = "short_cycle"
+CONF_MIN_INTERVAL = "min_interval"
+CONF_MAX_INTERVAL = "max_interval"
+CONF_DEADBAND = "deadband"
+# OpenZoningController::Diagnostic order
+DIAGNOSTIC_KEYS = (CONF_ACTIVE_ZONES, CONF_STAGE1_ELAPSED, CONF_MODE_CHANGES, CONF_SHORT_CYCLE)
+
+
+
+# Per-stage timing sensors, in µs over each publish interval
+STAGE_SENSORS_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_MAX): cv.use_id(sensor.Sensor),
+        cv.Optional(CONF_MEAN): cv.use_id(sensor.Sensor),
+    }
+)
+
+STAGE_TIMING_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_PUBLISH_INTERVAL, default="60s"): cv.positive_time_period_milliseconds,
+        **{cv.Optional(stage): STAGE_SENSORS_SCHEMA for stage in TIMING_STAGES},
+    }
+)
+
+ALLOC_MONITOR_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_PUBLISH_INTERVAL, default="60s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_ALLOCATIONS): cv.use_id(sensor.Sensor),
+        cv.Optional(CONF_MIN_FREE_HEAP): cv.use_id(sensor.Sensor),
+    }
+)
+
+
+def _publish_policy_schema(deadband=0.0):
+    """Publish policy of one diagnostic sensor: on change (beyond the deadband),
+    no more often than min_interval, and at least every max_interval (0s: only
+    on change)."""
+    return cv.Schema(
+        {
+            cv.Optional(CONF_MIN_INTERVAL, default="10s"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_MAX_INTERVAL, default="15min"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_DEADBAND, default=deadband): cv.positive_float,
+        }
+    )
+
+
+DIAGNOSTIC_PUBLISH_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_ACTIVE_ZONES, default={}): _publish_policy_schema(),
+        # Seconds: with a 60 s deadband the counter moves once a minute, not every update
+        cv.Optional(CONF_STAGE1_ELAPSED, default={}): _publish_policy_schema(deadband=60.0),
+        cv.Optional(CONF_MODE_CHANGES, default={}): _publish_policy_schema(),
+        cv.Optional(CONF_SHORT_CYCLE, default={}): _publish_policy_schema(),
+    }
+)
+
+
+def _validate_diagnostic_publish(config):
+    for key, policy in config.get(CONF_DIAGNOSTIC_PUBLISH, {}).items():
+        max_interval = policy[CONF_MAX_INTERVAL].total_milliseconds
+        if 0 < max_interval < policy[CONF_MIN_INTERVAL].total_milliseconds:
+            raise cv.Invalid(
+                f"{CONF_DIAGNOSTIC_PUBLISH}.{key}: {CONF_MAX_INTERVAL} must be 0s or at least {CONF_MIN_INTERVAL}"
+            )
+    return config
+
+
+def _validate_runtime_zones(config):
+    num_zones = len(config[CONF_ZONES])
+    for conf in config.get(CONF_RUNTIME_SENSORS, []):
+        if conf.get(CONF_ZONE, 1) > num_zones:
+            raise cv.Invalid(f"'{CONF_RUNTIME_SENSORS}': zone {conf[CONF_ZONE]} is not configured")
+    return config
+
+
+def _validate_runtime_sensor(config):
+    has_zone = CONF_ZONE in config
+    if has_zone != (CONF_STATE in config) or has_zone == (CONF_MODE in config):
+        raise cv.Invalid(f"Set either '{CONF_ZONE}' and '{CONF_STATE}', or '{CONF_MODE}'")
+    if has_zone and CONF_UNIT in config:
+        raise cv.Invalid(f"'{CONF_UNIT}' only applies to '{CONF_MODE}' counters (a zone counts on its own unit)")
+    return config
+
+
+# One runtime counter: hours in (or entries into) a zone state or a unit mode
+RUNTIME_SENSOR_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Required(CONF_SENSOR): cv.use_id(sensor.Sensor),
+            cv.Optional(CONF_ZONE): cv.int_range(min=1, max=MAX_ZONES),
+            cv.Optional(CONF_STATE): cv.enum(ZONE_STATES, lower=True),
+            cv.Optional(CONF_MODE): cv.enum(UNIT_MODES, lower=True),
+            # Central unit of a mode counter
+            cv.Optional(CONF_UNIT): cv.int_range(min=1, max=MAX_UNITS),
+            cv.Optional(CONF_MEASURE, default="hours"): cv.one_of("hours", "entries", lower=True),
+        }
+    ),
+    _validate_runtime_sensor,
+)
+
+
+# Pins of one zone's thermostat inputs on a thermostat_inputs port
+INPUT_PINS_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_PORT, default=0): cv.int_range(min=0, max=3),
+        cv.Required(CONF_Y1): cv.int_range(min=0, max=15),
+        cv.Required(CONF_Y2): cv.int_range(min=0, max=15),
+        cv.Required(CONF_G): cv.int_range(min=0, max=15),
+        cv.Required(CONF_OB): cv.int_range(min=0, max=15),
+    }
+)
+
 # Per-zone schema: thermostat inputs + damper switches
+# y1/y2/g/ob are required unless thermostat_inputs is set (then: mirrors)
 ZONE_SCHEMA = cv.Schema(
     {
-        cv.Required(CONF_Y1): cv.use_id(binary_sensor.BinarySensor),
-        cv.Required(CONF_Y2): cv.use_id(binary_sensor.BinarySensor),
-        cv.Required(CONF_G): cv.use_id(binary_sensor.BinarySensor),
-        cv.Required(CONF_OB): cv.use_id(binary_sensor.BinarySensor),
+        cv.Optional(CONF_Y1): cv.use_id(binary_sensor.BinarySensor),
+        cv.Optional(CONF_Y2): cv.use_id(binary_sensor.BinarySensor),
+        cv.Optional(CONF_G): cv.use_id(binary_sensor.BinarySensor),
+        cv.Optional(CONF_OB): cv.use_id(binary_sensor.BinarySensor),
+        cv.Optional(CONF_INPUT_PINS): INPUT_PINS_SCHEMA,
         cv.Required(CONF_DAMPER_OPEN): cv.use_id(switch.Switch),
         cv.Required(CONF_DAMPER_CLOSE): cv.use_id(switch.Switch),
         cv.Optional(CONF_STATE_SENSOR): cv.use_id(text_sensor.TextSensor),
+        # Pin numbers on the damper_port expander (required when damper_port is set)
+        cv.Optional(CONF_DAMPER_OPEN_PIN): cv.int_range(min=0, max=15),
+        cv.Optional(CONF_DAMPER_CLOSE_PIN): cv.int_range(min=0, max=15),
+        # Central unit serving the zone (1: the top-level out_* outputs)
+        cv.Optional(CONF_UNIT, default=1): cv.int_range(min=1, max=MAX_UNITS),
     }
 )
 
+# Damper expander owned by the component: all damper coils (and the LEDs that
+# share the chip) are written as one 16-bit OLAT transaction per step.
+DAMPER_PORT_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_ADDRESS): cv.i2c_address,
+        cv.Optional(CONF_INVERTED, default=True): cv.boolean,
+        cv.Optional(CONF_LED_HEAT_PIN): cv.int_range(min=0, max=15),
+        cv.Optional(CONF_LED_COOL_PIN): cv.int_range(min=0, max=15),
+        cv.Optional(CONF_LED_FAN_PIN): cv.int_range(min=0, max=15),
+        cv.Optional(CONF_LED_ERROR_PIN): cv.int_range(min=0, max=15),
+    }
+)
+
+
+# Central unit expander owned by the component: the outputs that change at a
+# mode transition go out as one 16-bit OLAT write.
+OUTPUT_PORT_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_ADDRESS): cv.i2c_address,
+        cv.Optional(CONF_INVERTED, default=True): cv.boolean,
+        **{cv.Optional(key): cv.int_range(min=0, max=15) for key in OUTPUT_PIN_KEYS},
+    }
+)
+
+
+# A central unit beyond the first: its own outputs, its pins on the shared
+# output_port (one OLAT write covers every unit)
+ADDITIONAL_UNIT_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_OUT_Y1): cv.use_id(switch.Switch),
+        cv.Required(CONF_OUT_Y2): cv.use_id(switch.Switch),
+        cv.Required(CONF_OUT_G): cv.use_id(switch.Switch),
+        cv.Required(CONF_OUT_OB): cv.use_id(switch.Switch),
+        cv.Optional(CONF_OUT_W1E): cv.use_id(switch.Switch),
+        cv.Optional(CONF_OUT_W2): cv.use_id(switch.Switch),
+        cv.Optional(CONF_OUT_W3): cv.use_id(switch.Switch),
+        **{cv.Optional(key): cv.int_range(min=0, max=15) for key in OUTPUT_PIN_KEYS},
+    }
+)
+
+
+def _validate_units(config):
+    num_units = 1 + len(config.get(CONF_ADDITIONAL_UNITS, []))
+    served = set()
+    for i, zone_conf in enumerate(config[CONF_ZONES]):
+        if zone_conf[CONF_UNIT] > num_units:
+            raise cv.Invalid(f"Zone {i + 1}: central unit {zone_conf[CONF_UNIT]} is not configured")
+        served.add(zone_conf[CONF_UNIT])
+    for unit in range(2, num_units + 1):
+        if unit not in served:
+            raise cv.Invalid(f"'{CONF_ADDITIONAL_UNITS}': central unit {unit} serves no zone")
+    for conf in config.get(CONF_RUNTIME_SENSORS, []):
+        if conf.get(CONF_UNIT, 1) > num_units:
+            raise cv.Invalid(f"'{CONF_RUNTIME_SENSORS}': central unit {conf[CONF_UNIT]} is not configured")
+    return config
+
+
+def _validate_output_port(config):
+    units = config.get(CONF_ADDITIONAL_UNITS, [])
+    if CONF_OUTPUT_PORT not in config:
+        if any(key in unit for unit in units for key in OUTPUT_PIN_KEYS):
+            raise cv.Invalid(f"'{CONF_ADDITIONAL_UNITS}': output pins require '{CONF_OUTPUT_PORT}'")
+        return config
+    if CONF_I2C_BUS not in config:
+        raise cv.Invalid(f"'{CONF_OUTPUT_PORT}' requires '{CONF_I2C_BUS}'")
+    port = config[CONF_OUTPUT_PORT]
+    used = [conf[key] for conf in [port, *units] for key in OUTPUT_PIN_KEYS if key in conf]
+    if not used:
+        raise cv.Invalid(f"'{CONF_OUTPUT_PORT}': at least one output pin is required")
+    if len(used) != len(set(used)):
+        raise cv.Invalid(f"'{CONF_OUTPUT_PORT}': a pin is assigned more than once")
+    return config
+
+
+# Expanders read by the component: one GPIOA/GPIOB read per port per sample,
+# debounced in software (replaces the delayed_on/delayed_off filters).
+THERMOSTAT_INPUTS_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_PORTS): cv.All(
+            cv.ensure_list(
+                cv.Schema(
+                    {
+                        cv.Required(CONF_ADDRESS): cv.i2c_address,
+                        cv.Optional(CONF_INVERTED, default=True): cv.boolean,
+                    }
+                )
+            ),
+            cv.Length(min=1, max=4),
+        ),
+        cv.Optional(CONF_DEBOUNCE, default="1s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_SAMPLE_INTERVAL, default="50ms"): cv.positive_time_period_milliseconds,
+        # Open a damper on the raw call edge, before the debounce confirms it
+        cv.Optional(CONF_PREPOSITION_DAMPERS, default=False): cv.boolean,
+    }
+)
+
+
+def _zone_input_pins(i, zone_conf):
+    if CONF_INPUT_PINS in zone_conf:
+        return zone_conf[CONF_INPUT_PINS]
+    return PANEL_INPUT_PINS[i] if i < len(PANEL_INPUT_PINS) else None
+
+
+def _validate_thermostat_inputs(config):
+    if CONF_THERMOSTAT_INPUTS not in config:
+        for i, zone_conf in enumerate(config[CONF_ZONES]):
+            for key in (CONF_Y1, CONF_Y2, CONF_G, CONF_OB):
+                if key not in zone_conf:
+                    raise cv.Invalid(
+                        f"Zone {i + 1}: '{key}' is required unless '{CONF_THERMOSTAT_INPUTS}' is set"
+                    )
+            if CONF_INPUT_PINS in zone_conf:
+                raise cv.Invalid(
+                    f"Zone {i + 1}: '{CONF_INPUT_PINS}' requires '{CONF_THERMOSTAT_INPUTS}'"
+                )
+        return config
+    if CONF_I2C_BUS not in config:
+        raise cv.Invalid(f"'{CONF_THERMOSTAT_INPUTS}' requires '{CONF_I2C_BUS}'")
+    num_ports = len(config[CONF_THERMOSTAT_INPUTS][CONF_PORTS])
+    used = set()
+    for i, zone_conf in enumerate(config[CONF_ZONES]):
+        pins = _zone_input_pins(i, zone_conf)
+        if pins is None:
+            raise cv.Invalid(f"Zone {i + 1}: '{CONF_INPUT_PINS}' is required")
+        if pins[CONF_PORT] >= num_ports:
+            raise cv.Invalid(
+                f"Zone {i + 1}: input port {pins[CONF_PORT]} is not declared in '{CONF_PORTS}'"
+            )
+        for key in (CONF_Y1, CONF_Y2, CONF_G, CONF_OB):
+            pin = (pins[CONF_PORT], pins[key])
+            if pin in used:
+                raise cv.Invalid(
+                    f"'{CONF_THERMOSTAT_INPUTS}': pin {pin[1]} of port {pin[0]} is assigned more than once"
+                )
+            used.add(pin)
+    return config
+
+
+# Input expanders: 0x20 (binary_sensors.yml) and the thermostat_inputs ports
+def _i2c_reboot_addresses(config):
+    if CONF_I2C_REBOOT_ADDRESSES in config:
+        return config[CONF_I2C_REBOOT_ADDRESSES]
+    inputs = {0x20}
+    if CONF_THERMOSTAT_INPUTS in config:
+        inputs = {port[CONF_ADDRESS] for port in config[CONF_THERMOSTAT_INPUTS][CONF_PORTS]}
+    return [address for address in config[CONF_I2C_WATCHDOG_ADDRESSES] if address in inputs]
+
+
+def _validate_i2c_watchdog(config):
+    for address in config.get(CONF_I2C_REBOOT_ADDRESSES, []):
+        if address not in config[CONF_I2C_WATCHDOG_ADDRESSES]:
+            raise cv.Invalid(
+                f"'{CONF_I2C_REBOOT_ADDRESSES}': 0x{address:02X} is not in '{CONF_I2C_WATCHDOG_ADDRESSES}'"
+            )
+    return config
+
+
+def _validate_damper_port(config):
+    if CONF_DAMPER_PORT not in config:
+        return config
+    if CONF_I2C_BUS not in config:
+        raise cv.Invalid(f"'{CONF_DAMPER_PORT}' requires '{CONF_I2C_BUS}'")
+    port = config[CONF_DAMPER_PORT]
+    used = [
+        port[key]
+        for key in (CONF_LED_HEAT_PIN, CONF_LED_COOL_PIN, CONF_LED_FAN_PIN, CONF_LED_ERROR_PIN)
+        if key in port
+    ]
+    for i, zone_conf in enumerate(config[CONF_ZONES]):
+        for key in (CONF_DAMPER_OPEN_PIN, CONF_DAMPER_CLOSE_PIN):
+            if key not in zone_conf:
+                raise cv.Invalid(
+                    f"Zone {i + 1}: '{key}' is required when '{CONF_DAMPER_PORT}' is set"
+                )
+            used.append(zone_conf[key])
+    if len(used) != len(set(used)):
+        raise cv.Invalid(f"'{CONF_DAMPER_PORT}': a pin is assigned more than once")
+    return config
+
+
 CONFIG_SCHEMA = cv.Schema(
     {
         cv.GenerateID(): cv.declare_id(OpenZoningController),
         cv.Required(CONF_ZONES): cv.All(
             cv.ensure_list(ZONE_SCHEMA),
-            cv.Length(min=1, max=6),
+            cv.Length(min=1, max=MAX_ZONES),
         ),
         # Timing
         cv.Optional(CONF_MIN_CYCLE_TIME, default="480s"): cv.positive_time_period_milliseconds,
         cv.Optional(CONF_PURGE_DURATION, default="300s"): cv.positive_time_period_milliseconds,
         cv.Optional(CONF_STAGE2_ESCALATION_DELAY, default="3600s"): cv.positive_time_period_milliseconds,
+        # Event-driven evaluation (thermostat edges → coalesced pipeline run)
+        cv.Optional(CONF_EVENT_DRIVEN, default=True): cv.boolean,
+        cv.Optional(CONF_EVENT_LATENCY, default="100ms"): cv.positive_time_period_milliseconds,
+        # false: pass events stay in the RAM ring until dump_event_log()
+        cv.Optional(CONF_LIVE_EVENT_LOG, default=True): cv.boolean,
+        # Per-stage µs timing of update() / loop(); absent: compiled out
+        cv.Optional(CONF_STAGE_TIMING): STAGE_TIMING_SCHEMA,
+        # Heap allocations / minimum free heap of update() / loop(); absent: compiled out
+        cv.Optional(CONF_ALLOC_MONITOR): ALLOC_MONITOR_SCHEMA,
         # Central unit outputs
         cv.Required(CONF_OUT_Y1): cv.use_id(switch.Switch),
         cv.Required(CONF_OUT_Y2): cv.use_id(switch.Switch),
@@ -93,6 +555,10 @@ CONFIG_SCHEMA = cv.Schema(
         cv.Optional(CONF_OUT_W1E): cv.use_id(switch.Switch),
         cv.Optional(CONF_OUT_W2): cv.use_id(switch.Switch),
         cv.Optional(CONF_OUT_W3): cv.use_id(switch.Switch),
+        # Further central units, each serving the zones with its `unit` number
+        cv.Optional(CONF_ADDITIONAL_UNITS): cv.All(
+            cv.ensure_list(ADDITIONAL_UNIT_SCHEMA), cv.Length(min=1, max=MAX_UNITS - 1)
+        ),
         # LED indicators
         cv.Required(CONF_LED_HEAT): cv.use_id(switch.Switch),
         cv.Required(CONF_LED_COOL): cv.use_id(switch.Switch),
@@ -105,39 +571,115 @@ CONFIG_SCHEMA = cv.Schema(
         cv.Optional(CONF_I2C_BUS): cv.use_id(i2c.I2CBus),
         cv.Optional(CONF_I2C_HEALTH_SENSOR): cv.use_id(binary_sensor.BinarySensor),
         cv.Optional(CONF_I2C_ERROR_THRESHOLD, default=3): cv.int_range(min=1, max=10),
+        # MCP23017 checked by the watchdog (4 max); recent traffic replaces the probe
+        cv.Optional(CONF_I2C_WATCHDOG_ADDRESSES, default=[0x20, 0x21, 0x22]): cv.All(
+            cv.ensure_list(cv.i2c_address), cv.Length(min=1, max=4)
+        ),
+        cv.Optional(CONF_I2C_TRAFFIC_WINDOW, default="10s"): cv.positive_time_period_milliseconds,
+        # Watched MCP23017 whose failure alone reboots (default: the input expanders)
+        cv.Optional(CONF_I2C_REBOOT_ADDRESSES): cv.ensure_list(cv.i2c_address),
+        # Damper port — batched OLAT writes for dampers + LEDs
+        cv.Optional(CONF_DAMPER_PORT): DAMPER_PORT_SCHEMA,
+        # Damper motion — motors engaged per inrush window (0: no cap)
+        cv.Optional(CONF_MAX_MOVING_DAMPERS, default=0): cv.int_range(min=0, max=MAX_ZONES),
+        cv.Optional(CONF_DAMPER_INRUSH_WINDOW, default="250ms"): cv.positive_time_period_milliseconds,
+        # Damper policy — only the dampers of OFF zones; all off by default
+        cv.Optional(CONF_DAMPER_MIN_DWELL, default="0s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_DAMPER_IDLE_HOLD, default=False): cv.boolean,
+        cv.Optional(CONF_DAMPER_CLOSE_LOOKAHEAD, default="0s"): cv.positive_time_period_milliseconds,
+        # State journal — changed state written at most once per interval
+        # (and on shutdown), rotating over the slots
+        cv.Optional(CONF_PERSIST_INTERVAL, default="10min"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_PERSIST_SLOTS, default=4): cv.int_range(min=1, max=8),
+        # Output port — batched OLAT writes for the central unit outputs
+        cv.Optional(CONF_OUTPUT_PORT): OUTPUT_PORT_SCHEMA,
+        # Thermostat inputs read by the component (bulk GPIO reads)
+        cv.Optional(CONF_THERMOSTAT_INPUTS): THERMOSTAT_INPUTS_SCHEMA,
         # Minimum zone demand
-        cv.Optional(CONF_MIN_ACTIVE_ZONES, default=1): cv.int_range(min=1, max=6),
+        cv.Optional(CONF_MIN_ACTIVE_ZONES, default=1): cv.int_range(min=1, max=MAX_ZONES),
         cv.Optional(CONF_MIN_DEMAND_OVERRIDE_DELAY, default="1800s"): cv.positive_time_period_milliseconds,
         # Optimization #3 — diagnostic sensors (all optional)
         cv.Optional(CONF_ACTIVE_ZONES_SENSOR):   cv.use_id(sensor.Sensor),
         cv.Optional(CONF_STAGE1_ELAPSED_SENSOR): cv.use_id(sensor.Sensor),
         cv.Optional(CONF_MODE_CHANGES_SENSOR):   cv.use_id(sensor.Sensor),
         cv.Optional(CONF_SHORT_CYCLE_SENSOR):    cv.use_id(binary_sensor.BinarySensor),
+        cv.Optional(CONF_DIAGNOSTIC_PUBLISH, default={}): DIAGNOSTIC_PUBLISH_SCHEMA,
+        # Runtime counters (time / entries per zone state or unit mode)
+        cv.Optional(CONF_RUNTIME_SENSORS): cv.All(cv.ensure_list(RUNTIME_SENSOR_SCHEMA), cv.Length(max=16)),
+        cv.Optional(CONF_RUNTIME_PUBLISH_INTERVAL, default="15min"): cv.positive_time_period_milliseconds,
     }
 ).extend(cv.polling_component_schema("10s"))
 
+CONFIG_SCHEMA = cv.All(
+    CONFIG_SCHEMA,
+    _validate_damper_port,
+    _validate_output_port,
+    _validate_thermostat_inputs,
+    _validate_i2c_watchdog,
+    _validate_diagnostic_publish,
+    _validate_runtime_zones,
+    _validate_units,
+)
+
+
+# With thermostat_inputs the zone binary sensors are mirrors: a gpio sensor
+# there would read the same pins through the mcp23017 hub (binary_sensors.yml
+# → binary_sensors_mirrors.yml).
+def _final_validate_input_mirrors(config):
+    if CONF_THERMOSTAT_INPUTS not in config:
+        return config
+    gpio = {
+        conf[CONF_ID].id
+        for conf in fv.full_config.get().get("binary_sensor", [])
+        if conf.get(CONF_PLATFORM) == "gpio"
+    }
+    for i, zone_conf in enumerate(config[CONF_ZONES]):
+        for key in (CONF_Y1, CONF_Y2, CONF_G, CONF_OB):
+            if key in zone_conf and zone_conf[key].id in gpio:
+                raise cv.Invalid(
+                    f"Zone {i + 1}: '{key}' ({zone_conf[key].id}) is a gpio binary sensor, read twice with "
+                    f"'{CONF_THERMOSTAT_INPUTS}'; use packages/binary_sensors_mirrors.yml (template sensors) "
+                    f"or drop '{key}'"
+                )
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = _final_validate_input_mirrors
+
 
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
 
-    # Set number of zones
+    # Set number of zones (and size the per-zone storage to it)
     zones = config[CONF_ZONES]
+    cg.add_define("OPEN_ZONING_MAX_ZONES", len(zones))
     cg.add(var.set_num_zones(len(zones)))
 
+    # Central units (and the output word sized to them)
+    units = config.get(CONF_ADDITIONAL_UNITS, [])
+    cg.add_define("OPEN_ZONING_MAX_UNITS", 1 + len(units))
+    cg.add(var.set_num_units(1 + len(units)))
+
     # Set timing parameters
     cg.add(var.set_min_cycle_time(config[CONF_MIN_CYCLE_TIME]))
     cg.add(var.set_purge_duration(config[CONF_PURGE_DURATION]))
     cg.add(var.set_stage2_escalation_delay(config[CONF_STAGE2_ESCALATION_DELAY]))
     cg.add(var.set_auto_mode(config[CONF_AUTO_MODE]))
+    cg.add(var.set_event_driven(config[CONF_EVENT_DRIVEN]))
+    cg.add(var.set_event_latency(config[CONF_EVENT_LATENCY]))
+    cg.add(var.set_event_log_live(config[CONF_LIVE_EVENT_LOG]))
 
     # Register binary sensor and switch references for each zone
+    # (with thermostat_inputs, the binary sensors are optional mirrors)
     for i, zone_conf in enumerate(zones):
-        y1 = await cg.get_variable(zone_conf[CONF_Y1])
-        y2 = await cg.get_variable(zone_conf[CONF_Y2])
-        g = await cg.get_variable(zone_conf[CONF_G])
-        ob = await cg.get_variable(zone_conf[CONF_OB])
-        cg.add(var.set_zone_sensors(i, y1, y2, g, ob))
+        inputs = []
+        for key in (CONF_Y1, CONF_Y2, CONF_G, CONF_OB):
+            if key in zone_conf:
+                inputs.append(await cg.get_variable(zone_conf[key]))
+            else:
+                inputs.append(cg.nullptr)
+        cg.add(var.set_zone_sensors(i, *inputs))
 
         damper_open = await cg.get_variable(zone_conf[CONF_DAMPER_OPEN])
         damper_close = await cg.get_variable(zone_conf[CONF_DAMPER_CLOSE])
@@ -147,6 +689,16 @@ async def to_code(config):
             state_sensor = await cg.get_variable(zone_conf[CONF_STATE_SENSOR])
             cg.add(var.set_zone_state_sensor(i, state_sensor))
 
+        if CONF_DAMPER_OPEN_PIN in zone_conf and CONF_DAMPER_CLOSE_PIN in zone_conf:
+            cg.add(
+                var.set_zone_damper_pins(
+                    i, zone_conf[CONF_DAMPER_OPEN_PIN], zone_conf[CONF_DAMPER_CLOSE_PIN]
+                )
+            )
+
+        if zone_conf[CONF_UNIT] > 1:
+            cg.add(var.set_zone_unit(i, zone_conf[CONF_UNIT] - 1))
+
     # Central unit outputs
     out_y1 = await cg.get_variable(config[CONF_OUT_Y1])
     cg.add(var.set_out_y1(out_y1))
@@ -167,6 +719,18 @@ async def to_code(config):
         out_w3 = await cg.get_variable(config[CONF_OUT_W3])
         cg.add(var.set_out_w3(out_w3))
 
+    # Additional central units
+    for u, unit_conf in enumerate(units, start=1):
+        outputs = []
+        for key in (CONF_OUT_Y1, CONF_OUT_Y2, CONF_OUT_G, CONF_OUT_OB, CONF_OUT_W1E, CONF_OUT_W2, CONF_OUT_W3):
+            if key in unit_conf:
+                outputs.append(await cg.get_variable(unit_conf[key]))
+            else:
+                outputs.append(cg.nullptr)
+        cg.add(var.set_unit_outputs(u, *outputs))
+        if any(key in unit_conf for key in OUTPUT_PIN_KEYS):
+            cg.add(var.set_unit_output_pins(u, *(unit_conf.get(key, NO_PIN) for key in OUTPUT_PIN_KEYS)))
+
     # LED indicators
     led_heat = await cg.get_variable(config[CONF_LED_HEAT])
     cg.add(var.set_led_heat(led_heat))
@@ -183,6 +747,10 @@ async def to_code(config):
 
     # I2C watchdog
     cg.add(var.set_i2c_error_threshold(config[CONF_I2C_ERROR_THRESHOLD]))
+    reboot = _i2c_reboot_addresses(config)
+    for address in config[CONF_I2C_WATCHDOG_ADDRESSES]:
+        cg.add(var.add_i2c_watch_address(address, address in reboot))
+    cg.add(var.set_i2c_traffic_window(config[CONF_I2C_TRAFFIC_WINDOW]))
     if CONF_I2C_BUS in config:
         bus = await cg.get_variable(config[CONF_I2C_BUS])
         cg.add(var.set_i2c_bus(bus))
@@ -190,6 +758,52 @@ async def to_code(config):
         health_sensor = await cg.get_variable(config[CONF_I2C_HEALTH_SENSOR])
         cg.add(var.set_i2c_health_sensor(health_sensor))
 
+    # Damper motion
+    cg.add(var.set_max_moving_dampers(config[CONF_MAX_MOVING_DAMPERS]))
+    cg.add(var.set_damper_inrush_window(config[CONF_DAMPER_INRUSH_WINDOW]))
+    cg.add(var.set_damper_min_dwell(config[CONF_DAMPER_MIN_DWELL]))
+    cg.add(var.set_damper_idle_hold(config[CONF_DAMPER_IDLE_HOLD]))
+    cg.add(var.set_damper_close_lookahead(config[CONF_DAMPER_CLOSE_LOOKAHEAD]))
+
+    # State journal
+    cg.add(var.set_persist_interval(config[CONF_PERSIST_INTERVAL]))
+    cg.add(var.set_persist_slots(config[CONF_PERSIST_SLOTS]))
+
+    # Damper port
+    if CONF_DAMPER_PORT in config:
+        port = config[CONF_DAMPER_PORT]
+        cg.add(var.set_damper_port(port[CONF_ADDRESS], port[CONF_INVERTED]))
+        cg.add(
+            var.set_led_pins(
+                port.get(CONF_LED_HEAT_PIN, NO_PIN),
+                port.get(CONF_LED_COOL_PIN, NO_PIN),
+                port.get(CONF_LED_FAN_PIN, NO_PIN),
+                port.get(CONF_LED_ERROR_PIN, NO_PIN),
+            )
+        )
+
+    # Output port
+    if CONF_OUTPUT_PORT in config:
+        port = config[CONF_OUTPUT_PORT]
+        cg.add(var.set_output_port(port[CONF_ADDRESS], port[CONF_INVERTED]))
+        cg.add(var.set_output_pins(*(port.get(key, NO_PIN) for key in OUTPUT_PIN_KEYS)))
+
+    # Thermostat input ports
+    if CONF_THERMOSTAT_INPUTS in config:
+        inputs_conf = config[CONF_THERMOSTAT_INPUTS]
+        for port in inputs_conf[CONF_PORTS]:
+            cg.add(var.add_input_port(port[CONF_ADDRESS], port[CONF_INVERTED]))
+        cg.add(var.set_input_debounce(inputs_conf[CONF_DEBOUNCE]))
+        cg.add(var.set_input_sample_interval(inputs_conf[CONF_SAMPLE_INTERVAL]))
+        cg.add(var.set_preposition_dampers(inputs_conf[CONF_PREPOSITION_DAMPERS]))
+        for i, zone_conf in enumerate(zones):
+            pins = _zone_input_pins(i, zone_conf)
+            cg.add(
+                var.set_zone_input_pins(
+                    i, pins[CONF_PORT], pins[CONF_Y1], pins[CONF_Y2], pins[CONF_G], pins[CONF_OB]
+                )
+            )
+
     # Minimum zone demand
     cg.add(var.set_min_active_zones(config[CONF_MIN_ACTIVE_ZONES]))
     cg.add(var.set_min_demand_override_delay(config[CONF_MIN_DEMAND_OVERRIDE_DELAY]))
@@ -207,3 +821,57 @@ async def to_code(config):
     if CONF_SHORT_CYCLE_SENSOR in config:
         s = await cg.get_variable(config[CONF_SHORT_CYCLE_SENSOR])
         cg.add(var.set_short_cycle_sensor(s))
+
+    # Diagnostic publish policies
+    for i, key in enumerate(DIAGNOSTIC_KEYS):
+        policy = config[CONF_DIAGNOSTIC_PUBLISH][key]
+        cg.add(
+            var.set_diagnostic_policy(
+                i, policy[CONF_MIN_INTERVAL], policy[CONF_MAX_INTERVAL], policy[CONF_DEADBAND]
+            )
+        )
+
+    # Runtime counter sensors
+    cg.add(var.set_runtime_publish_interval(config[CONF_RUNTIME_PUBLISH_INTERVAL]))
+    for conf in config.get(CONF_RUNTIME_SENSORS, []):
+        sens = await cg.get_variable(conf[CONF_SENSOR])
+        if CONF_MODE in conf:
+            zone, index = RUNTIME_UNIT, UNIT_MODES[conf[CONF_MODE]]
+        else:
+            zone, index = conf[CONF_ZONE] - 1, ZONE_STATES[conf[CONF_STATE]]
+        cg.add(
+            var.add_runtime_sensor(
+                sens, zone, index, conf[CONF_MEASURE] == "entries", conf.get(CONF_UNIT, 1) - 1
+            )
+        )
+
+    # Stage timing
+    if CONF_STAGE_TIMING in config:
+        timing = config[CONF_STAGE_TIMING]
+        cg.add_define("OPEN_ZONING_STAGE_TIMING")
+        cg.add(var.set_stage_timing_publish_interval(timing[CONF_PUBLISH_INTERVAL]))
+        for i, stage in enumerate(TIMING_STAGES):
+            if stage not in timing:
+                continue
+            sensors = []
+            for key in (CONF_MAX, CONF_MEAN):
+                if key in timing[stage]:
+                    sensors.append(await cg.get_variable(timing[stage][key]))
+                else:
+                    sensors.append(cg.nullptr)
+            cg.add(var.set_stage_sensors(i, *sensors))
+
+    # Heap allocation monitor: every malloc-family call goes through the
+    # wrappers of alloc_monitor.cpp
+    if CONF_ALLOC_MONITOR in config:
+        monitor = config[CONF_ALLOC_MONITOR]
+        cg.add_define("OPEN_ZONING_ALLOC_MONITOR")
+        if CORE.is_esp8266 or CORE.is_esp32:
+            cg.add_build_flag("-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc")
+        cg.add(var.set_alloc_publish_interval(monitor[CONF_PUBLISH_INTERVAL]))
+        for key, setter in (
+            (CONF_ALLOCATIONS, var.set_allocations_sensor),
+            (CONF_MIN_FREE_HEAP, var.set_min_free_heap_sensor),
+        ):
+            if key in monitor:
+                cg.add(setter(await cg.get_variable(monitor[key])))
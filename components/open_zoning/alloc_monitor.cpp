@@ -0,0 +1,129 @@
+#include "alloc_monitor.h"
+
+#ifdef OPEN_ZONING_ALLOC_MONITOR
+
+#include <cstdlib>
+#include <new>
+
+#if defined(USE_ESP8266)
+#include <Esp.h>
+#elif defined(USE_ESP32)
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+namespace esphome {
+namespace open_zoning {
+
+namespace {
+
+#if defined(USE_ESP8266)
+uint32_t platform_free_heap() { return ESP.getFreeHeap(); }
+#elif defined(USE_ESP32)
+uint32_t platform_free_heap() { return heap_caps_get_free_size(MALLOC_CAP_INTERNAL); }
+#endif
+
+// Identity of the running thread: the WiFi / TCP tasks of the ESP32 allocate
+// concurrently with loop(), only the scope's own task counts
+const void *current_thread() {
+#if defined(USE_ESP32)
+  return xTaskGetCurrentTaskHandle();
+#elif defined(USE_ESP8266)
+  return nullptr;  // one thread
+#else
+  static thread_local char marker;
+  return &marker;
+#endif
+}
+
+}  // namespace
+
+#if defined(USE_ESP8266) || defined(USE_ESP32)
+AllocMonitor::FreeHeapSource AllocMonitor::free_heap_ = &platform_free_heap;
+#else
+AllocMonitor::FreeHeapSource AllocMonitor::free_heap_ = nullptr;
+#endif
+uint32_t AllocMonitor::allocations_ = 0;
+uint32_t AllocMonitor::min_free_heap_ = UINT32_MAX;
+uint8_t AllocMonitor::depth_ = 0;
+const void *AllocMonitor::owner_ = nullptr;
+
+void AllocMonitor::reset() {
+  allocations_ = 0;
+  min_free_heap_ = UINT32_MAX;
+}
+
+void AllocMonitor::enter() {
+  if (depth_++ == 0) owner_ = current_thread();
+}
+
+void AllocMonitor::leave() {
+  if (depth_ == 0) return;
+  if (--depth_ == 0) sample_();
+}
+
+void AllocMonitor::on_allocation() {
+  if (depth_ == 0 || current_thread() != owner_) return;
+  allocations_++;
+  sample_();
+}
+
+void AllocMonitor::sample_() {
+  if (free_heap_ == nullptr) return;
+  const uint32_t bytes = free_heap_();
+  if (bytes < min_free_heap_) min_free_heap_ = bytes;
+}
+
+}  // namespace open_zoning
+}  // namespace esphome
+
+using esphome::open_zoning::AllocMonitor;
+
+#if defined(USE_ESP8266) || defined(USE_ESP32)
+
+// Linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc (codegen):
+// every malloc-family call of the firmware, operator new included, comes
+// through here first
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+  void *p = __real_malloc(size);
+  AllocMonitor::on_allocation();
+  return p;
+}
+void *__wrap_calloc(size_t n, size_t size) {
+  void *p = __real_calloc(n, size);
+  AllocMonitor::on_allocation();
+  return p;
+}
+void *__wrap_realloc(void *ptr, size_t size) {
+  void *p = __real_realloc(ptr, size);
+  AllocMonitor::on_allocation();
+  return p;
+}
+}
+
+#else
+
+// Host: the replaceable global operator new, behind every std::string,
+// std::function and container allocation (the C library's malloc is not
+// wrapped there)
+void *operator new(std::size_t size) {
+  void *p = std::malloc(size != 0 ? size : 1);
+  if (p == nullptr) throw std::bad_alloc();
+  AllocMonitor::on_allocation();
+  return p;
+}
+void *operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+#endif
+
+#endif  // OPEN_ZONING_ALLOC_MONITOR
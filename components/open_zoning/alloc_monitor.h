@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include "esphome/core/defines.h"
+
+// Heap allocations and free heap during update() and loop(). Compiled in
+// only when the YAML has an alloc_monitor: block (codegen defines
+// OPEN_ZONING_ALLOC_MONITOR and wraps the malloc family at link time);
+// otherwise OZ_ALLOC_SCOPE() expands to nothing and no hook exists.
+
+namespace esphome {
+namespace open_zoning {
+
+#ifdef OPEN_ZONING_ALLOC_MONITOR
+
+/// Process-wide counters fed by the allocation hooks of alloc_monitor.cpp
+/// (malloc / calloc / realloc wrappers on the device, operator new on the
+/// host). Only the allocations made inside an AllocScope count, from the
+/// thread that opened it; the free heap is sampled after each of them and
+/// when the outermost scope closes.
+class AllocMonitor {
+ public:
+  using FreeHeapSource = uint32_t (*)();  // free heap in bytes
+
+  /// Platform free heap by default (none on the host: min_free_heap() stays unknown)
+  static void set_free_heap_source(FreeHeapSource src) { free_heap_ = src; }
+
+  /// Allocations inside the scopes since boot
+  static uint32_t allocations() { return allocations_; }
+  /// Lowest free heap sampled, UINT32_MAX before the first sample
+  static uint32_t min_free_heap() { return min_free_heap_; }
+  static void reset();
+
+  static void enter();
+  static void leave();
+  /// From the hooks, after the allocation
+  static void on_allocation();
+
+ protected:
+  static void sample_();
+
+  static FreeHeapSource free_heap_;
+  static uint32_t allocations_;
+  static uint32_t min_free_heap_;
+  static uint8_t depth_;
+  static const void *owner_;  // thread of the open scope
+};
+
+/// Counts the allocations of the enclosing scope (scopes nest).
+class AllocScope {
+ public:
+  AllocScope() { AllocMonitor::enter(); }
+  ~AllocScope() { AllocMonitor::leave(); }
+  AllocScope(const AllocScope &) = delete;
+  AllocScope &operator=(const AllocScope &) = delete;
+};
+
+#define OZ_ALLOC_SCOPE() ::esphome::open_zoning::AllocScope oz_alloc_scope_
+
+#else
+
+#define OZ_ALLOC_SCOPE() \
+  do { \
+  } while (0)
+
+#endif  // OPEN_ZONING_ALLOC_MONITOR
+
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,671 @@
+#include "control_core.h"
+
+namespace esphome {
+namespace open_zoning {
+
+// ============================================================================
+// ControlCore method implementations
+// ============================================================================
+
+static uint16_t bit_of(uint8_t i) { return static_cast<uint16_t>(1u << i); }
+
+static void set_bit(uint16_t &mask, uint16_t bit, bool on) {
+  mask = on ? static_cast<uint16_t>(mask | bit) : static_cast<uint16_t>(mask & ~bit);
+}
+
+void ControlCore::reset(uint8_t num_zones) {
+  num_zones_ = num_zones > MAX_ZONES ? MAX_ZONES : num_zones;
+  for (uint8_t i = 0; i < MAX_ZONES; i++) {
+    state_[i] = state_new_[i] = state_local_[i] = ZoneState::OFF;
+    error_count_[i] = 0;
+    purge_end_ms_[i] = active_start_ms_[i] = 0;
+  }
+  purging_ = cycling_ = 0;
+  short_cycle_ = 0;
+  heating_ = cooling_ = running_ = 0;
+  enabled_ = 0;
+  changed_zones_ = 0;
+  min_demand_wait_start_ms_ = 0;
+  demand_wait_ = false;
+  zone_error_flag_ = false;
+  global_max_priority_ = 0;
+  current_mode_ = 0;
+  stage1_start_ms_ = 0;
+  stage2_escalated_ = false;
+  output_ = CoreOutput{};
+
+  timed_ = 0;
+  timers_.clear_all();
+  error_zones_ = 0;
+  error_pending_ = 0;
+  heating_in_ = cooling_in_ = 0;
+  fan_local_ = cool_local_ = heat_local_ = purge_local_ = 0;
+  heat2_local_ = cool2_local_ = 0;
+  runtime_ = RuntimeStats{};  // restarted at the first evaluation
+  output_.dampers = all_zones_();  // at rest every damper is open
+  dwelling_ = 0;
+  invalidate_();
+}
+
+Zone ControlCore::zone(uint8_t i) const {
+  Zone z;
+  z.index = i;
+  z.state = state_[i];
+  z.error_count = error_count_[i];
+  z.purging = purging_ & bit_of(i);
+  z.in_cycle = cycling_ & bit_of(i);
+  z.purge_end_ms = z.purging ? purge_end_ms_[i] : 0;
+  z.active_start_ms = z.in_cycle ? active_start_ms_[i] : 0;
+  z.short_cycle_protection = short_cycle_ & bit_of(i);
+  return z;
+}
+
+CoreOutput ControlCore::evaluate(const CoreInput &in, uint32_t now_ms, bool count_errors) {
+  now_ms_ = now_ms;
+  if (!runtime_.started()) runtime_.start(now_ms);
+
+  // Settled: same inputs and no deadline reached → same result
+  if (settled_ && in.thermostats == last_in_.thermostats && in.enabled == last_in_.enabled &&
+      in.ob_on_heat == last_in_.ob_on_heat && !timers_.any_reached(now_ms)) {
+    skipped_evaluations_++;
+    return output_;
+  }
+
+  const uint16_t dirty = dirty_zones_(in);
+  const uint8_t mode_before = current_mode_;
+  full_ = false;
+  last_in_ = in;
+  enabled_ = in.enabled;
+
+  pass1_calc_zone_states_(in, count_errors, dirty);
+  pass1_5_short_cycle_protection_(dirty);
+  pass2_purge_management_(dirty);
+  pass2_5_minimum_demand_();
+  pass3_priority_analysis_();
+  pass4_damper_control_();
+  pass5_output_control_();
+  commit_();
+
+  settled_ = incremental_ && changed_zones_ == 0 && error_pending_ == 0 && current_mode_ == mode_before;
+  return output_;
+}
+
+uint16_t ControlCore::preposition_dampers(InputWord raw_thermostats) const {
+  if (hold_) return 0;
+  // Priority each closed OFF zone would get from its raw call; at rest the
+  // highest of them sets the bar PASS 3 will apply
+  uint16_t calling = 0;
+  uint8_t priority[MAX_ZONES]{};
+  uint8_t top = 0;
+  uint8_t calls = 0;  // raw calls of the enabled zones, for PASS 2.5 at rest
+  const uint16_t candidates = enabled_ & ~output_.dampers & ~running_ & ~error_zones_;
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    const uint16_t bit = bit_of(i);
+    if (!(enabled_ & bit) || (error_zones_ & bit)) continue;
+    const uint8_t decoded = DECODE_TABLE.entry[decode_index(raw_thermostats, last_in_.ob_on_heat, i)];
+    if (decoded & DECODE_NO_FAN) continue;
+    const uint8_t p = static_cast<uint8_t>(state_to_priority(static_cast<ZoneState>(decoded & DECODE_STATE_MASK)));
+    if (p == 0) continue;
+    calls++;
+    if (!(candidates & bit) || state_[i] != ZoneState::OFF) continue;
+    calling |= bit;
+    priority[i] = p;
+    if (p > top) top = p;
+  }
+  if (calling == 0) return 0;
+
+  uint8_t bar = global_max_priority_;
+  if (bar == 0) {
+    // From rest: PASS 2.5 would hold the calls until enough zones demand
+    if (min_active_zones_ > 1 && calls < min_active_zones_) return 0;
+    bar = top;
+  }
+  uint16_t early = 0;
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    if ((calling & bit_of(i)) && priority[i] >= bar) early |= bit_of(i);
+  }
+  return early;
+}
+
+uint16_t ControlCore::dirty_zones_(const CoreInput &in) const {
+  if (full_ || !incremental_) return all_zones_();
+
+  uint16_t dirty = changed_zones_ | error_pending_ | ((in.enabled ^ last_in_.enabled) & all_zones_()) |
+                   ((in.ob_on_heat ^ last_in_.ob_on_heat) & all_zones_());
+  const InputWord diff = in.thermostats ^ last_in_.thermostats;
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    const uint16_t bit = static_cast<uint16_t>(1u << i);
+    if ((diff >> (4 * i)) & 0x0F) dirty |= bit;
+    if ((timed_ & bit) && time_reached(now_ms_, zone_wake_ms_(i))) dirty |= bit;
+  }
+  return dirty;
+}
+
+// ============================================================================
+// Per-zone steps (PASS 1 / PASS 1.5)
+// ============================================================================
+
+bool ControlCore::calc_zone_state_(uint8_t i, uint8_t table_index, bool count_errors) {
+  // One table lookup replaces the decision chain (see DECODE_TABLE)
+  const uint8_t decoded = DECODE_TABLE.entry[table_index & 0x1F];
+  state_new_[i] = static_cast<ZoneState>(decoded & DECODE_STATE_MASK);
+
+  // Error detection: Y1 or Y2 active without G (fan)
+  uint8_t &error_count = error_count_[i];
+  if (decoded & DECODE_NO_FAN) {
+    const bool y1 = table_index & IN_Y1;
+    const bool y2 = table_index & IN_Y2;
+    if (count_errors) {
+      error_count++;
+      if (error_count == 1) events_.push(now_ms_, Event::ZONE_ERROR_DETECTED, i, y1, y2);
+    }
+    if (error_count >= 2) {
+      events_.push(now_ms_, Event::ZONE_ERROR_CONFIRMED, i, y1, y2);
+      state_new_[i] = ZoneState::ERROR;
+      return true;
+    }
+  } else if (error_count > 0) {
+    events_.push(now_ms_, Event::ZONE_ERROR_CLEARED, i, error_count);
+    error_count = 0;
+  }
+
+  return false;
+}
+
+void ControlCore::apply_short_cycle_protection_(uint8_t i) {
+  const uint16_t bit = bit_of(i);
+  const uint32_t current_time = now_ms_;
+  const ZoneState state = state_[i];
+  ZoneState &state_new = state_new_[i];
+  uint32_t &active_start_ms = active_start_ms_[i];
+  const bool is_active = is_heating_state(state_new) || is_cooling_state(state_new);
+
+  // Track when a zone first becomes active (heating/cooling)
+  if (state == ZoneState::OFF && is_active) {
+    active_start_ms = current_time;
+    cycling_ |= bit;
+    events_.push(current_time, Event::ZONE_CYCLE_STARTED, i, static_cast<int32_t>(active_start_ms));
+  }
+
+  // Error clears protection immediately
+  if (state_new == ZoneState::ERROR) {
+    cycling_ &= static_cast<uint16_t>(~bit);
+    set_bit(short_cycle_, bit, false);
+    return;
+  }
+
+  if ((heating_ | cooling_) & bit && state_new == ZoneState::OFF) {
+    // Zone transitioning from active to OFF — check minimum cycle time
+    uint32_t elapsed = current_time - active_start_ms;
+    if (in_min_cycle_(i)) {
+      // Hold in previous state
+      state_new = state;
+      if (!(short_cycle_ & bit)) {
+        short_cycle_ |= bit;
+        events_.push(current_time, Event::ZONE_SHORT_CYCLE, i, static_cast<int32_t>(elapsed),
+                     static_cast<int32_t>(min_cycle_time_ms_));
+      }
+    } else {
+      set_bit(short_cycle_, bit, false);
+      cycling_ &= static_cast<uint16_t>(~bit);
+    }
+  } else if (state_new != ZoneState::OFF) {
+    // Zone still active — update protection flag based on elapsed time
+    if (cycling_ & bit) set_bit(short_cycle_, bit, in_min_cycle_(i));
+  } else {
+    // Zone is OFF and was OFF (or non-active) — clear protection
+    set_bit(short_cycle_, bit, false);
+  }
+}
+
+// ============================================================================
+// PASS 1: Zone State Calculation
+// ============================================================================
+void ControlCore::pass1_calc_zone_states_(const CoreInput &in, bool count_errors, uint16_t dirty) {
+  OZ_TIME_STAGE(timings_, Stage::PASS1);
+
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    const uint16_t bit = bit_of(i);
+    if (!(dirty & bit))
+      continue;
+
+    // Take the zone out of the aggregate masks until it is recomputed
+    const uint16_t keep = static_cast<uint16_t>(~bit);
+    heating_in_ &= keep;
+    cooling_in_ &= keep;
+    fan_local_ &= keep;
+    cool_local_ &= keep;
+    heat_local_ &= keep;
+    purge_local_ &= keep;
+    heat2_local_ &= keep;
+    cool2_local_ &= keep;
+    error_zones_ &= keep;
+    error_pending_ &= keep;
+    timed_ &= keep;
+    if (!is_enabled_(i))
+      continue;
+
+    const uint8_t index = decode_index(in.thermostats, in.ob_on_heat, i);
+    bool error = calc_zone_state_(i, index, count_errors);
+    if (error) {
+      error_zones_ |= bit;
+    }
+    if (error_count_[i] > 0 || (DECODE_TABLE.entry[index] & DECODE_NO_FAN)) error_pending_ |= bit;
+  }
+  zone_error_flag_ = error_zones_ != 0;
+}
+
+// ============================================================================
+// PASS 1.5: Short Cycle Protection
+// ============================================================================
+void ControlCore::pass1_5_short_cycle_protection_(uint16_t dirty) {
+  OZ_TIME_STAGE(timings_, Stage::PASS1_5);
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    const uint16_t bit = bit_of(i);
+    if (!(dirty & bit) || !is_enabled_(i))
+      continue;
+
+    apply_short_cycle_protection_(i);
+    if (is_heating_state(state_new_[i])) heating_in_ |= bit;
+    if (is_cooling_state(state_new_[i])) cooling_in_ |= bit;
+  }
+}
+
+// ============================================================================
+// PASS 2: Intelligent Multi-Zone Purge Management
+// ============================================================================
+void ControlCore::pass2_purge_management_(uint16_t dirty) {
+  OZ_TIME_STAGE(timings_, Stage::PASS2);
+  const uint32_t now_ms = now_ms_;
+
+  // Apply purge logic to each recomputed zone
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    const uint16_t bit = bit_of(i);
+    if (!(dirty & bit) || !is_enabled_(i))
+      continue;
+
+    ZoneState &state_new = state_new_[i];
+    uint32_t &purge_end_ms = purge_end_ms_[i];
+
+    // Check transition: was active, now wants to stop
+    if ((heating_ | cooling_) & bit && !is_heating_state(state_new) && !is_cooling_state(state_new)
+        && state_new != ZoneState::ERROR) {
+
+      // Check minimum cycle time before allowing purge
+      if (in_min_cycle_(i)) {
+        state_new = state_[i];  // Hold in previous state
+        short_cycle_ |= bit;
+        events_.push(now_ms, Event::ZONE_PURGE_BLOCKED, i);
+      } else {
+        // Other zones of the same type still active (new state, after PASS 1.5)?
+        // One mask test each: heating_in_ / cooling_in_ never hold this zone,
+        // it has just turned off.
+        const bool other_zones_active = ((heating_ & bit) && heating_in_ != 0) ||
+                                        ((cooling_ & bit) && cooling_in_ != 0);
+
+        if (other_zones_active) {
+          // Other zones still running — skip purge, go OFF
+          purging_ &= static_cast<uint16_t>(~bit);
+          state_new = ZoneState::OFF;
+        } else {
+          // Last zone to stop — start purge timer
+          purge_end_ms = now_ms + purge_duration_ms_;
+          purging_ |= bit;
+          events_.push(now_ms, Event::ZONE_PURGE_STARTED, i, static_cast<int32_t>(purge_duration_ms_));
+        }
+      }
+    }
+
+    // Manage active purge timer (wrap-safe: the end may lie past a millis() wrap)
+    if (purging_ & bit) {
+      if (time_reached(now_ms, purge_end_ms)) {
+        purging_ &= static_cast<uint16_t>(~bit);
+        events_.push(now_ms, Event::ZONE_PURGE_DONE, i);
+      } else if (state_new != ZoneState::ERROR) {
+        state_new = ZoneState::PURGE;
+      }
+    }
+
+    // Zone-local result, reused until this zone is dirty again. Its next
+    // deadline: purge end, or the end of its minimum cycle time.
+    state_local_[i] = state_new;
+    switch (state_to_priority(state_new)) {
+      case 1: fan_local_ |= bit; break;
+      case 2: cool_local_ |= bit; break;
+      case 4: heat_local_ |= bit; break;
+      case 6: purge_local_ |= bit; break;
+      default: break;
+    }
+    if (state_new == ZoneState::HEATING_STAGE2) heat2_local_ |= bit;
+    if (state_new == ZoneState::COOLING_STAGE2) cool2_local_ |= bit;
+    if ((purging_ & bit) || in_min_cycle_(i))
+      timed_ |= bit;
+  }
+}
+
+// ============================================================================
+// PASS 2.5: Minimum Zone Demand Threshold
+// Decides the hold; pass4_damper_control_() moves the held zones to WAIT.
+// ============================================================================
+void ControlCore::pass2_5_minimum_demand_() {
+  OZ_TIME_STAGE(timings_, Stage::PASS2_5);
+  hold_ = false;
+  if (min_active_zones_ <= 1) return;  // Feature disabled
+
+  // Zones currently demanding (active states, not Purge/Error/Wait/Off)
+  const uint8_t demanding = demanding_count_();
+
+  // Threshold met — reset override timer, let all zones through
+  if (demanding >= min_active_zones_) {
+    demand_wait_ = false;
+    return;
+  }
+
+  // System currently running — do not interrupt an active cycle
+  if (current_mode_ != 0) return;
+
+  // No zones demanding at all — nothing to hold
+  if (demanding == 0) {
+    demand_wait_ = false;
+    return;
+  }
+
+  // Below threshold and system is off — apply hold
+  unsigned long now_ms = now_ms_;
+
+  // Start override timer on first hold cycle
+  if (!demand_wait_) {
+    demand_wait_ = true;
+    min_demand_wait_start_ms_ = now_ms;
+    events_.push(now_ms, Event::DEMAND_HOLD, EventLog::NO_ZONE, demanding << 8 | min_active_zones_,
+                 static_cast<int32_t>(min_demand_override_ms_));
+  }
+
+  // Override: zone(s) have been waiting too long — force start
+  if (min_demand_override_ms_ > 0 &&
+      (now_ms - min_demand_wait_start_ms_) >= min_demand_override_ms_) {
+    events_.push(now_ms, Event::DEMAND_OVERRIDE, EventLog::NO_ZONE, static_cast<int32_t>(min_demand_override_ms_));
+    demand_wait_ = false;
+    return;
+  }
+
+  // Hold active-state zones to WAIT
+  hold_ = true;
+}
+
+// ============================================================================
+// PASS 3: Priority Analysis
+// Global maximum priority from the per-priority zone masks; the WAIT states
+// are applied by pass4_damper_control_().
+// ============================================================================
+void ControlCore::pass3_priority_analysis_() {
+  OZ_TIME_STAGE(timings_, Stage::PASS3);
+  global_max_priority_ = 0;
+  if (purge_local_) {
+    global_max_priority_ = 6;
+  } else if (hold_) {
+    // held zones are in WAIT (priority 0)
+  } else if (heat_local_) {
+    global_max_priority_ = 4;
+  } else if (cool_local_) {
+    global_max_priority_ = 2;
+  } else if (fan_local_) {
+    global_max_priority_ = 1;
+  }
+}
+
+// ============================================================================
+// PASS 4: Final zone states and damper targets
+// One pass over the zones: zone-local state, PASS 2.5 hold, PASS 3 WAIT,
+// then the target damper position. Only decides the targets; the adapter
+// turns changes into motor sequences. The damper policy (all off by
+// default) may leave a free damper — an OFF zone's — where it is.
+// ============================================================================
+void ControlCore::pass4_damper_control_() {
+  OZ_TIME_STAGE(timings_, Stage::PASS4);
+  bool all_zones_off = (global_max_priority_ == 0);
+  uint16_t dampers = 0;
+  const uint16_t demanding = fan_local_ | cool_local_ | heat_local_;
+
+  // Damper policy: an idle unit leaves the free dampers as they are; and
+  // when only purges end within the lookahead the unit is about to go idle,
+  // which would reopen a free damper closed now
+  const bool idle_hold = damper_idle_hold_ && auto_mode_ && all_zones_off;
+  bool idle_soon = false;
+  if (damper_close_lookahead_ms_ > 0 && !all_zones_off && demanding == 0 && purge_local_ != 0) {
+    idle_soon = true;
+    for (uint8_t i = 0; i < num_zones_ && idle_soon; i++) {
+      const uint16_t bit = bit_of(i);
+      if (!(purge_local_ & bit)) continue;
+      idle_soon = (purging_ & bit) && time_until(now_ms_, purge_end_ms_[i]) <= damper_close_lookahead_ms_;
+    }
+  }
+
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    ZoneState &state_new = state_new_[i];
+
+    // Disabled zones: force OFF, close damper
+    if (!is_enabled_(i)) {
+      state_new = ZoneState::OFF;
+      continue;
+    }
+
+    const uint16_t bit = bit_of(i);
+    state_new = state_local_[i];
+    if (hold_ && (demanding & bit)) {
+      state_new = ZoneState::WAIT;
+      events_.push(now_ms_, Event::ZONE_HELD, i, __builtin_popcount(demanding) << 8 | min_active_zones_);
+    }
+
+    // Apply WAIT state to zones with lower priority (but not OFF or ERROR)
+    int p = state_to_priority(state_new);
+    if (p > 0 && p < global_max_priority_ && state_new != ZoneState::ERROR) {
+      state_new = ZoneState::WAIT;
+    }
+
+    // Determine target damper position
+    bool open = true;  // Default: open
+    if (state_new == ZoneState::WAIT || state_new == ZoneState::ERROR) {
+      open = false;  // Close for WAIT and ERROR
+    } else if (state_new != ZoneState::OFF) {
+      open = true;  // Active zone: open
+    } else {
+      // Free damper: open while all zones are off, closed while others are
+      // active — unless the policy keeps it where it is
+      open = all_zones_off;
+      const bool was_open = output_.dampers & bit;
+      const bool dwelling = (dwelling_ & bit) && !time_reached(now_ms_, damper_moved_ms_[i] + damper_min_dwell_ms_);
+      if (open != was_open && (dwelling || (open ? idle_hold : idle_soon))) open = was_open;
+    }
+
+    if (open) dampers |= bit;
+  }
+
+  // Moves start the dwell (required moves too: a damper just closed for a
+  // WAIT stays closed for its dwell once the zone is free again)
+  const uint16_t moved = dampers ^ output_.dampers;
+  if (damper_min_dwell_ms_ > 0 && moved) {
+    for (uint8_t i = 0; i < num_zones_; i++) {
+      if (moved & bit_of(i)) damper_moved_ms_[i] = now_ms_;
+    }
+    dwelling_ |= moved;
+  }
+  output_.dampers = dampers;
+}
+
+// ============================================================================
+// PASS 5: Central Unit Output Control
+// ============================================================================
+void ControlCore::pass5_output_control_() {
+  OZ_TIME_STAGE(timings_, Stage::PASS5);
+  if (!auto_mode_) {
+    return;  // Manual mode — don't touch outputs
+  }
+
+  int new_mode = 0;  // Default: Arrêt (index 0)
+
+  // --- Error handling: force shutdown on zone error ---
+  if (zone_error_flag_) {
+    new_mode = 0;  // Arrêt
+    events_.push(now_ms_, Event::ERROR_SHUTDOWN);
+  } else {
+    // --- Determine base mode from global_max_priority ---
+    // At priority 2 / 4 no zone is held, so the stage 2 zones are the
+    // zone-local ones
+    if (global_max_priority_ == 0) {
+      new_mode = 0;  // Arrêt
+
+    } else if (global_max_priority_ == 1) {
+      new_mode = 1;  // Fan1
+
+    } else if (global_max_priority_ == 2) {
+      // Cooling demand — check if any zone needs stage 2
+      new_mode = cool2_local_ > 0 ? 3 : 2;  // Clim Stage 2 or 1
+      last_active_mode_ = 2;  // cooling (persisted by the adapter's state journal)
+
+    } else if (global_max_priority_ == 4) {
+      // Heating demand — check if any zone needs stage 2
+      new_mode = heat2_local_ > 0 ? 5 : 4;  // Chauffage Stage 2 or 1
+      last_active_mode_ = 1;  // heating (persisted by the adapter's state journal)
+
+    } else if (global_max_priority_ == 6) {
+      // Purge demand — fan only, preserve OB position from last active mode
+      new_mode = (last_active_mode_ == 2) ? 7 : 6;
+      // 7 = Purge Clim (G ON, OB ON), 6 = Purge Chauffage (G ON, OB OFF)
+    }
+
+    // --- Stage 2 escalation timer ---
+    if (new_mode == 2 || new_mode == 4) {
+      // Currently in Stage 1 — check escalation timer
+      if (stage2_escalated_ && current_mode_ == new_mode + 1) {
+        // Escalated — hold Stage 2 while the Stage 1 demand lasts
+        new_mode = current_mode_;
+      } else if (current_mode_ != new_mode) {
+        // Just entered Stage 1 — start timer
+        stage1_start_ms_ = now_ms_;
+        events_.push(now_ms_, Event::STAGE1_STARTED, EventLog::NO_ZONE, static_cast<int32_t>(stage2_escalation_ms_));
+      } else if (stage2_escalation_ms_ > 0) {
+        // Already in Stage 1 — check if escalation delay exceeded
+        unsigned long stage1_elapsed = now_ms_ - stage1_start_ms_;
+        if (stage1_elapsed >= stage2_escalation_ms_) {
+          new_mode = new_mode + 1;  // 2→3 (Clim S2) or 4→5 (Chauffage S2)
+          stage2_escalated_ = true;
+          events_.push(now_ms_, Event::STAGE2_ESCALATION, EventLog::NO_ZONE, static_cast<int32_t>(stage1_elapsed),
+                       static_cast<int32_t>(stage2_escalation_ms_));
+        }
+      }
+    } else {
+      // Not in Stage 1 — reset escalation timer
+      stage1_start_ms_ = 0;
+      stage2_escalated_ = false;
+    }
+  }
+
+  // --- Record mode change ---
+  if (new_mode != current_mode_) {
+    mode_change_count_++;  // Optimization #3: count real transitions
+    runtime_.mode_changed(new_mode, now_ms_);
+    events_.push(now_ms_, Event::MODE_CHANGE, EventLog::NO_ZONE, current_mode_ << 8 | new_mode, global_max_priority_);
+    current_mode_ = new_mode;
+  }
+
+  output_.mode = current_mode_;
+  output_.unit = mode_unit_bits(current_mode_);
+  output_.leds = mode_led_bits(current_mode_) | (zone_error_flag_ ? LED_ERROR : 0);
+}
+
+// ============================================================================
+// Commit new states and log changes
+// ============================================================================
+void ControlCore::commit_() {
+  OZ_TIME_STAGE(timings_, Stage::COMMIT);
+  changed_zones_ = 0;
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    const ZoneState s = state_new_[i];
+    if (state_[i] == s) continue;
+    const uint16_t bit = bit_of(i);
+    events_.push(now_ms_, Event::ZONE_STATE, i, static_cast<int32_t>(state_[i]), static_cast<int32_t>(s));
+    changed_zones_ |= bit;
+    runtime_.zone_changed(i, s, now_ms_);
+    state_[i] = s;
+    set_bit(heating_, bit, is_heating_state(s));
+    set_bit(cooling_, bit, is_cooling_state(s));
+    set_bit(running_, bit, s != ZoneState::OFF && s != ZoneState::WAIT && s != ZoneState::ERROR);
+  }
+
+  // Register the timer deadlines: they end the settled fast path, and the
+  // adapter schedules its next evaluation at the earliest one. A timer only
+  // counts while it can fire (stage 2 and the demand override are evaluated
+  // by PASS 5 / PASS 2.5 in automatic mode, with the unit in Stage 1 / off).
+  bool zone_timer = false;
+  uint32_t zone_left = 0;
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    if (!(timed_ & bit_of(i))) continue;
+    const uint32_t left = time_until(now_ms_, zone_wake_ms_(i));
+    if (!zone_timer || left < zone_left) zone_left = left;
+    zone_timer = true;
+  }
+  if (zone_timer) {
+    timers_.set(TIMER_ZONES, now_ms_ + zone_left);
+  } else {
+    timers_.clear(TIMER_ZONES);
+  }
+  if (auto_mode_ && (current_mode_ == 2 || current_mode_ == 4) && stage2_escalation_ms_ > 0) {
+    timers_.set(TIMER_STAGE2, stage1_start_ms_ + stage2_escalation_ms_);
+  } else {
+    timers_.clear(TIMER_STAGE2);
+  }
+  if (auto_mode_ && demand_wait_ && current_mode_ == 0 && min_demand_override_ms_ > 0 && min_active_zones_ > 1) {
+    timers_.set(TIMER_DEMAND_OVERRIDE, min_demand_wait_start_ms_ + min_demand_override_ms_);
+  } else {
+    timers_.clear(TIMER_DEMAND_OVERRIDE);
+  }
+  // Damper dwell: a dwelling damper is free to move again at its end
+  bool dwell_timer = false;
+  uint32_t dwell_left = 0;
+  for (uint8_t i = 0; i < num_zones_ && dwelling_; i++) {
+    const uint16_t bit = bit_of(i);
+    if (!(dwelling_ & bit)) continue;
+    const uint32_t left = time_until(now_ms_, damper_moved_ms_[i] + damper_min_dwell_ms_);
+    if (left == 0) {
+      dwelling_ &= ~bit;
+      continue;
+    }
+    if (!dwell_timer || left < dwell_left) dwell_left = left;
+    dwell_timer = true;
+  }
+  if (dwell_timer) {
+    timers_.set(TIMER_DAMPERS, now_ms_ + dwell_left);
+  } else {
+    timers_.clear(TIMER_DAMPERS);
+  }
+}
+
+// ============================================================================
+// Mode names (select option order)
+// ============================================================================
+const char *ControlCore::mode_to_string(uint8_t mode) {
+  switch (mode) {
+    case 0:
+      return "Arrêt";
+    case 1:
+      return "Fan";
+    case 2:
+      return "Clim Stage 1";
+    case 3:
+      return "Clim Stage 2";
+    case 4:
+      return "Chauffage Stage 1";
+    case 5:
+      return "Chauffage Stage 2";
+    case 6:
+      return "Purge Chauffage";
+    case 7:
+      return "Purge Clim";
+    default:
+      return "Unknown";
+  }
+}
+
+}  // namespace open_zoning
+}  // namespace esphome
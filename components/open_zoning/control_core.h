@@ -0,0 +1,383 @@
+#pragma once
+
+#include <cstdint>
+#include "zone.h"
+#include "deadline.h"
+#include "runtime_stats.h"
+#include "stage_timing.h"
+
+namespace esphome {
+namespace open_zoning {
+
+/// Packed inputs for one evaluation of the pass pipeline.
+struct CoreInput {
+  InputWord thermostats{0};  // 4 bits per zone, zone i at bits 4i..4i+3 (ControlCore::IN_*)
+  uint16_t enabled{0};      // bit per zone: 1 = zone enabled
+  uint16_t ob_on_heat{0};   // bit per zone: 1 = O/B active → heating
+};
+
+/// Packed result of one evaluation.
+struct CoreOutput {
+  uint16_t dampers{0};  // bit per zone: 1 = open, 0 = closed
+  uint8_t unit{0};      // central unit outputs (ControlCore::UNIT_*)
+  uint8_t leds{0};      // indicator LEDs (ControlCore::LED_*)
+  uint8_t mode{0};      // mode index 0–7 (select option order)
+};
+
+/// Entity-free decision logic: PASS 1–5 over packed inputs and a timestamp.
+/// No ESPHome entity, no I2C and no clock access — the adapter
+/// (OpenZoningController) reads the inputs and applies the outputs.
+///
+/// Evaluation is incremental: PASS 1–2 only recompute the zones whose
+/// input nibble, enabled / O/B bit, timer or committed state changed (or
+/// with an error pending); the other zones keep their last zone-local
+/// result. The global passes read per-zone aggregates (heating / cooling
+/// counts, zones per priority, stage 2 zones) updated as zones change, so
+/// no pass scans every zone to count. Once an evaluation changes nothing,
+/// the next ones return the last output after one comparison until an
+/// input differs or the earliest timer deadline is reached.
+///
+/// Timers (purge end, minimum cycle, stage 2 escalation, minimum demand
+/// override, damper dwell) are absolute deadlines compared wrap-safely, each registered in
+/// one slot of a DeadlineSet; next_deadline() tells the adapter when the
+/// next timer-driven transition is due.
+class ControlCore {
+ public:
+  // --- Thermostat input bits (one nibble per zone) ---
+  static constexpr uint8_t IN_Y1 = 1 << 0;
+  static constexpr uint8_t IN_Y2 = 1 << 1;
+  static constexpr uint8_t IN_G = 1 << 2;
+  static constexpr uint8_t IN_OB = 1 << 3;
+
+  // --- Central unit output bits ---
+  static constexpr uint8_t UNIT_Y1 = 1 << 0;
+  static constexpr uint8_t UNIT_Y2 = 1 << 1;
+  static constexpr uint8_t UNIT_G = 1 << 2;
+  static constexpr uint8_t UNIT_OB = 1 << 3;
+  static constexpr uint8_t UNIT_W1E = 1 << 4;
+  static constexpr uint8_t UNIT_W2 = 1 << 5;
+  static constexpr uint8_t UNIT_W3 = 1 << 6;
+
+  // --- LED bits ---
+  static constexpr uint8_t LED_HEAT = 1 << 0;
+  static constexpr uint8_t LED_COOL = 1 << 1;
+  static constexpr uint8_t LED_FAN = 1 << 2;
+  static constexpr uint8_t LED_ERROR = 1 << 3;
+
+  static constexpr uint8_t NUM_MODES = 8;
+
+  // --- Timer slots (next_deadline()) ---
+  enum Timer : uint8_t {
+    TIMER_ZONES,            // earliest purge end / minimum cycle end
+    TIMER_STAGE2,           // stage 2 escalation
+    TIMER_DEMAND_OVERRIDE,  // minimum demand override
+    TIMER_DAMPERS,          // end of the earliest damper dwell (damper policy)
+    NUM_TIMERS
+  };
+
+  /// Reset all zones and runtime state (called from setup()).
+  void reset(uint8_t num_zones);
+
+  /// Run PASS 1–5 and commit the new zone states.
+  /// count_errors=false for event-driven runs (see calc_zone_state_()).
+  CoreOutput evaluate(const CoreInput &in, uint32_t now_ms, bool count_errors = true);
+
+  /// Earliest timer deadline still ahead of now_ms (the next evaluation that
+  /// can change anything without an input change); false when none is armed.
+  bool next_deadline(uint32_t now_ms, uint32_t *at) const { return timers_.next(now_ms, at); }
+  const DeadlineSet<NUM_TIMERS> &get_timers() const { return timers_; }
+
+  /// false: recompute every zone at every evaluation (reference behaviour
+  /// the incremental path is checked against)
+  void set_incremental(bool v) {
+    incremental_ = v;
+    invalidate_();
+  }
+  /// Evaluations answered by the settled fast path
+  uint32_t get_skipped_evaluations() const { return skipped_evaluations_; }
+
+  /// Central unit / LED bits of each mode index (LED_ERROR excluded) —
+  /// replaces the on_value lambda in select.yml. Index = select option order.
+  struct ModeOutputs {
+    uint8_t unit;
+    uint8_t leds;
+  };
+  static constexpr ModeOutputs MODE_TABLE[NUM_MODES] = {
+      {0, 0},                                              // 0 Arrêt
+      {UNIT_G, LED_FAN},                                   // 1 Fan1
+      {UNIT_Y1 | UNIT_G | UNIT_OB, LED_FAN | LED_COOL},    // 2 Clim Stage 1
+      {UNIT_Y1 | UNIT_Y2 | UNIT_G | UNIT_OB, LED_FAN | LED_COOL},  // 3 Clim Stage 2
+      {UNIT_Y1 | UNIT_G, LED_FAN | LED_HEAT},              // 4 Chauffage Stage 1
+      {UNIT_Y1 | UNIT_Y2 | UNIT_G, LED_FAN | LED_HEAT},    // 5 Chauffage Stage 2
+      {UNIT_G, LED_FAN},                                   // 6 Purge Chauffage (fan only, OB OFF)
+      {UNIT_G | UNIT_OB, LED_FAN},                         // 7 Purge Clim (fan only, OB ON)
+  };
+  /// Unknown indices map to all-off.
+  static constexpr uint8_t mode_unit_bits(uint8_t mode) { return mode < NUM_MODES ? MODE_TABLE[mode].unit : 0; }
+  static constexpr uint8_t mode_led_bits(uint8_t mode) { return mode < NUM_MODES ? MODE_TABLE[mode].leds : 0; }
+  static const char *mode_to_string(uint8_t mode);
+
+  // --- Configuration ---
+  // (each one moves the timer deadlines: the next evaluation recomputes every zone)
+  void set_min_cycle_time(uint32_t ms) {
+    min_cycle_time_ms_ = ms;
+    invalidate_();
+  }
+  void set_purge_duration(uint32_t ms) {
+    purge_duration_ms_ = ms;
+    invalidate_();
+  }
+  void set_stage2_escalation_delay(uint32_t ms) {
+    stage2_escalation_ms_ = ms;
+    invalidate_();
+  }
+  void set_auto_mode(bool v) {
+    auto_mode_ = v;
+    invalidate_();
+  }
+  void set_min_active_zones(uint8_t n) {
+    min_active_zones_ = n;
+    invalidate_();
+  }
+  void set_min_demand_override_delay(uint32_t ms) {
+    min_demand_override_ms_ = ms;
+    invalidate_();
+  }
+  void set_last_active_mode(uint8_t m) {
+    last_active_mode_ = m;
+    invalidate_();
+  }
+  // Damper policy (PASS 4). It only moves the free dampers: those of OFF
+  // zones, opened while every zone is off and closed while others run.
+  // Active zones always open, WAIT / ERROR / disabled zones always close.
+  /// A free damper stays where it is until it has held its position this long
+  void set_damper_min_dwell(uint32_t ms) {
+    damper_min_dwell_ms_ = ms;
+    invalidate_();
+  }
+  /// Idle unit (automatic mode): free dampers keep their position instead of opening
+  void set_damper_idle_hold(bool v) {
+    damper_idle_hold_ = v;
+    invalidate_();
+  }
+  /// A free damper stays open when every running zone is purging and done
+  /// within this delay: the unit goes idle and would reopen it then
+  void set_damper_close_lookahead(uint32_t ms) {
+    damper_close_lookahead_ms_ = ms;
+    invalidate_();
+  }
+
+  uint32_t get_min_cycle_time_ms() const { return min_cycle_time_ms_; }
+  uint32_t get_purge_duration_ms() const { return purge_duration_ms_; }
+  uint32_t get_stage2_escalation_ms() const { return stage2_escalation_ms_; }
+  bool get_auto_mode() const { return auto_mode_; }
+  uint8_t get_min_active_zones() const { return min_active_zones_; }
+  uint32_t get_min_demand_override_ms() const { return min_demand_override_ms_; }
+  uint32_t get_damper_min_dwell_ms() const { return damper_min_dwell_ms_; }
+  bool get_damper_idle_hold() const { return damper_idle_hold_; }
+  uint32_t get_damper_close_lookahead_ms() const { return damper_close_lookahead_ms_; }
+
+  // --- Runtime state ---
+  uint8_t get_num_zones() const { return num_zones_; }
+  Zone zone(uint8_t i) const;
+  ZoneState zone_state(uint8_t i) const { return state_[i]; }
+  uint16_t get_changed_zones() const { return changed_zones_; }  // zones whose state changed at the last commit
+  uint16_t get_enabled() const { return enabled_; }
+  // Committed-state masks (bit per zone)
+  uint16_t get_heating_zones() const { return heating_; }
+  uint16_t get_cooling_zones() const { return cooling_; }
+  uint16_t get_running_zones() const { return running_; }  // anything but OFF / WAIT / ERROR
+  uint16_t get_short_cycle_zones() const { return short_cycle_; }
+  bool has_zone_error() const { return zone_error_flag_; }
+  int get_global_max_priority() const { return global_max_priority_; }
+  uint8_t get_current_mode() const { return current_mode_; }
+  uint8_t get_last_active_mode() const { return last_active_mode_; }
+  unsigned long get_stage1_start_ms() const { return stage1_start_ms_; }
+  uint32_t get_mode_change_count() const { return mode_change_count_; }
+  const RuntimeStats &get_runtime() const { return runtime_; }  // time / entries per zone state and mode
+  void set_mode_change_count(uint32_t n) { mode_change_count_ = n; }  // restored from the state journal
+  const CoreOutput &get_output() const { return output_; }
+
+  /// Zones whose damper may open ahead of the next evaluation, from a raw
+  /// (undebounced) thermostat word: enabled, committed OFF with the damper
+  /// closed, and a call that decodes to an active state PASS 3–4 would not
+  /// hold or put in WAIT (priority at least the current maximum, or at rest
+  /// the highest raw call; no minimum demand hold). At rest the dampers are
+  /// all open unless damper_idle_hold left some closed.
+  uint16_t preposition_dampers(InputWord raw_thermostats) const;
+
+  // --- Event log (the passes record events, the adapter formats them) ---
+  EventLog &events() { return events_; }
+  const EventLog &events() const { return events_; }
+
+#ifdef OPEN_ZONING_STAGE_TIMING
+  // --- Per-pass timing (owned by the adapter) ---
+  void set_timings(StageTimings *timings) { timings_ = timings; }
+#endif
+
+ protected:
+  bool is_enabled_(uint8_t i) const { return (enabled_ >> i) & 1u; }
+  void invalidate_() {
+    full_ = true;
+    settled_ = false;
+  }
+  uint16_t all_zones_() const { return static_cast<uint16_t>((1u << num_zones_) - 1); }
+  /// Zones to recompute: changed inputs, due timers, last commit, errors
+  uint16_t dirty_zones_(const CoreInput &in) const;
+  // Next purge end or end of the minimum cycle of a timed_ zone
+  uint32_t zone_wake_ms_(uint8_t i) const {
+    return (purging_ >> i) & 1u ? purge_end_ms_[i] : active_start_ms_[i] + min_cycle_time_ms_;
+  }
+  // Zone i in an active cycle started less than min_cycle_time_ms_ ago
+  bool in_min_cycle_(uint8_t i) const {
+    return ((cycling_ >> i) & 1u) && now_ms_ - active_start_ms_[i] < min_cycle_time_ms_;
+  }
+  // Zones demanding after PASS 2 (active states, not Purge/Error/Wait/Off)
+  uint8_t demanding_count_() const { return __builtin_popcount(fan_local_ | cool_local_ | heat_local_); }
+
+  // --- Per-zone steps ---
+  // PASS 1: state_new_[i] from the DECODE_TABLE entry at table_index
+  // (ControlCore::IN_* bits | ob_on_heat << 4, see decode_index()). Returns
+  // true if the zone is in confirmed error. count_errors=false (event-driven
+  // runs) keeps error_count_ unchanged so the 2-cycle confirmation still
+  // spans two periodic polls, not two input edges.
+  bool calc_zone_state_(uint8_t i, uint8_t table_index, bool count_errors);
+  // PASS 1.5: minimum cycle time
+  void apply_short_cycle_protection_(uint8_t i);
+
+  // --- Pass methods (PASS 1–2 over the dirty zones, 2.5–5 on aggregates) ---
+  void pass1_calc_zone_states_(const CoreInput &in, bool count_errors, uint16_t dirty);
+  void pass1_5_short_cycle_protection_(uint16_t dirty);
+  void pass2_purge_management_(uint16_t dirty);
+  void pass2_5_minimum_demand_();
+  void pass3_priority_analysis_();
+  void pass4_damper_control_();
+  void pass5_output_control_();
+  void commit_();
+
+  // --- Zone data: one array per field, one mask per flag (bit i = zone i) ---
+  ZoneState state_[MAX_ZONES]{};        // committed
+  ZoneState state_new_[MAX_ZONES]{};    // being computed by the passes
+  ZoneState state_local_[MAX_ZONES]{};  // after PASS 2, reused while the zone is clean
+  uint8_t error_count_[MAX_ZONES]{};
+  uint32_t purge_end_ms_[MAX_ZONES]{};     // valid in purging_
+  uint32_t active_start_ms_[MAX_ZONES]{};  // valid in cycling_
+  uint16_t purging_{0};                    // purge timer armed
+  uint16_t cycling_{0};                    // in an active cycle (minimum cycle timer)
+  uint16_t short_cycle_{0};
+  uint16_t heating_{0}, cooling_{0}, running_{0};  // committed state
+  uint8_t num_zones_{0};
+  uint16_t enabled_{0};        // enabled mask of the current evaluation
+  uint16_t changed_zones_{0};
+
+  // --- Incremental evaluation ---
+  bool incremental_{true};
+  bool full_{true};          // next evaluation recomputes every zone
+  bool settled_{false};      // last evaluation changed nothing
+  CoreInput last_in_{};
+  DeadlineSet<NUM_TIMERS> timers_;  // registered by commit_()
+  uint16_t timed_{0};        // zones with a deadline (zone_wake_ms_())
+  uint16_t error_zones_{0};  // zones in ERROR after PASS 1
+  uint16_t error_pending_{0};  // zones with an error input or error_count > 0 (always dirty)
+  bool hold_{false};         // PASS 2.5 holds the demanding zones this evaluation
+  uint32_t skipped_evaluations_{0};
+  // Aggregate masks of the zone-local results (enabled zones only; a dirty
+  // zone leaves them until it is recomputed)
+  uint16_t heating_in_{0}, cooling_in_{0};  // heating / cooling after PASS 1.5
+  uint16_t fan_local_{0}, cool_local_{0}, heat_local_{0}, purge_local_{0};  // state_local_ by priority 1/2/4/6
+  uint16_t heat2_local_{0}, cool2_local_{0};  // state_local_ HEATING_STAGE2 / COOLING_STAGE2
+  uint32_t damper_moved_ms_[MAX_ZONES]{};  // valid in dwelling_
+  uint16_t dwelling_{0};                   // damper moved less than damper_min_dwell_ms_ ago
+
+  // --- Configuration ---
+  uint32_t min_cycle_time_ms_{480000};    // 8 minutes default
+  uint32_t purge_duration_ms_{300000};    // 5 minutes default
+  uint32_t stage2_escalation_ms_{3600000}; // 1 hour default
+  bool auto_mode_{true};                  // Auto mode enabled by default
+  uint8_t min_active_zones_{1};           // 1 = disabled (all single requests allowed)
+  uint32_t min_demand_override_ms_{1800000}; // 30 min emergency override
+  uint32_t damper_min_dwell_ms_{0};        // 0 = disabled (damper policy off by default)
+  bool damper_idle_hold_{false};
+  uint32_t damper_close_lookahead_ms_{0};
+
+  // --- Runtime state ---
+  unsigned long now_ms_{0};
+  unsigned long min_demand_wait_start_ms_{0};  // valid while demand_wait_
+  bool demand_wait_{false};
+  bool zone_error_flag_{false};
+  int global_max_priority_{0};
+  uint8_t current_mode_{0};       // Tracks active mode index (0-7)
+  uint8_t last_active_mode_{0};   // 0=unknown, 1=heating, 2=cooling
+  unsigned long stage1_start_ms_{0};  // Stage 2 escalation timer
+  bool stage2_escalated_{false};      // Stage 2 reached by the timer, held until the demand drops
+  uint32_t mode_change_count_{0};     // incremented at each real mode transition
+  RuntimeStats runtime_;
+  CoreOutput output_{};
+  EventLog events_;
+#ifdef OPEN_ZONING_STAGE_TIMING
+  StageTimings *timings_{nullptr};
+#endif
+};
+
+// ============================================================================
+// PASS 1 decode table
+// Index: the zone's input nibble (ControlCore::IN_*) | polarity << 4, where
+// polarity is the zone's ob_on_heat bit — i.e. straight from the packed
+// CoreInput words, with no per-input branch.
+// Entry: candidate ZoneState in the low nibble (OFF for an error input, the
+// 2-cycle confirmation stays in calc_zone_state_()), DECODE_NO_FAN when Y1 or
+// Y2 is called without G.
+// ============================================================================
+static constexpr uint8_t DECODE_STATE_MASK = 0x0F;
+static constexpr uint8_t DECODE_NO_FAN = 0x80;
+
+struct DecodeTable {
+  uint8_t entry[32];
+};
+
+/// Branch-free generator: G alone → FAN_ONLY (1), G + Y → 2 + 2*heating + Y2
+/// (COOLING_STAGE1/2, HEATING_STAGE1/2), no G → OFF.
+constexpr DecodeTable make_decode_table() {
+  DecodeTable t{};
+  for (uint8_t i = 0; i < 32; i++) {
+    const uint8_t y1 = i & 1, y2 = (i >> 1) & 1, g = (i >> 2) & 1, ob = (i >> 3) & 1, on_heat = (i >> 4) & 1;
+    const uint8_t heating = ob ^ on_heat ^ 1;
+    const uint8_t call = y1 | y2;
+    t.entry[i] = static_cast<uint8_t>(g * (1 + call * (1 + 2 * heating + y2)) | (call & (g ^ 1)) << 7);
+  }
+  return t;
+}
+
+static constexpr DecodeTable DECODE_TABLE = make_decode_table();
+
+/// The branch chain PASS 1 used before the table, kept as the
+/// specification the table is checked against.
+constexpr uint8_t decode_reference(bool y1, bool y2, bool g, bool ob, bool ob_on_heat) {
+  if ((y1 || y2) && !g) return DECODE_NO_FAN | static_cast<uint8_t>(ZoneState::OFF);
+  const bool ob_heating = ob_on_heat ? ob : !ob;
+  if (y2 && g && ob_heating) return static_cast<uint8_t>(ZoneState::HEATING_STAGE2);
+  if (y1 && g && ob_heating) return static_cast<uint8_t>(ZoneState::HEATING_STAGE1);
+  if (y2 && g && !ob_heating) return static_cast<uint8_t>(ZoneState::COOLING_STAGE2);
+  if (y1 && g && !ob_heating) return static_cast<uint8_t>(ZoneState::COOLING_STAGE1);
+  if (g) return static_cast<uint8_t>(ZoneState::FAN_ONLY);
+  return static_cast<uint8_t>(ZoneState::OFF);
+}
+
+constexpr bool decode_table_matches_reference() {
+  for (uint8_t i = 0; i < 32; i++) {
+    const uint8_t ref = decode_reference(i & ControlCore::IN_Y1, i & ControlCore::IN_Y2, i & ControlCore::IN_G,
+                                         i & ControlCore::IN_OB, (i >> 4) & 1);
+    if (DECODE_TABLE.entry[i] != ref) return false;
+  }
+  return true;
+}
+
+static_assert(decode_table_matches_reference(), "PASS 1 decode table diverges from the PASS 1 rules");
+
+/// Table index of one zone, straight from the packed input words.
+inline uint8_t decode_index(InputWord thermostats, uint16_t ob_on_heat, uint8_t zone) {
+  return static_cast<uint8_t>(((thermostats >> (4 * zone)) & 0x0F) | (((ob_on_heat >> zone) & 1u) << 4));
+}
+
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,99 @@
+#include "damper_scheduler.h"
+
+namespace esphome {
+namespace open_zoning {
+
+void DamperScheduler::plan(uint8_t zone, bool open, uint32_t now) {
+  if (zone >= MAX_ZONES) return;
+  Motor &m = motors_[zone];
+  const bool flipped = m.open != open;
+  m.open = open;
+  switch (m.phase) {
+    case STOP_OPPOSITE:
+    case RELEASE:
+      // Nothing released yet, or both coils already off: same deadline
+      break;
+    case STOP_SAME:
+      // The coil released first was the old opposite, i.e. the new target:
+      // the other one may still be engaged
+      if (flipped) m.phase = STOP_OPPOSITE;
+      break;
+    case IDLE:
+    case SETTLE:
+      m.phase = STOP_OPPOSITE;
+      m.due_ms = now;
+      break;
+  }
+}
+
+uint16_t DamperScheduler::mask_of_(Phase phase) const {
+  uint16_t mask = 0;
+  for (uint8_t i = 0; i < MAX_ZONES; i++) {
+    if (motors_[i].phase == phase) mask |= static_cast<uint16_t>(1u << i);
+  }
+  return mask;
+}
+
+uint16_t DamperScheduler::in_flight() const {
+  return mask_of_(STOP_OPPOSITE) | mask_of_(STOP_SAME) | mask_of_(RELEASE);
+}
+
+uint16_t DamperScheduler::due(Phase phase, uint32_t now) const {
+  int free = MAX_ZONES;
+  if (phase == RELEASE && max_moving_ > 0) {
+    free = max_moving_;
+    for (const Motor &m : motors_) {
+      if (m.phase == SETTLE && !time_reached(now, m.due_ms)) free--;
+    }
+  }
+  uint16_t mask = 0;
+  for (uint8_t i = 0; i < MAX_ZONES && free > 0; i++) {
+    const Motor &m = motors_[i];
+    if (m.phase != phase || !time_reached(now, m.due_ms)) continue;
+    mask |= static_cast<uint16_t>(1u << i);
+    if (phase == RELEASE) free--;
+  }
+  return mask;
+}
+
+void DamperScheduler::advance(uint16_t mask, uint32_t now) {
+  for (uint8_t i = 0; i < MAX_ZONES; i++) {
+    if (!(mask & (1u << i))) continue;
+    Motor &m = motors_[i];
+    switch (m.phase) {
+      case STOP_OPPOSITE:
+        m.phase = STOP_SAME;
+        m.due_ms = now + STOP_GAP_MS;
+        break;
+      case STOP_SAME:
+        m.phase = RELEASE;
+        m.due_ms = now + RELEASE_MS;
+        break;
+      case RELEASE:
+        m.phase = SETTLE;
+        m.due_ms = now + inrush_ms_;
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void DamperScheduler::released(uint16_t mask, uint32_t now) {
+  for (uint8_t i = 0; i < MAX_ZONES; i++) {
+    if (!(mask & (1u << i))) continue;
+    Motor &m = motors_[i];
+    if (m.phase != STOP_OPPOSITE && m.phase != STOP_SAME) continue;
+    m.phase = RELEASE;
+    m.due_ms = now + RELEASE_MS;
+  }
+}
+
+void DamperScheduler::expire(uint32_t now) {
+  for (Motor &m : motors_) {
+    if (m.phase == SETTLE && time_reached(now, m.due_ms)) m.phase = IDLE;
+  }
+}
+
+}  // namespace open_zoning
+}  // namespace esphome
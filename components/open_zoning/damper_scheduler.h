@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include "deadline.h"
+#include "zone.h"
+
+namespace esphome {
+namespace open_zoning {
+
+/// Motion plan of every damper motor, tracked per motor instead of as one
+/// serial queue: the stop phases of all zones overlap, their 250ms release
+/// windows run concurrently and the engage writes are grouped, so
+/// repositioning every damper takes about as long as repositioning one.
+///
+/// Per motor, the safety timing of the old script sequence is kept:
+///   STOP_OPPOSITE  release the coil opposite to the target
+///   STOP_SAME      50ms later, release the target coil
+///   RELEASE        250ms later (both coils off), engage the target coil
+///   SETTLE         engaged, counts as moving for the inrush window
+/// The latch backend (damper_port) releases both coils in one write and
+/// skips STOP_SAME.
+///
+/// At most max_moving motors are engaged within one inrush window (0: no
+/// cap); the others wait in RELEASE, lowest zone first.
+///
+/// Entity-free: the adapter asks which motors are due, performs the writes
+/// and reports them back.
+class DamperScheduler {
+ public:
+  enum Phase : uint8_t { IDLE, STOP_OPPOSITE, STOP_SAME, RELEASE, SETTLE };
+
+  static constexpr uint32_t STOP_GAP_MS = 50;   // between the two coil releases
+  static constexpr uint32_t RELEASE_MS = 250;   // both coils off before engaging
+
+  void set_max_moving(uint8_t n) { max_moving_ = n; }
+  void set_inrush_window(uint32_t ms) { inrush_ms_ = ms; }
+  uint8_t get_max_moving() const { return max_moving_; }
+  uint32_t get_inrush_window_ms() const { return inrush_ms_; }
+
+  /// New target for motor `zone`. A motor already in the plan keeps its
+  /// progress: its target is updated in place, and it only restarts from
+  /// STOP_OPPOSITE when a coil may still hold the other direction.
+  void plan(uint8_t zone, bool open, uint32_t now);
+
+  /// Motors in `phase` whose deadline has passed (bit per zone). For
+  /// RELEASE, limited to the free motion slots.
+  uint16_t due(Phase phase, uint32_t now) const;
+  /// The writes of `mask` are done: each motor moves to its next phase
+  void advance(uint16_t mask, uint32_t now);
+  /// Latch backend: both coils of `mask` were released in one write
+  void released(uint16_t mask, uint32_t now);
+  /// SETTLE → IDLE once the inrush window has passed
+  void expire(uint32_t now);
+
+  Phase phase(uint8_t zone) const { return motors_[zone].phase; }
+  bool target_open(uint8_t zone) const { return motors_[zone].open; }
+  /// Motors not yet engaged in their target direction
+  uint16_t in_flight() const;
+  /// Motors engaged within the last inrush window
+  uint16_t settling() const { return mask_of_(SETTLE); }
+  bool idle() const { return in_flight() == 0 && settling() == 0; }
+
+ protected:
+  struct Motor {
+    Phase phase{IDLE};
+    bool open{false};
+    uint32_t due_ms{0};
+  };
+  uint16_t mask_of_(Phase phase) const;
+
+  Motor motors_[MAX_ZONES];
+  uint8_t max_moving_{0};
+  uint32_t inrush_ms_{250};
+};
+
+}  // namespace open_zoning
+}  // namespace esphome
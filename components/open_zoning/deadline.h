@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace open_zoning {
+
+/// Wrap-safe millisecond time: millis() wraps after 49.7 days, so two
+/// timestamps are compared through their signed difference, never directly
+/// (`end > now` fails across the wrap). Valid for intervals under 24.8 days.
+inline bool time_reached(uint32_t now, uint32_t deadline) { return static_cast<int32_t>(now - deadline) >= 0; }
+
+/// Milliseconds left until `deadline`, 0 once reached
+inline uint32_t time_until(uint32_t now, uint32_t deadline) {
+  return time_reached(now, deadline) ? 0 : deadline - now;
+}
+
+/// Absolute deadlines of N timers, one slot per timer. A slot is armed or
+/// not: no sentinel value, any timestamp (0 included) is a valid deadline.
+template<uint8_t N> class DeadlineSet {
+  static_assert(N <= 32, "one armed bit per slot");
+
+ public:
+  void set(uint8_t id, uint32_t at) {
+    at_[id] = at;
+    armed_ |= 1u << id;
+  }
+  void clear(uint8_t id) { armed_ &= ~(1u << id); }
+  void clear_all() { armed_ = 0; }
+
+  bool armed(uint8_t id) const { return (armed_ >> id) & 1u; }
+  uint32_t get(uint8_t id) const { return at_[id]; }
+  bool reached(uint8_t id, uint32_t now) const { return armed(id) && time_reached(now, at_[id]); }
+
+  /// Any armed deadline reached at `now`
+  bool any_reached(uint32_t now) const {
+    for (uint8_t i = 0; i < N; i++) {
+      if (reached(i, now)) return true;
+    }
+    return false;
+  }
+
+  /// Earliest armed deadline still ahead of `now`; false when there is none.
+  /// Ordered by distance from `now`, so the order holds across the wrap.
+  bool next(uint32_t now, uint32_t *at) const {
+    bool found = false;
+    uint32_t best = 0;
+    for (uint8_t i = 0; i < N; i++) {
+      if (!armed(i) || time_reached(now, at_[i])) continue;
+      const uint32_t left = at_[i] - now;
+      if (!found || left < best) best = left;
+      found = true;
+    }
+    if (found) *at = now + best;
+    return found;
+  }
+
+ protected:
+  uint32_t at_[N]{};
+  uint32_t armed_{0};
+};
+
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,165 @@
+#include "event_log.h"
+#include <cstdio>
+#include "esphome/core/log.h"
+#include "control_core.h"
+
+namespace esphome {
+namespace open_zoning {
+
+int EventLog::level(Event id) {
+  switch (id) {
+    case Event::ZONE_ERROR_CONFIRMED:
+    case Event::ERROR_SHUTDOWN:
+      return ESPHOME_LOG_LEVEL_ERROR;
+    case Event::ZONE_ERROR_DETECTED:
+    case Event::ZONE_SHORT_CYCLE:
+    case Event::ZONE_PURGE_BLOCKED:
+    case Event::DEMAND_OVERRIDE:
+    case Event::STAGE2_ESCALATION:
+      return ESPHOME_LOG_LEVEL_WARN;
+    case Event::ZONE_ERROR_CLEARED:
+    case Event::ZONE_CYCLE_STARTED:
+    case Event::ZONE_PURGE_STARTED:
+    case Event::ZONE_PURGE_DONE:
+    case Event::STAGE1_STARTED:
+    case Event::MODE_CHANGE:
+    case Event::ZONE_STATE:
+    case Event::DAMPER_OPEN:
+    case Event::DAMPER_CLOSE:
+    case Event::DAMPER_QUEUED:
+    case Event::DAMPER_MERGED:
+    case Event::DAMPER_PREPOSITION:
+      return ESPHOME_LOG_LEVEL_INFO;
+    default:
+      return ESPHOME_LOG_LEVEL_DEBUG;
+  }
+}
+
+size_t EventLog::format(const EventRecord &r, char *buf, size_t len) {
+  const int zone = r.zone + 1;
+  const auto state = [](int32_t s) { return state_to_string(static_cast<ZoneState>(s)); };
+  int n;
+  switch (r.id) {
+    case Event::ZONE_ERROR_DETECTED:
+      n = snprintf(buf, len, "Zone %d error detected (count: 1/2) - Y1:%d Y2:%d G:0", zone, r.a, r.b);
+      break;
+    case Event::ZONE_ERROR_CONFIRMED:
+      n = snprintf(buf, len, "Zone %d ERROR CONFIRMED (count: 2/2) - Y1:%d Y2:%d G:0", zone, r.a, r.b);
+      break;
+    case Event::ZONE_ERROR_CLEARED:
+      n = snprintf(buf, len, "Zone %d error cleared (was at count: %d)", zone, r.a);
+      break;
+    case Event::ZONE_CYCLE_STARTED:
+      n = snprintf(buf, len, "Zone %d started active cycle at %u ms", zone, static_cast<uint32_t>(r.a));
+      break;
+    case Event::ZONE_SHORT_CYCLE:
+      n = snprintf(buf, len, "Zone %d short cycle protection ACTIVATED (%u / %u ms)", zone,
+                   static_cast<uint32_t>(r.a), static_cast<uint32_t>(r.b));
+      break;
+    case Event::ZONE_PURGE_BLOCKED:
+      n = snprintf(buf, len, "Zone %d prevented from entering purge - minimum cycle time not met", zone);
+      break;
+    case Event::ZONE_PURGE_STARTED:
+      n = snprintf(buf, len, "Zone %d starting purge (duration: %u ms)", zone, static_cast<uint32_t>(r.a));
+      break;
+    case Event::ZONE_PURGE_DONE:
+      n = snprintf(buf, len, "Zone %d purge complete", zone);
+      break;
+    case Event::DEMAND_HOLD:
+      n = snprintf(buf, len, "PASS2.5: threshold not met (%d/%d zones) — holding, override in %u ms", r.a >> 8,
+                   r.a & 0xFF, static_cast<uint32_t>(r.b));
+      break;
+    case Event::DEMAND_OVERRIDE:
+      n = snprintf(buf, len, "PASS2.5: emergency override — zone(s) waiting >%u ms, forcing start",
+                   static_cast<uint32_t>(r.a));
+      break;
+    case Event::ZONE_HELD:
+      n = snprintf(buf, len, "PASS2.5: Zone %d held (WAIT) — waiting for %d/%d zones", zone, r.a >> 8, r.a & 0xFF);
+      break;
+    case Event::ERROR_SHUTDOWN:
+      n = snprintf(buf, len, "Zone error detected - forcing central unit to Arrêt");
+      break;
+    case Event::STAGE1_STARTED:
+      n = snprintf(buf, len, "Stage 1 started - escalation timer armed (%u ms)", static_cast<uint32_t>(r.a));
+      break;
+    case Event::STAGE2_ESCALATION:
+      n = snprintf(buf, len, "Stage 2 ESCALATION triggered after %u ms (threshold: %u ms)",
+                   static_cast<uint32_t>(r.a), static_cast<uint32_t>(r.b));
+      break;
+    case Event::MODE_CHANGE:
+      n = snprintf(buf, len, "Mode change: %d -> %d (priority: %d)", r.a >> 8, r.a & 0xFF, r.b);
+      break;
+    case Event::ZONE_STATE:
+      n = snprintf(buf, len, "Zone %d: %s -> %s", zone, state(r.a), state(r.b));
+      break;
+    case Event::CYCLE_DONE:
+      n = snprintf(buf, len, "%s cycle complete — max_priority=%d error_flag=%s", (r.b & 2) ? "Update" : "Event",
+                   r.a, (r.b & 1) ? "YES" : "no");
+      break;
+    case Event::DAMPER_OPEN:
+      n = snprintf(buf, len, "Zone %d damper -> OPEN", zone);
+      break;
+    case Event::DAMPER_CLOSE:
+      n = snprintf(buf, len, r.a ? "Zone %d disabled — damper -> CLOSE" : "Zone %d damper -> CLOSE", zone);
+      break;
+    case Event::DAMPER_QUEUED:
+      n = snprintf(buf, len, "Damper plan: %d motor(s) scheduled", r.a);
+      break;
+    case Event::DAMPER_QUEUE_DONE:
+      n = snprintf(buf, len, "Damper plan complete (%d motor(s) engaged)", r.a);
+      break;
+    case Event::DAMPER_MERGED:
+      n = snprintf(buf, len, "Damper plan merged — %d motor(s) added to %d in flight", r.a, r.b);
+      break;
+    case Event::DAMPER_ENGAGED:
+      n = snprintf(buf, len, "Damper port: %d damper(s) engaged", r.a);
+      break;
+    case Event::DAMPER_PREPOSITION:
+      n = snprintf(buf, len, r.a ? "Zone %d call not confirmed — pre-positioned damper rolled back"
+                                 : "Zone %d raw call — damper pre-positioned", zone);
+      break;
+    case Event::STATE_SAVED:
+      n = snprintf(buf, len, "State journal: record %d saved to slot %d", r.b, r.a);
+      break;
+    case Event::MODE_APPLIED:
+      n = r.a < ControlCore::NUM_MODES
+              ? snprintf(buf, len, "Mode: %s", ControlCore::mode_to_string(static_cast<uint8_t>(r.a)))
+              : snprintf(buf, len, "Unknown mode index: %d", r.a);
+      break;
+    default:
+      n = snprintf(buf, len, "Event %d (zone %d): %d %d", static_cast<int>(r.id), zone, r.a, r.b);
+      break;
+  }
+  return n < 0 ? 0 : static_cast<size_t>(n);
+}
+
+uint8_t EventLog::drain(uint8_t max) {
+  uint8_t logged = 0;
+  char line[112];
+  while (pending_ > 0 && logged < max) {
+    const EventRecord &r = at(static_cast<uint8_t>(size_ - pending_));
+    pending_--;
+    logged++;
+    // The summary of a periodic poll is the same line every update
+    // interval: kept for dump(), never formatted live
+    if (r.id == Event::CYCLE_DONE && (r.b & 2)) continue;
+    const int lvl = level(r.id);
+    if (lvl > ESPHOME_LOG_LEVEL) continue;  // compiled out: never formatted
+    format(r, line, sizeof(line));
+    esp_log_printf_(lvl, TAG, __LINE__, "%s%s", label_, line);
+  }
+  return logged;
+}
+
+void EventLog::dump() const {
+  char line[112];
+  ESP_LOGI(TAG, "%sEvent log: %d record(s), %u dropped", label_, size_, dropped_);
+  for (uint8_t i = 0; i < size_; i++) {
+    const EventRecord &r = at(i);
+    format(r, line, sizeof(line));
+    ESP_LOGI(TAG, "  [%u ms] %s%s", r.ms, label_, line);
+  }
+}
+
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace open_zoning {
+
+/// Events of the update cycle. Each one stands for a log line that used to be
+/// formatted inline; EventLog::format() holds the text.
+enum class Event : uint8_t {
+  // PASS 1 / 1.5 — zone inputs (a, b: see format())
+  ZONE_ERROR_DETECTED,   // a = Y1, b = Y2
+  ZONE_ERROR_CONFIRMED,  // a = Y1, b = Y2
+  ZONE_ERROR_CLEARED,    // a = error count
+  ZONE_CYCLE_STARTED,    // a = start ms
+  ZONE_SHORT_CYCLE,      // a = elapsed ms, b = min cycle ms
+  // PASS 2 — purge
+  ZONE_PURGE_BLOCKED,
+  ZONE_PURGE_STARTED,  // a = duration ms
+  ZONE_PURGE_DONE,
+  // PASS 2.5 — minimum demand
+  DEMAND_HOLD,      // a = demanding << 8 | required, b = override ms
+  DEMAND_OVERRIDE,  // a = override ms
+  ZONE_HELD,        // a = demanding << 8 | required
+  // PASS 5 — mode
+  ERROR_SHUTDOWN,
+  STAGE1_STARTED,     // a = escalation delay ms
+  STAGE2_ESCALATION,  // a = elapsed ms, b = delay ms
+  MODE_CHANGE,        // a = old << 8 | new, b = global max priority
+  // Commit
+  ZONE_STATE,  // a = old ZoneState, b = new ZoneState
+  // Adapter
+  CYCLE_DONE,          // a = global max priority, b = periodic << 1 | error flag
+  DAMPER_OPEN,
+  DAMPER_CLOSE,        // a = 1 when the zone is disabled
+  DAMPER_QUEUED,       // a = motors planned
+  DAMPER_QUEUE_DONE,   // a = motors engaged
+  DAMPER_MERGED,       // a = motors planned, b = motors already in flight
+  DAMPER_ENGAGED,      // a = dampers engaged
+  DAMPER_PREPOSITION,  // a = 1 when rolled back
+  STATE_SAVED,         // a = journal slot, b = record sequence
+  MODE_APPLIED,        // a = mode index
+  NUM_EVENTS
+};
+
+/// One event: a fixed-size record, written without any formatting.
+struct EventRecord {
+  uint32_t ms;
+  Event id;
+  uint8_t zone;  // 0-based, EventLog::NO_ZONE when not a zone event
+  int32_t a;
+  int32_t b;
+};
+
+/// RAM ring of the last CAPACITY events of the update cycle.
+///
+/// push() is a 16-byte copy; the text is produced later by drain() (from
+/// loop(), a few records at a time, out of the pass pipeline) or dump() (on
+/// demand, e.g. from an API service). When the ring wraps before a drain,
+/// the oldest records are lost and counted in get_dropped().
+class EventLog {
+ public:
+  static constexpr uint8_t CAPACITY = 64;
+  static constexpr uint8_t NO_ZONE = 0xFF;
+
+  void push(uint32_t ms, Event id, uint8_t zone = NO_ZONE, int32_t a = 0, int32_t b = 0) {
+    records_[head_] = EventRecord{ms, id, zone, a, b};
+    head_ = static_cast<uint8_t>((head_ + 1) % CAPACITY);
+    if (size_ < CAPACITY) {
+      size_++;
+    }
+    if (pending_ < CAPACITY) {
+      pending_++;
+    } else {
+      dropped_++;  // overwrote a record nobody formatted
+    }
+  }
+
+  /// Log up to `max` pending records, oldest first, at their own level;
+  /// periodic CYCLE_DONE summaries are consumed without a line. Returns the
+  /// number consumed.
+  uint8_t drain(uint8_t max);
+  /// Log every retained record with its timestamp, drained or not.
+  void dump() const;
+  /// Forget the pending records without logging them.
+  void discard() { pending_ = 0; }
+  /// Prefix of every logged line (e.g. "Unit 2: "), empty by default
+  void set_label(const char *label) { label_ = label; }
+
+  uint8_t size() const { return size_; }
+  uint8_t pending() const { return pending_; }
+  uint32_t get_dropped() const { return dropped_; }
+  /// i-th retained record, 0 = oldest
+  const EventRecord &at(uint8_t i) const { return records_[(head_ + CAPACITY - size_ + i) % CAPACITY]; }
+
+  /// ESPHOME_LOG_LEVEL_* of an event
+  static int level(Event id);
+  /// The log line of a record (without tag or timestamp)
+  static size_t format(const EventRecord &r, char *buf, size_t len);
+
+ protected:
+  EventRecord records_[CAPACITY]{};
+  uint8_t head_{0};     // next slot written
+  uint8_t size_{0};     // retained records
+  uint8_t pending_{0};  // newest records not drained yet
+  uint32_t dropped_{0};
+  const char *label_{""};
+};
+
+}  // namespace open_zoning
+}  // namespace esphome
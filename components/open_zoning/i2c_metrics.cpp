@@ -0,0 +1,84 @@
+#include "i2c_metrics.h"
+#include <cstring>
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+#include "zone.h"
+
+namespace esphome {
+namespace open_zoning {
+
+MeteredBus::MeteredBus() : millis_(&millis), micros_(&micros) {}
+
+i2c::ErrorCode MeteredBus::readv(uint8_t address, i2c::ReadBuffer *buffers, size_t cnt) {
+  if (parent_ == nullptr) return i2c::ERROR_NOT_INITIALIZED;
+  const uint32_t start = micros_();
+  const i2c::ErrorCode err = parent_->readv(address, buffers, cnt);
+  record_(address, err, start, false);
+  return err;
+}
+
+i2c::ErrorCode MeteredBus::writev(uint8_t address, i2c::WriteBuffer *buffers, size_t cnt, bool stop) {
+  if (parent_ == nullptr) return i2c::ERROR_NOT_INITIALIZED;
+  const uint32_t start = micros_();
+  const i2c::ErrorCode err = parent_->writev(address, buffers, cnt, stop);
+
+  bool retry = false;
+  if (tracked_(address)) {
+    const FailedWrite w = capture_(buffers, cnt);
+    FailedWrite &last = failed_[address - FIRST_ADDRESS];
+    retry = metrics_[address - FIRST_ADDRESS].last_failed && w.len > 0 && w.len == last.len &&
+            std::memcmp(w.data, last.data, w.len) == 0;
+    last = err != i2c::ERROR_OK ? w : FailedWrite{};
+  }
+  record_(address, err, start, retry);
+  return err;
+}
+
+MeteredBus::FailedWrite MeteredBus::capture_(const i2c::WriteBuffer *buffers, size_t cnt) {
+  FailedWrite w;
+  for (size_t b = 0; b < cnt; b++) {
+    for (size_t i = 0; i < buffers[b].len && w.len < sizeof(w.data); i++) w.data[w.len++] = buffers[b].data[i];
+  }
+  return w;
+}
+
+void MeteredBus::record_(uint8_t address, i2c::ErrorCode err, uint32_t start_us, bool retry) {
+  if (!tracked_(address)) return;
+  I2cAddressMetrics &m = metrics_[address - FIRST_ADDRESS];
+  const uint32_t us = micros_() - start_us;
+  m.transactions++;
+  m.latency[I2cAddressMetrics::bucket(us)]++;
+  if (us > m.max_latency_us) m.max_latency_us = us;
+  if (retry) m.retries++;
+  if (err == i2c::ERROR_OK) {
+    m.last_ok_ms = millis_();
+    m.has_ok = true;
+    m.last_failed = false;
+  } else {
+    if (err == i2c::ERROR_NOT_ACKNOWLEDGED) {
+      m.nacks++;
+    } else {
+      m.errors++;
+    }
+    m.last_failed = true;
+  }
+}
+
+bool MeteredBus::recently_ok(uint8_t address, uint32_t window_ms) const {
+  const I2cAddressMetrics *m = get(address);
+  return m != nullptr && m->has_ok && !m->last_failed && millis_() - m->last_ok_ms < window_ms;
+}
+
+void MeteredBus::dump() const {
+  for (uint8_t i = 0; i < NUM_ADDRESSES; i++) {
+    const I2cAddressMetrics &m = metrics_[i];
+    if (m.transactions == 0) continue;
+    const uint32_t *h = m.latency;
+    ESP_LOGCONFIG(TAG, "    0x%02X: %u transactions, %u NACK, %u errors, %u retries, max %u µs | %u %u %u %u %u %u %u %u",
+                  FIRST_ADDRESS + i, m.transactions, m.nacks, m.errors, m.retries, m.max_latency_us, h[0], h[1],
+                  h[2], h[3], h[4], h[5], h[6], h[7]);
+  }
+}
+
+}  // namespace open_zoning
+}  // namespace esphome
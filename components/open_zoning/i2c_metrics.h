@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "esphome/components/i2c/i2c.h"
+
+namespace esphome {
+namespace open_zoning {
+
+/// Traffic counters of one I2C address.
+struct I2cAddressMetrics {
+  // Latency histogram, factor 2 per bucket: <64, <128, <256, <512, <1k,
+  // <2k, <4k, >=4k µs
+  static constexpr uint8_t NUM_BUCKETS = 8;
+
+  uint32_t transactions{0};
+  uint32_t nacks{0};    // ERROR_NOT_ACKNOWLEDGED
+  uint32_t errors{0};   // any other error code
+  uint32_t retries{0};  // write repeated after it failed (McpPort::flush() retry)
+  uint32_t max_latency_us{0};
+  uint32_t latency[NUM_BUCKETS]{};
+  uint32_t last_ok_ms{0};  // millis() of the last successful transaction
+  bool has_ok{false};      // at least one success since boot
+  bool last_failed{false};
+
+  static uint8_t bucket(uint32_t us) {
+    uint8_t b = 0;
+    for (us >>= 6; us != 0 && b < NUM_BUCKETS - 1; us >>= 1) b++;
+    return b;
+  }
+};
+
+/// I2C bus decorator: every transaction of the component (latch writes,
+/// input reads, watchdog probes) goes through it to the real bus and is
+/// counted per MCP23017 address (0x20–0x27).
+///
+/// The ESPHome mcp23017 switches and binary sensors keep their own bus
+/// pointer: their traffic is not seen here.
+class MeteredBus : public i2c::I2CBus {
+ public:
+  static constexpr uint8_t FIRST_ADDRESS = 0x20;
+  static constexpr uint8_t NUM_ADDRESSES = 8;
+  using Clock = uint32_t (*)();
+
+  MeteredBus();
+
+  void set_parent(i2c::I2CBus *parent) { parent_ = parent; }
+  i2c::I2CBus *get_parent() const { return parent_; }
+  void set_clocks(Clock millis_src, Clock micros_src) {
+    millis_ = millis_src;
+    micros_ = micros_src;
+  }
+
+  using i2c::I2CBus::read;
+  using i2c::I2CBus::write;
+  i2c::ErrorCode readv(uint8_t address, i2c::ReadBuffer *buffers, size_t cnt) override;
+  i2c::ErrorCode writev(uint8_t address, i2c::WriteBuffer *buffers, size_t cnt, bool stop) override;
+
+  /// Counters of an MCP23017 address, nullptr outside 0x20–0x27
+  const I2cAddressMetrics *get(uint8_t address) const {
+    return tracked_(address) ? &metrics_[address - FIRST_ADDRESS] : nullptr;
+  }
+  /// Whether `address` completed a transaction within the last `window_ms`
+  /// and none failed since.
+  bool recently_ok(uint8_t address, uint32_t window_ms) const;
+
+  /// One line per address that saw traffic
+  void dump() const;
+
+ protected:
+  static bool tracked_(uint8_t address) {
+    return address >= FIRST_ADDRESS && address < FIRST_ADDRESS + NUM_ADDRESSES;
+  }
+  void record_(uint8_t address, i2c::ErrorCode err, uint32_t start_us, bool retry);
+
+  // Last failed write per address (first bytes), to recognise its retry
+  struct FailedWrite {
+    uint8_t len{0};
+    uint8_t data[4]{};
+  };
+  static FailedWrite capture_(const i2c::WriteBuffer *buffers, size_t cnt);
+
+  i2c::I2CBus *parent_{nullptr};
+  Clock millis_;
+  Clock micros_;
+  I2cAddressMetrics metrics_[NUM_ADDRESSES];
+  FailedWrite failed_[NUM_ADDRESSES];
+};
+
+}  // namespace open_zoning
+}  // namespace esphome
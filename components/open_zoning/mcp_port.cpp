@@ -0,0 +1,84 @@
+#include "mcp_port.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace open_zoning {
+
+static const char *const TAG = "open_zoning";
+
+bool McpPort::sync() {
+  if (bus_ == nullptr) return false;
+
+  uint16_t raw = 0;
+  if (!read_register_(REG_OLATA, &raw)) return false;
+  if (inverted_) raw = static_cast<uint16_t>(~raw);
+  pending_ = raw;
+  latched_ = raw;
+  return true;
+}
+
+bool McpPort::flush() {
+  if (bus_ == nullptr) return false;
+  if (pending_ == latched_) return true;  // nothing changed — no bus traffic
+
+  const uint16_t raw = inverted_ ? static_cast<uint16_t>(~pending_) : pending_;
+  const uint8_t data[3] = {REG_OLATA, static_cast<uint8_t>(raw & 0xFF), static_cast<uint8_t>(raw >> 8)};
+  i2c::ErrorCode err = bus_->write(address_, data, sizeof(data), true);
+  if (err != i2c::ERROR_OK) {
+    // latched_ is left untouched so the next flush() retries the same write
+    ESP_LOGW(TAG, "MCP23017@0x%02X: OLAT write failed (error %d)", address_, static_cast<int>(err));
+    return false;
+  }
+
+  latched_ = pending_;
+  write_count_++;
+  return true;
+}
+
+bool McpPort::configure_inputs(uint16_t pins) {
+  if (bus_ == nullptr) return false;
+
+  uint16_t iodir = 0, gppu = 0;
+  if (!read_register_(REG_IODIRA, &iodir) || !read_register_(REG_GPPUA, &gppu)) return false;
+  if ((iodir & pins) != pins && !write_register_(REG_IODIRA, iodir | pins)) return false;
+  if ((gppu & pins) != pins && !write_register_(REG_GPPUA, gppu | pins)) return false;
+  return true;
+}
+
+bool McpPort::read_gpio(uint16_t *levels) {
+  if (bus_ == nullptr) return false;
+
+  uint16_t raw = 0;
+  if (!read_register_(REG_GPIOA, &raw)) return false;
+  *levels = inverted_ ? static_cast<uint16_t>(~raw) : raw;
+  read_count_++;
+  return true;
+}
+
+// A and B registers of a pair are adjacent (IOCON.BANK=0): one 2-byte access
+bool McpPort::read_register_(uint8_t reg, uint16_t *value) {
+  uint8_t data[2] = {0, 0};
+  i2c::ErrorCode err = bus_->write(address_, &reg, 1, false);
+  if (err == i2c::ERROR_OK) err = bus_->read(address_, data, 2);
+  if (err != i2c::ERROR_OK) {
+    ESP_LOGW(TAG, "MCP23017@0x%02X: register 0x%02X read failed (error %d)", address_, reg,
+             static_cast<int>(err));
+    return false;
+  }
+  *value = static_cast<uint16_t>(data[0] | (data[1] << 8));
+  return true;
+}
+
+bool McpPort::write_register_(uint8_t reg, uint16_t value) {
+  const uint8_t data[3] = {reg, static_cast<uint8_t>(value & 0xFF), static_cast<uint8_t>(value >> 8)};
+  i2c::ErrorCode err = bus_->write(address_, data, sizeof(data), true);
+  if (err != i2c::ERROR_OK) {
+    ESP_LOGW(TAG, "MCP23017@0x%02X: register 0x%02X write failed (error %d)", address_, reg,
+             static_cast<int>(err));
+    return false;
+  }
+  return true;
+}
+
+}  // namespace open_zoning
+}  // namespace esphome
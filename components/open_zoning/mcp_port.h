@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include "esphome/components/i2c/i2c.h"
+
+namespace esphome {
+namespace open_zoning {
+
+/// Shadow of one MCP23017 16-bit output latch (OLATA + OLATB).
+///
+/// Pins are staged with set() and the whole latch goes out in a single I2C
+/// transaction on flush(), instead of one read-modify-write per Switch.
+/// The shadow holds logical levels; `inverted` is applied on the wire only.
+///
+/// An expander used for inputs instead goes through configure_inputs() and
+/// read_gpio(): the whole GPIOA/GPIOB port in one register read.
+///
+/// The component must be the only writer of the pins it drives on this
+/// expander: the ESPHome mcp23017 driver caches OLAT and would write stale
+/// bits back on its next Switch write. Mark the matching gpio switches
+/// `internal: true` — they still configure IODIR at boot and act as mirrors.
+class McpPort {
+ public:
+  // IOCON.BANK=0 (ESPHome default): OLATB immediately follows OLATA, so a
+  // sequential 2-byte write/read covers the full 16-bit latch.
+  static constexpr uint8_t REG_IODIRA = 0x00;
+  static constexpr uint8_t REG_GPPUA = 0x0C;
+  static constexpr uint8_t REG_GPIOA = 0x12;
+  static constexpr uint8_t REG_OLATA = 0x14;
+  static constexpr uint8_t NO_PIN = 255;
+
+  void set_bus(i2c::I2CBus *bus) { bus_ = bus; }
+  void set_address(uint8_t address) { address_ = address; }
+  void set_inverted(bool inverted) { inverted_ = inverted; }
+
+  bool is_configured() const { return bus_ != nullptr; }
+  uint8_t get_address() const { return address_; }
+  bool is_inverted() const { return inverted_; }
+
+  /// Reload the shadow from the chip (one register read).
+  bool sync();
+  /// Write the staged latch if it differs from the last written value.
+  bool flush();
+
+  /// Make `pins` inputs with pull-ups (IODIR and GPPU read-modify-write),
+  /// leaving the other pins as configured.
+  bool configure_inputs(uint16_t pins);
+  /// Read GPIOA + GPIOB (one register read) as logical levels.
+  bool read_gpio(uint16_t *levels);
+
+  void set(uint8_t pin, bool on) {
+    if (pin >= 16) return;
+    if (on) {
+      pending_ |= static_cast<uint16_t>(1u << pin);
+    } else {
+      pending_ &= static_cast<uint16_t>(~(1u << pin));
+    }
+  }
+  bool get(uint8_t pin) const { return pin < 16 && (pending_ >> pin) & 1u; }
+  bool is_dirty() const { return pending_ != latched_; }
+
+  uint32_t get_write_count() const { return write_count_; }
+  uint32_t get_read_count() const { return read_count_; }
+
+ protected:
+  i2c::I2CBus *bus_{nullptr};
+  uint8_t address_{0};
+  bool inverted_{true};
+  uint16_t pending_{0};  // logical levels staged by set()
+  uint16_t latched_{0};  // logical levels last read from / written to the chip
+  uint32_t write_count_{0};
+  uint32_t read_count_{0};
+
+  bool read_register_(uint8_t reg, uint16_t *value);
+  bool write_register_(uint8_t reg, uint16_t value);
+};
+
+}  // namespace open_zoning
+}  // namespace esphome
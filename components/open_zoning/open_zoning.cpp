@@ -5,106 +5,27 @@ namespace esphome {
 namespace open_zoning {
 
 // ============================================================================
-// Zone method implementations
+// OpenZoningController method implementations
 // ============================================================================
 
-bool Zone::calc_state() {
-  state_new = ZoneState::OFF;
-  bool error_triggered = false;
-
-  // Error detection: Y1 or Y2 active without G (fan)
-  if ((y1->state || y2->state) && !g->state) {
-    error_count++;
-    if (error_count == 1) {
-      ESP_LOGW(TAG, "Zone %d error detected (count: 1/2) - Y1:%d Y2:%d G:%d",
-               index + 1, y1->state, y2->state, g->state);
-    }
-    if (error_count >= 2) {
-      ESP_LOGE(TAG, "Zone %d ERROR CONFIRMED (count: 2/2) - Y1:%d Y2:%d G:%d",
-               index + 1, y1->state, y2->state, g->state);
-      state_new = ZoneState::ERROR;
-      error_triggered = true;
-      return error_triggered;
-    }
-  } else {
-    if (error_count > 0) {
-      ESP_LOGI(TAG, "Zone %d error cleared (was at count: %d)", index + 1, error_count);
-      error_count = 0;
-    }
-  }
-
-  // State determination (highest priority first)
-  // ob_on_heat=true  : O/B active → heating (default)
-  // ob_on_heat=false : O/B active → cooling (some thermostats, e.g. Carrier)
-  const bool ob_heating = ob_on_heat ? ob->state : !ob->state;
-  if (y2->state && g->state && ob_heating) {
-    state_new = ZoneState::HEATING_STAGE2;
-  } else if (y1->state && g->state && ob_heating) {
-    state_new = ZoneState::HEATING_STAGE1;
-  } else if (y2->state && g->state && !ob_heating) {
-    state_new = ZoneState::COOLING_STAGE2;
-  } else if (y1->state && g->state && !ob_heating) {
-    state_new = ZoneState::COOLING_STAGE1;
-  } else if (g->state) {
-    state_new = ZoneState::FAN_ONLY;
-  }
-
-  return error_triggered;
-}
-
-void Zone::apply_short_cycle_protection(unsigned long current_time, unsigned long min_cycle_time_ms) {
-  // Track when a zone first becomes active (heating/cooling)
-  if (state == ZoneState::OFF && is_active()) {
-    active_start_ms = current_time;
-    ESP_LOGI(TAG, "Zone %d started active cycle at %lu ms", index + 1, active_start_ms);
-  }
-
-  // Error clears protection immediately
-  if (state_new == ZoneState::ERROR) {
-    active_start_ms = 0;
-    if (short_cycle_protection) {
-      short_cycle_protection = false;
-    }
-    return;
-  }
-
-  if (was_active() && state_new == ZoneState::OFF) {
-    // Zone transitioning from active to OFF — check minimum cycle time
-    unsigned long elapsed = current_time - active_start_ms;
-    if (elapsed < min_cycle_time_ms) {
-      // Hold in previous state
-      state_new = state;
-      if (!short_cycle_protection) {
-        short_cycle_protection = true;
-        ESP_LOGW(TAG, "Zone %d short cycle protection ACTIVATED (%lu / %lu ms)",
-                 index + 1, elapsed, min_cycle_time_ms);
-      }
-    } else {
-      if (short_cycle_protection) {
-        short_cycle_protection = false;
-      }
-      active_start_ms = 0;
-    }
-  } else if (state_new != ZoneState::OFF) {
-    // Zone still active — update protection flag based on elapsed time
-    if (active_start_ms > 0) {
-      unsigned long elapsed = current_time - active_start_ms;
-      bool new_protection = (elapsed < min_cycle_time_ms);
-      if (short_cycle_protection != new_protection) {
-        short_cycle_protection = new_protection;
-      }
-    }
-  } else {
-    // Zone is OFF and was OFF (or non-active) — clear protection
-    if (short_cycle_protection) {
-      short_cycle_protection = false;
-    }
-  }
+namespace {
+
+// Zone state texts, built once at the first publish (setup()): the text
+// sensors copy from a reference instead of a std::string built per change
+const std::string &state_text(ZoneState state) {
+  static const std::string TEXT[] = {
+      state_to_string(ZoneState::OFF),            state_to_string(ZoneState::FAN_ONLY),
+      state_to_string(ZoneState::COOLING_STAGE1), state_to_string(ZoneState::COOLING_STAGE2),
+      state_to_string(ZoneState::HEATING_STAGE1), state_to_string(ZoneState::HEATING_STAGE2),
+      state_to_string(ZoneState::PURGE),          state_to_string(ZoneState::WAIT),
+      state_to_string(ZoneState::ERROR),          state_to_string(static_cast<ZoneState>(0xFF)),
+  };
+  const uint8_t index = static_cast<uint8_t>(state);
+  if (index <= static_cast<uint8_t>(ZoneState::WAIT)) return TEXT[index];
+  return state == ZoneState::ERROR ? TEXT[8] : TEXT[9];
 }
 
-// ============================================================================
-// OpenZoningController method implementations
-// ============================================================================
+}  // namespace
 
 void OpenZoningController::set_zone_sensors(uint8_t index,
                                             binary_sensor::BinarySensor *y1,
@@ -140,48 +61,113 @@ void OpenZoningController::set_zone_state_sensor(uint8_t index, text_sensor::Tex
   zones_[index].state_sensor = sensor;
 }
 
+void OpenZoningController::set_zone_damper_pins(uint8_t index, uint8_t open_pin, uint8_t close_pin) {
+  if (index >= MAX_ZONES) {
+    ESP_LOGE(TAG, "Zone index %d exceeds MAX_ZONES (%d)", index, MAX_ZONES);
+    return;
+  }
+  zones_[index].damper_open_pin = open_pin;
+  zones_[index].damper_close_pin = close_pin;
+}
+
 void OpenZoningController::setup() {
   ESP_LOGI(TAG, "OpenZoning initialized — %d zones configured", num_zones_);
 
-  // Initialize all configured zones with their index
-  for (uint8_t i = 0; i < num_zones_; i++) {
-    zones_[i].index = i;
-    zones_[i].state = ZoneState::OFF;
-    zones_[i].state_new = ZoneState::OFF;
-    zones_[i].damper_state = 255;  // Unknown — forces first update() to drive correct position
-    zones_[i].error_count = 0;
-    zones_[i].purge_end_ms = 0;
-    zones_[i].active_start_ms = 0;
-    zones_[i].short_cycle_protection = false;
-    zones_[i].enabled = true;
+  // Zones not assigned to another configured unit are served by unit 0
+  uint16_t assigned = 0;
+  for (uint8_t u = 1; u < MAX_UNITS; u++) {
+    if (u >= num_units_) unit_zones_[u] = 0;
+    assigned |= unit_zones_[u];
+  }
+  unit_zones_[0] = static_cast<uint16_t>(~assigned);
+  if (num_units_ > 1) ESP_LOGI(TAG, "%d central units", num_units_);
+
+  // Initialize all configured zones in every unit: state OFF, counters and
+  // timers cleared. enabled_mask_ is left as set by the zone enable
+  // switches, which restore their state before this component's setup().
+  static const char *const UNIT_LABELS[3] = {"", "Unit 2: ", "Unit 3: "};
+  for (uint8_t u = 0; u < num_units_; u++) {
+    cores_[u].reset(num_zones_);
+    cores_[u].events().set_label(UNIT_LABELS[u]);
+#ifdef OPEN_ZONING_STAGE_TIMING
+    cores_[u].set_timings(&timings_);
+#endif
+  }
+  damper_known_ = 0;  // Unknown — forces first update() to drive correct position
+
+  // Damper port: seed the latch shadow from the chip once the gpio switches
+  // (HARDWARE priority) have configured IODIR and applied their restore state.
+  if (damper_port_enabled_) {
+    if (i2c_bus_ == nullptr) {
+      ESP_LOGE(TAG, "damper_port requires i2c_bus — falling back to per-switch damper writes");
+    } else {
+      damper_port_.set_bus(i2c_bus_);
+      damper_port_.sync();
+    }
+  }
+
+  // Output port: seed the latch shadow like the damper port
+  if (output_port_enabled_) {
+    if (i2c_bus_ == nullptr) {
+      ESP_LOGE(TAG, "output_port requires i2c_bus — falling back to per-switch output writes");
+    } else {
+      output_port_.set_bus(i2c_bus_);
+      output_port_.sync();
+    }
+  }
+  setup_output_channels_();
+
+  // Thermostat input ports: mapped pins become inputs with pull-ups
+  if (inputs_.get_num_ports() > 0) {
+    if (i2c_bus_ == nullptr) {
+      ESP_LOGE(TAG, "thermostat_inputs requires i2c_bus — falling back to the binary sensors");
+    } else {
+      inputs_.set_bus(i2c_bus_);
+      inputs_.setup();
+    }
   }
 
   // NOTE: Dampers are NOT driven in setup() — the first update() cycle
   // will determine the correct position based on actual zone demands.
   // This avoids I2C race conditions with MCP23017 during boot.
 
-  // Initialize mode to Arrêt
-  current_mode_ = 0;
-  last_active_mode_ = 0;
-  stage1_start_ms_ = 0;
-
-  // Optimization #5: restore last_active_mode from flash (ensures correct purge
-  // direction even after a reboot that happened during a heating or cooling cycle).
-  last_active_mode_pref_ = global_preferences->make_preference<uint8_t>(
-      fnv1_hash("open_zoning_last_active_mode"));
-  uint8_t stored_mode = 0;
-  if (last_active_mode_pref_.load(&stored_mode) && stored_mode >= 1 && stored_mode <= 2) {
-    last_active_mode_ = stored_mode;
-    ESP_LOGI(TAG, "Opt#5: restored last_active_mode=%d (%s) from flash",
-             last_active_mode_, last_active_mode_ == 1 ? "heating" : "cooling");
+  // Initialize every unit's mode to Arrêt
+  for (auto &mode : applied_mode_) mode = 0;
+  select_pending_ = false;
+  select_mode_ = NO_MODE;
+
+  // Optimizations #5 / #27: restore the persisted state from the journal
+  // (last_active_mode ensures the correct purge direction even after a
+  // reboot that happened during a heating or cooling cycle).
+  PersistedState stored;
+  if (journal_.load(&stored)) {
+    ESP_LOGI(TAG, "Restored state record %u: last_active_mode=%d, %u mode changes", journal_.get_sequence(),
+             stored.last_active_mode, stored.mode_changes);
   } else {
-    ESP_LOGD(TAG, "Opt#5: no valid last_active_mode in flash — defaulting to 0 (unknown)");
-  }
+    // Firmware from before the journal: one uint8_t preference
+    ESPPreferenceObject legacy = global_preferences->make_preference<uint8_t>(
+        fnv1_hash("open_zoning_last_active_mode"));
+    uint8_t mode = 0;
+    if (legacy.load(&mode)) stored.last_active_mode = mode;
+    ESP_LOGD(TAG, "No state record in flash — last_active_mode=%d", stored.last_active_mode);
+  }
+  // Purge direction: 2 bits per unit, unit 0 in the low bits (the layout of
+  // a single-unit record); the mode change count is the units' sum
+  uint8_t directions = 0;
+  for (uint8_t u = 0; u < num_units_; u++) {
+    uint8_t direction = (stored.last_active_mode >> (2 * u)) & 0x03;
+    if (direction > 2) direction = 0;
+    cores_[u].set_last_active_mode(direction);
+    directions |= direction << (2 * u);
+  }
+  stored.last_active_mode = directions;
+  cores_[0].set_mode_change_count(stored.mode_changes);
+  journal_.update(stored, now_());  // a migrated legacy value goes out at the first commit
 
   // Publish initial "Off" state to all text sensors
   for (uint8_t i = 0; i < num_zones_; i++) {
     if (zones_[i].state_sensor) {
-      zones_[i].state_sensor->publish_state("Off");
+      zones_[i].state_sensor->publish_state(state_text(ZoneState::OFF));
     }
   }
 
@@ -189,93 +175,352 @@ void OpenZoningController::setup() {
   if (i2c_health_sensor_) {
     i2c_health_sensor_->publish_state(true);
   }
+
+  // Input ports: the binary sensors are mirrors, start them at the
+  // debounced level (all inputs off until their first debounce window)
+  if (inputs_.is_configured()) {
+    publish_input_mirrors_(~0u, 0);
+  }
+
+  // Event-driven mode: any thermostat input edge schedules a coalesced run
+  // (input ports mark the controller dirty from sample_inputs_() instead)
+  if (event_driven_ && !inputs_.is_configured()) {
+    for (uint8_t i = 0; i < num_zones_; i++) {
+      ZoneEntities &z = zones_[i];
+      binary_sensor::BinarySensor *inputs[4] = {z.y1, z.y2, z.g, z.ob};
+      for (auto *bs : inputs) {
+        if (bs) bs->add_on_state_callback([this](bool) { this->mark_dirty_(); });
+      }
+    }
+  }
+}
+
+void OpenZoningController::mark_dirty_() {
+  dirty_ = true;
+  if (event_eval_scheduled_) return;  // a run is already pending — coalesce
+
+  // Fixed (non-restarting) timeout: the first edge bounds the latency, later
+  // edges in the same window are absorbed into that one run.
+  event_eval_scheduled_ = true;
+  this->set_timeout("event_eval", event_latency_ms_, [this]() {
+    event_eval_scheduled_ = false;
+    if (!dirty_) return;
+    event_runs_++;
+    run_pipeline_(false);
+  });
 }
 
 void OpenZoningController::update() {
+#ifdef OPEN_ZONING_ALLOC_MONITOR
+  publish_alloc_monitor_();  // before the scope: its own publishes are not counted
+#endif
+  OZ_ALLOC_SCOPE();
   if (num_zones_ == 0) {
     ESP_LOGW(TAG, "No zones configured — skipping update");
     return;
   }
+  run_pipeline_(true);
+  publish_runtime_();
+#ifdef OPEN_ZONING_STAGE_TIMING
+  publish_stage_timings_();
+#endif
+}
+
+void OpenZoningController::run_pipeline_(bool periodic) {
+  if (num_zones_ == 0) return;
+  OZ_ALLOC_SCOPE();  // also the runs of the scheduler (events, deadlines)
+  OZ_TIME_STAGE(&timings_, Stage::PIPELINE);
+  dirty_ = false;
+
+  // One clock sample per cycle: every pass sees the same "now"
+  now_ms_ = now_();
 
   // I2C watchdog: probe MCP23017 before any I2C operations
-  check_i2c_health_();
+  // (periodic runs only — event bursts must not multiply the probe traffic)
+  if (periodic) check_i2c_health_();
+
+  // Execute PASS 1–5 and commit new states, once per unit over its own
+  // zones (one input read for all; a settled unit costs one comparison)
+  const CoreInput in = read_inputs_();
+  int max_priority = 0;
+  bool error = false;
+  for (uint8_t u = 0; u < num_units_; u++) {
+    CoreInput unit_in = in;
+    unit_in.enabled &= unit_zones_[u];
+    cores_[u].evaluate(unit_in, now_ms_, periodic);
+    if (cores_[u].get_global_max_priority() > max_priority) max_priority = cores_[u].get_global_max_priority();
+    error = error || cores_[u].has_zone_error();
+  }
+  schedule_deadline_();
+
+  // Apply PASS 4–5 results to the hardware (pre-positioned dampers stay
+  // open until the core confirms or the raw call goes away)
+  apply_dampers_(core_dampers_() | update_preposition_());
+  apply_outputs_();
+  persist_state_();
 
-  // Execute PASS 1–3
-  pass1_calc_zone_states_();
-  pass1_5_short_cycle_protection_();
-  pass2_purge_management_();
-  pass2_5_minimum_demand_();
-  pass3_priority_analysis_();
+  // Log summary at debug level
+  cores_[0].events().push(now_ms_, Event::CYCLE_DONE, EventLog::NO_ZONE, max_priority,
+                          (periodic ? 2 : 0) | (error ? 1 : 0));
+
+  // Publish changed zone states and the diagnostic sensors (optimization #3)
+  // to Home Assistant
+  {
+    OZ_TIME_STAGE(&timings_, Stage::PUBLISH);
+    publish_zone_states_();
+    publish_diagnostics_();
+  }
+}
 
-  // Execute PASS 4–5
-  pass4_damper_control_();
-  pass5_output_control_();
+// Timer-driven transitions (purge end, minimum cycle end, stage 2, demand
+// override) run at their deadline instead of the next poll: one named
+// timeout, armed at the core's earliest deadline and moved only when that
+// deadline changes.
+void OpenZoningController::schedule_deadline_() {
+  uint32_t at = 0;
+  bool armed = false;
+  for (uint8_t u = 0; u < num_units_; u++) {
+    uint32_t unit_at;
+    if (!cores_[u].next_deadline(now_ms_, &unit_at)) continue;
+    if (!armed || time_until(now_ms_, unit_at) < time_until(now_ms_, at)) at = unit_at;
+    armed = true;
+  }
+  if (armed == deadline_armed_ && (!armed || at == deadline_ms_)) return;  // already scheduled
+  deadline_armed_ = armed;
+  deadline_ms_ = at;
+  if (!armed) {
+    this->cancel_timeout("deadline");
+    return;
+  }
+  this->set_timeout("deadline", time_until(now_ms_, at), [this]() {
+    deadline_armed_ = false;
+    deadline_runs_++;
+    run_pipeline_(false);
+  });
+}
 
-  // Commit new states and log changes
+// Damper targets of every unit, each over its own zones
+uint16_t OpenZoningController::core_dampers_() const {
+  uint16_t dampers = 0;
+  for (uint8_t u = 0; u < num_units_; u++) dampers |= cores_[u].get_output().dampers & unit_zones_[u];
+  return dampers;
+}
+
+// Pack the thermostat entities into the core's input word (one nibble per zone)
+CoreInput OpenZoningController::read_inputs_() const {
+  CoreInput in;
+  in.enabled = enabled_mask_;
+  in.ob_on_heat = ob_on_heat_mask_;
+  if (inputs_.is_configured()) {
+    in.thermostats = inputs_.get_state();  // already debounced by loop()
+    return in;
+  }
   for (uint8_t i = 0; i < num_zones_; i++) {
-    if (zones_[i].state != zones_[i].state_new) {
-      ESP_LOGI(TAG, "Zone %d: %s -> %s",
-               i + 1,
-               state_to_string(zones_[i].state),
-               state_to_string(zones_[i].state_new));
-      // Publish to text sensor for HA dashboard
-      if (zones_[i].state_sensor) {
-        zones_[i].state_sensor->publish_state(state_to_string(zones_[i].state_new));
-      }
+    const ZoneEntities &z = zones_[i];
+    InputWord bits = 0;
+    if (z.y1 && z.y1->state) bits |= ControlCore::IN_Y1;
+    if (z.y2 && z.y2->state) bits |= ControlCore::IN_Y2;
+    if (z.g && z.g->state) bits |= ControlCore::IN_G;
+    if (z.ob && z.ob->state) bits |= ControlCore::IN_OB;
+    in.thermostats |= bits << (4 * i);
+  }
+  return in;
+}
+
+// ============================================================================
+// Thermostat input ports — one GPIO read per expander per sample
+// ============================================================================
+void OpenZoningController::sample_inputs_() {
+  const uint32_t now = now_();
+  if (!time_reached(now, input_next_sample_ms_)) return;
+  input_next_sample_ms_ = now + input_sample_ms_;
+  OZ_TIME_STAGE(&timings_, Stage::INPUT_SAMPLE);
+
+  const InputWord previous = inputs_.get_state();
+  const bool changed = inputs_.sample(now);
+
+  if (preposition_) {
+    const uint16_t before = prepositioned_;
+    const uint16_t early = update_preposition_();
+    if (early != before) {
+      now_ms_ = now;  // the motor plan starts from this sample
+      apply_dampers_(core_dampers_() | early);
     }
-    zones_[i].state = zones_[i].state_new;
   }
+  if (!changed) return;
 
-  // Log summary at debug level
-  ESP_LOGD(TAG, "Update cycle complete — max_priority=%d error_flag=%s",
-           global_max_priority_, zone_error_flag_ ? "YES" : "no");
+  publish_input_mirrors_(previous, inputs_.get_state());
+  if (event_driven_) mark_dirty_();
+}
 
-  // Optimization #3: publish diagnostic sensors to Home Assistant
-  publish_diagnostics_();
+// Zones whose raw call predicts an opening the core has not made yet. A zone
+// leaves the set when the core's own damper target opens it (confirmed), or
+// when the prediction goes away first (glitch, call shorter than the
+// debounce, priority changed): its damper is then closed again.
+uint16_t OpenZoningController::update_preposition_() {
+  if (!preposition_ || !inputs_.is_configured() || damper_known_ == 0) return 0;
+  uint16_t predicted = 0;
+  for (uint8_t u = 0; u < num_units_; u++)
+    predicted |= cores_[u].preposition_dampers(inputs_.get_raw()) & unit_zones_[u];
+  const uint16_t confirmed = core_dampers_();
+  const uint16_t added = predicted & ~prepositioned_ & ~damper_open_;
+  const uint16_t rolled_back = prepositioned_ & ~predicted & ~confirmed;
+
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    const uint16_t bit = static_cast<uint16_t>(1u << i);
+    // In the ring of the zone's unit, under that unit's label
+    if (added & bit) {
+      prepositions_++;
+      cores_[unit_of_(i)].events().push(now_(), Event::DAMPER_PREPOSITION, i, 0);
+    } else if (rolled_back & bit) {
+      preposition_rollbacks_++;
+      cores_[unit_of_(i)].events().push(now_(), Event::DAMPER_PREPOSITION, i, 1);
+    }
+  }
+  prepositioned_ = static_cast<uint16_t>((prepositioned_ | added) & predicted & ~confirmed);
+  return prepositioned_;
+}
+
+// Publish the mirror binary sensors of the inputs that changed
+void OpenZoningController::publish_input_mirrors_(InputWord previous, InputWord current) {
+  const InputWord changed = previous ^ current;
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    const uint8_t nibble = (changed >> (4 * i)) & 0x0F;
+    if (nibble == 0) continue;
+    const uint8_t bits = (current >> (4 * i)) & 0x0F;
+    ZoneEntities &z = zones_[i];
+    binary_sensor::BinarySensor *mirrors[4] = {z.y1, z.y2, z.g, z.ob};  // ControlCore::IN_* order
+    for (uint8_t k = 0; k < 4; k++) {
+      if ((nibble & (1u << k)) && mirrors[k]) mirrors[k]->publish_state(bits & (1u << k));
+    }
+  }
+}
+
+void OpenZoningController::publish_zone_states_() {
+  for (uint8_t u = 0; u < num_units_; u++) {
+    const uint16_t changed = cores_[u].get_changed_zones() & unit_zones_[u];
+    if (changed == 0) continue;
+    for (uint8_t i = 0; i < num_zones_; i++) {
+      if ((changed & (1u << i)) && zones_[i].state_sensor) {
+        zones_[i].state_sensor->publish_state(state_text(cores_[u].zone_state(i)));
+      }
+    }
+  }
 }
 
 void OpenZoningController::loop() {
-  // Process damper operation queue — one I2C write per loop iteration.
-  // This mimics how old ESPHome scripts worked: yield between each GPIO write,
-  // preventing MCP23017 I2C corruption on ESP8266 (bit-banged I2C + WiFi IRQs).
-  if (dq_pos_ >= dq_count_) return;  // nothing pending
-
-  if (millis() < dq_next_ms_) return;  // waiting for delay
-
-  // Execute current operation
-  DamperOp &op = damper_ops_[dq_pos_];
-  if (op.sw) {
-    if (op.turn_on) {
-      op.sw->turn_on();
+  OZ_ALLOC_SCOPE();
+  // Events recorded by the last pipeline run: formatted here, a few per
+  // iteration, instead of inside the passes
+  for (uint8_t u = 0; u < num_units_; u++) {
+    EventLog &events = cores_[u].events();
+    if (events.pending() == 0) continue;
+    if (event_log_live_) {
+      events.drain(EVENT_DRAIN_PER_LOOP);
     } else {
-      op.sw->turn_off();
+      events.discard();  // kept in the ring for dump_event_log()
     }
   }
 
-  dq_pos_++;
+  if (inputs_.is_configured()) sample_inputs_();
+
+  if (output_port_.is_dirty()) output_port_.flush();  // retry a failed output write
+
+  if (damper_port_.is_dirty()) damper_port_.flush();  // retry a failed LED write
 
-  // Schedule next operation
-  if (dq_pos_ < dq_count_) {
-    dq_next_ms_ = millis() + damper_ops_[dq_pos_].delay_ms;
+  // Mode select: synced after the pipeline run has written the outputs
+  if (select_pending_) sync_mode_select_();
+
+  // Damper motion — one I2C write per loop iteration. This mimics how the old
+  // ESPHome scripts worked: yield between each GPIO write, preventing
+  // MCP23017 I2C corruption on ESP8266 (bit-banged I2C + WiFi IRQs).
+  if (dampers_.idle()) return;  // nothing pending
+  dampers_.expire(now_());
+  if (damper_port_.is_configured()) {
+    process_damper_port_();
   } else {
-    ESP_LOGD(TAG, "Damper queue complete (%d ops processed)", dq_count_);
+    process_damper_switches_();
   }
 }
 
 void OpenZoningController::dump_config() {
   ESP_LOGCONFIG(TAG, "OpenZoning Controller:");
   ESP_LOGCONFIG(TAG, "  Update interval: %.1fs", this->get_update_interval() / 1000.0f);
+  if (event_driven_)
+    ESP_LOGCONFIG(TAG, "  Event-driven: YES (latency: %u ms)", event_latency_ms_);
+  else
+    ESP_LOGCONFIG(TAG, "  Event-driven: NO");
   ESP_LOGCONFIG(TAG, "  Zones configured: %d", num_zones_);
-  ESP_LOGCONFIG(TAG, "  Min cycle time: %u ms", min_cycle_time_ms_);
-  ESP_LOGCONFIG(TAG, "  Purge duration: %u ms", purge_duration_ms_);
-  ESP_LOGCONFIG(TAG, "  Stage 2 escalation: %u ms", stage2_escalation_ms_);
-  ESP_LOGCONFIG(TAG, "  Auto mode: %s", auto_mode_ ? "YES" : "NO");
-  ESP_LOGCONFIG(TAG, "  Min active zones: %d%s", min_active_zones_,
-                min_active_zones_ <= 1 ? " (disabled)" : "");
-  if (min_active_zones_ > 1)
-    ESP_LOGCONFIG(TAG, "  Min demand override: %u ms", min_demand_override_ms_);
-  ESP_LOGCONFIG(TAG, "  I2C watchdog: %s (threshold: %d errors)",
-                i2c_bus_ ? "ENABLED" : "DISABLED", i2c_error_threshold_);
+  const ControlCore &core = cores_[0];  // same settings in every unit
+  ESP_LOGCONFIG(TAG, "  Min cycle time: %u ms", core.get_min_cycle_time_ms());
+  ESP_LOGCONFIG(TAG, "  Purge duration: %u ms", core.get_purge_duration_ms());
+  ESP_LOGCONFIG(TAG, "  Stage 2 escalation: %u ms", core.get_stage2_escalation_ms());
+  ESP_LOGCONFIG(TAG, "  Auto mode: %s", core.get_auto_mode() ? "YES" : "NO");
+  ESP_LOGCONFIG(TAG, "  State journal: %d slot(s), every %u ms, %u record(s) written (last: %u)",
+                journal_.get_slots(), journal_.get_commit_interval(), journal_.get_commits(),
+                journal_.get_sequence());
+  for (uint8_t u = 0; u < num_units_; u++) {
+    ESP_LOGCONFIG(TAG, "  Central unit %d: zones 0x%04X, evaluations skipped (settled): %u", u + 1,
+                  unit_zones_[u] & ((1u << num_zones_) - 1), cores_[u].get_skipped_evaluations());
+    const RuntimeStats &rt = cores_[u].get_runtime();
+    for (uint8_t m = 0; m < RuntimeStats::NUM_MODES; m++) {
+      if (rt.mode_entries(m) == 0) continue;
+      ESP_LOGCONFIG(TAG, "    Runtime %s: %.2f h, %u start(s)", ControlCore::mode_to_string(m),
+                    rt.mode_ms(m, now_()) / 3600000.0f, rt.mode_entries(m));
+    }
+  }
+  ESP_LOGCONFIG(TAG, "  Min active zones: %d%s", core.get_min_active_zones(),
+                core.get_min_active_zones() <= 1 ? " (disabled)" : "");
+  if (core.get_min_active_zones() > 1)
+    ESP_LOGCONFIG(TAG, "  Min demand override: %u ms", core.get_min_demand_override_ms());
+  ESP_LOGCONFIG(TAG, "  Damper policy: dwell %u ms, idle hold %s, close lookahead %u ms",
+                core.get_damper_min_dwell_ms(), core.get_damper_idle_hold() ? "YES" : "NO",
+                core.get_damper_close_lookahead_ms());
+  if (damper_port_.is_configured()) {
+    ESP_LOGCONFIG(TAG, "  Damper port: MCP23017@0x%02X%s (batched OLAT writes)",
+                  damper_port_.get_address(), damper_port_.is_inverted() ? " inverted" : "");
+  } else {
+    ESP_LOGCONFIG(TAG, "  Damper port: DISABLED (per-switch writes)");
+  }
+  if (dampers_.get_max_moving() > 0) {
+    ESP_LOGCONFIG(TAG, "  Damper motion: concurrent, max %d motor(s) per %u ms inrush window",
+                  dampers_.get_max_moving(), dampers_.get_inrush_window_ms());
+  } else {
+    ESP_LOGCONFIG(TAG, "  Damper motion: concurrent, no cap");
+  }
+  if (output_port_.is_configured()) {
+    ESP_LOGCONFIG(TAG, "  Output port: MCP23017@0x%02X%s (batched OLAT writes)",
+                  output_port_.get_address(), output_port_.is_inverted() ? " inverted" : "");
+  } else {
+    ESP_LOGCONFIG(TAG, "  Output port: DISABLED (per-switch writes)");
+  }
+  if (inputs_.is_configured()) {
+    ESP_LOGCONFIG(TAG, "  Thermostat inputs: %d port(s), sampled every %u ms, debounce %u ms",
+                  inputs_.get_num_ports(), input_sample_ms_, inputs_.get_debounce_ms());
+    if (preposition_) ESP_LOGCONFIG(TAG, "    Damper pre-positioning on raw call edges");
+    for (uint8_t p = 0; p < inputs_.get_num_ports(); p++)
+      ESP_LOGCONFIG(TAG, "    Port %d: MCP23017@0x%02X%s", p, inputs_.port(p).get_address(),
+                    inputs_.port(p).is_inverted() ? " inverted" : "");
+  } else {
+    ESP_LOGCONFIG(TAG, "  Thermostat inputs: binary sensors");
+  }
+  static const char *const DIAG_NAMES[NUM_DIAGNOSTICS] = {"active zones", "stage 1 elapsed", "mode changes",
+                                                           "short cycle"};
+  for (uint8_t d = 0; d < NUM_DIAGNOSTICS; d++) {
+    const PublishPolicy &p = diag_gates_[d].get_policy();
+    ESP_LOGCONFIG(TAG, "  Publish %s: on change, min %u ms, max %u ms, deadband %.1f", DIAG_NAMES[d],
+                  p.min_interval_ms, p.max_interval_ms, p.deadband);
+  }
+  ESP_LOGCONFIG(TAG, "  I2C watchdog: %s (threshold: %d errors, traffic window: %u ms)",
+                i2c_bus_ ? "ENABLED" : "DISABLED", i2c_error_threshold_, i2c_traffic_window_ms_);
+  if (i2c_bus_) {
+    for (uint8_t k = 0; k < i2c_num_watched_; k++)
+      ESP_LOGCONFIG(TAG, "    Watching MCP23017@0x%02X%s", i2c_watched_[k],
+                    i2c_reboot_[k] ? " (reboots when stuck)" : "");
+    ESP_LOGCONFIG(TAG, "    Probes skipped (recent traffic): %u", i2c_probes_skipped_);
+    ESP_LOGCONFIG(TAG, "  I2C traffic (latency µs: <64 <128 <256 <512 <1k <2k <4k >=4k):");
+    i2c_meter_.dump();
+  }
   if (i2c_health_sensor_)
     ESP_LOGCONFIG(TAG, "  I2C health sensor: %s", i2c_health_sensor_->get_name().c_str());
   for (uint8_t i = 0; i < num_zones_; i++) {
@@ -287,477 +532,306 @@ void OpenZoningController::dump_config() {
     ESP_LOGCONFIG(TAG, "    Damper Open:  %s", zones_[i].damper_open_sw  ? zones_[i].damper_open_sw->get_name().c_str()  : "NOT SET");
     ESP_LOGCONFIG(TAG, "    Damper Close: %s", zones_[i].damper_close_sw ? zones_[i].damper_close_sw->get_name().c_str() : "NOT SET");
   }
-  ESP_LOGCONFIG(TAG, "  Outputs:");
-  ESP_LOGCONFIG(TAG, "    Y1:  %s", out_y1_  ? out_y1_->get_name().c_str()  : "NOT SET");
-  ESP_LOGCONFIG(TAG, "    Y2:  %s", out_y2_  ? out_y2_->get_name().c_str()  : "NOT SET");
-  ESP_LOGCONFIG(TAG, "    G:   %s", out_g_   ? out_g_->get_name().c_str()   : "NOT SET");
-  ESP_LOGCONFIG(TAG, "    OB:  %s", out_ob_  ? out_ob_->get_name().c_str()  : "NOT SET");
-  ESP_LOGCONFIG(TAG, "    W1e: %s", out_w1e_ ? out_w1e_->get_name().c_str() : "NOT SET");
-  ESP_LOGCONFIG(TAG, "    W2:  %s", out_w2_  ? out_w2_->get_name().c_str()  : "NOT SET");
-  ESP_LOGCONFIG(TAG, "    W3:  %s", out_w3_  ? out_w3_->get_name().c_str()  : "NOT SET");
+  static const char *const OUTPUT_NAMES[NUM_UNIT_OUTPUTS] = {"Y1: ", "Y2: ", "G:  ", "OB: ", "W1e:", "W2: ", "W3: "};
+  for (uint8_t u = 0; u < num_units_; u++) {
+    ESP_LOGCONFIG(TAG, "  Outputs (central unit %d):", u + 1);
+    for (uint8_t k = 0; k < NUM_UNIT_OUTPUTS; k++) {
+      const switch_::Switch *sw = unit_out_[u][k];
+      ESP_LOGCONFIG(TAG, "    %s %s", OUTPUT_NAMES[k], sw ? sw->get_name().c_str() : "NOT SET");
+    }
+  }
   ESP_LOGCONFIG(TAG, "  LEDs:");
   ESP_LOGCONFIG(TAG, "    Heat:  %s", led_heat_  ? led_heat_->get_name().c_str()  : "NOT SET");
   ESP_LOGCONFIG(TAG, "    Cool:  %s", led_cool_  ? led_cool_->get_name().c_str()  : "NOT SET");
   ESP_LOGCONFIG(TAG, "    Fan:   %s", led_fan_   ? led_fan_->get_name().c_str()   : "NOT SET");
   ESP_LOGCONFIG(TAG, "    Error: %s", led_error_ ? led_error_->get_name().c_str() : "NOT SET");
   ESP_LOGCONFIG(TAG, "  Mode select: %s", mode_select_ ? mode_select_->get_name().c_str() : "NOT SET");
+#ifdef OPEN_ZONING_STAGE_TIMING
+  timings_.dump();
+#endif
+#ifdef OPEN_ZONING_ALLOC_MONITOR
+  ESP_LOGCONFIG(TAG, "  Allocation monitor: every %u ms", alloc_publish_ms_);
+#endif
 }
 
 // ============================================================================
-// PASS 1: Zone State Calculation
+// PASS 4 application: damper targets → motor sequences
 // ============================================================================
-void OpenZoningController::pass1_calc_zone_states_() {
-  zone_error_flag_ = false;
+void OpenZoningController::apply_dampers_(uint16_t targets) {
+  OZ_TIME_STAGE(&timings_, Stage::APPLY_DAMPERS);
+  // A plan still in flight is merged: its motors keep their progress and
+  // only the zones whose target changed are (re)planned
+  const uint16_t in_flight = dampers_.in_flight();
+  uint8_t planned = 0;
 
   for (uint8_t i = 0; i < num_zones_; i++) {
-    if (!zones_[i].enabled)
-      continue;
+    const uint16_t bit = static_cast<uint16_t>(1u << i);
+    const bool open = targets & bit;
 
-    bool error = zones_[i].calc_state();
-    if (error) {
-      zone_error_flag_ = true;
-    }
-  }
-}
-
-// ============================================================================
-// PASS 1.5: Short Cycle Protection
-// ============================================================================
-void OpenZoningController::pass1_5_short_cycle_protection_() {
-  unsigned long current_time = millis();
+    // Plan damper change if needed
+    if ((damper_known_ & bit) && ((damper_open_ & bit) != 0) == open) continue;
+    damper_known_ |= bit;
 
-  for (uint8_t i = 0; i < num_zones_; i++) {
-    if (!zones_[i].enabled)
+    if (open) {
+      damper_open_ |= bit;
+      cores_[0].events().push(now_ms_, Event::DAMPER_OPEN, i);
+    } else {
+      damper_open_ &= static_cast<uint16_t>(~bit);
+      cores_[0].events().push(now_ms_, Event::DAMPER_CLOSE, i, (enabled_mask_ & bit) ? 0 : 1);
+    }
+    // Zones without motor outputs are only tracked
+    const ZoneEntities &z = zones_[i];
+    if (damper_port_.is_configured() ? z.damper_open_pin == McpPort::NO_PIN || z.damper_close_pin == McpPort::NO_PIN
+                                     : !z.damper_open_sw || !z.damper_close_sw)
       continue;
+    dampers_.plan(i, open, now_ms_);
+    planned++;
+  }
 
-    zones_[i].apply_short_cycle_protection(current_time, min_cycle_time_ms_);
+  if (planned == 0) return;
+  if (in_flight != 0) {
+    cores_[0].events().push(now_ms_, Event::DAMPER_MERGED, EventLog::NO_ZONE, planned, __builtin_popcount(in_flight));
+  } else {
+    dampers_moved_ = 0;
+    cores_[0].events().push(now_ms_, Event::DAMPER_QUEUED, EventLog::NO_ZONE, planned);
   }
 }
 
 // ============================================================================
-// PASS 2: Intelligent Multi-Zone Purge Management
+// Damper switches — one switch write per loop(), stops before engages:
+//   1. Turn off opposite direction
+//   2. Turn off same direction (50ms after step 1)
+//   3. Engage target direction (250ms after step 2 — motor release delay)
+// Every zone runs these steps concurrently (replaces the 12 ESPHome scripts
+// and the serial queue that followed them).
 // ============================================================================
-void OpenZoningController::pass2_purge_management_() {
-  unsigned long now_ms = millis();
-
-  // Count how many zones are CURRENTLY (in new state) heating or cooling
-  int heating_zones_count = 0;
-  int cooling_zones_count = 0;
-
-  for (uint8_t i = 0; i < num_zones_; i++) {
-    if (!zones_[i].enabled)
-      continue;
-    if (zones_[i].is_heating()) heating_zones_count++;
-    if (zones_[i].is_cooling()) cooling_zones_count++;
-  }
-
-  // Apply purge logic to each zone
-  for (uint8_t i = 0; i < num_zones_; i++) {
-    if (!zones_[i].enabled)
-      continue;
-
-    Zone &z = zones_[i];
-
-    // Check transition: was active, now wants to stop
-    if ((z.was_heating() || z.was_cooling()) && !z.is_heating() && !z.is_cooling()
-        && z.state_new != ZoneState::ERROR) {
-
-      // Check minimum cycle time before allowing purge
-      unsigned long elapsed = (z.active_start_ms > 0) ? (now_ms - z.active_start_ms) : min_cycle_time_ms_;
-      if (z.active_start_ms > 0 && elapsed < min_cycle_time_ms_) {
-        z.state_new = z.state;  // Hold in previous state
-        z.short_cycle_protection = true;
-        ESP_LOGW(TAG, "Zone %d prevented from entering purge - minimum cycle time not met", i + 1);
-      } else {
-        // Check if other zones of the same type are still active
-        bool other_zones_active = false;
-        if (z.was_heating() && heating_zones_count > 0) other_zones_active = true;
-        if (z.was_cooling() && cooling_zones_count > 0) other_zones_active = true;
-
-        if (other_zones_active) {
-          // Other zones still running — skip purge, go OFF
-          z.purge_end_ms = 0;
-          z.state_new = ZoneState::OFF;
-        } else {
-          // Last zone to stop — start purge timer
-          z.purge_end_ms = now_ms + purge_duration_ms_;
-          ESP_LOGI(TAG, "Zone %d starting purge (duration: %u ms)", i + 1, purge_duration_ms_);
-        }
-      }
-    }
-
-    // Manage active purge timer
-    if (z.purge_end_ms > now_ms && z.state_new != ZoneState::ERROR) {
-      z.state_new = ZoneState::PURGE;
-    } else if (z.purge_end_ms <= now_ms && z.purge_end_ms != 0) {
-      z.purge_end_ms = 0;
-      ESP_LOGI(TAG, "Zone %d purge complete", i + 1);
+void OpenZoningController::process_damper_switches_() {
+  const uint32_t now = now_();
+  const DamperScheduler::Phase order[3] = {DamperScheduler::STOP_OPPOSITE, DamperScheduler::STOP_SAME,
+                                           DamperScheduler::RELEASE};
+  for (const auto phase : order) {
+    const uint16_t due = dampers_.due(phase, now);
+    if (due == 0) continue;
+    const uint8_t i = __builtin_ctz(due);
+    OZ_TIME_STAGE(&timings_, Stage::DAMPER_OP);
+    ZoneEntities &z = zones_[i];
+    const bool open = dampers_.target_open(i);
+    switch_::Switch *target = open ? z.damper_open_sw : z.damper_close_sw;
+    switch_::Switch *opposite = open ? z.damper_close_sw : z.damper_open_sw;
+    if (phase == DamperScheduler::STOP_OPPOSITE) {
+      opposite->turn_off();
+    } else if (phase == DamperScheduler::STOP_SAME) {
+      target->turn_off();
+    } else {
+      target->turn_on();
+      dampers_moved_++;
     }
+    dampers_.advance(static_cast<uint16_t>(1u << i), now);
+    break;
   }
+  finish_damper_plan_();
 }
 
 // ============================================================================
-// PASS 3: Priority Analysis and Wait States
+// Damper port — batched OLAT writes (replaces the switch writes when
+// damper_port is configured). Same motor timing:
+//   1. One write releases both coils of every zone due to stop
+//   2. 250ms later (motor release delay), one write engages every due target
 // ============================================================================
-void OpenZoningController::pass3_priority_analysis_() {
-  // Calculate global maximum priority
-  global_max_priority_ = 0;
-
-  for (uint8_t i = 0; i < num_zones_; i++) {
-    if (!zones_[i].enabled)
-      continue;
+void OpenZoningController::process_damper_port_() {
+  const uint32_t now = now_();
+  const uint16_t to_stop = dampers_.due(DamperScheduler::STOP_OPPOSITE, now) |
+                           dampers_.due(DamperScheduler::STOP_SAME, now);
+  if (to_stop != 0) {
+    OZ_TIME_STAGE(&timings_, Stage::DAMPER_OP);
+    // Fresh plan: re-read the latch so the shadow reflects the chip
+    if (dampers_.in_flight() == to_stop && !damper_port_.is_dirty()) damper_port_.sync();
 
-    int p = zones_[i].get_priority();
-    if (p > global_max_priority_) {
-      global_max_priority_ = p;
+    for (uint8_t i = 0; i < num_zones_; i++) {
+      if (!(to_stop & (1u << i))) continue;
+      damper_port_.set(zones_[i].damper_open_pin, false);
+      damper_port_.set(zones_[i].damper_close_pin, false);
     }
+    if (!damper_port_.flush()) return;  // retried on next loop()
+    dampers_.released(to_stop, now);
+    return;
   }
 
-  // Apply WAIT state to zones with lower priority (but not OFF or ERROR)
-  for (uint8_t i = 0; i < num_zones_; i++) {
-    if (!zones_[i].enabled)
-      continue;
+  const uint16_t to_engage = dampers_.due(DamperScheduler::RELEASE, now);
+  if (to_engage == 0) return;  // motor release delay, or no free motion slot
+  OZ_TIME_STAGE(&timings_, Stage::DAMPER_OP);
 
-    int p = zones_[i].get_priority();
-    if (p > 0 && p < global_max_priority_ && zones_[i].state_new != ZoneState::ERROR) {
-      zones_[i].state_new = ZoneState::WAIT;
-    }
-  }
-}
-
-// ============================================================================
-// PASS 4: Damper Control
-// ============================================================================
-void OpenZoningController::pass4_damper_control_() {
-  // Abort any pending damper queue from previous cycle
-  if (dq_pos_ < dq_count_) {
-    ESP_LOGW(TAG, "Damper queue interrupted — %d/%d ops were pending",
-             dq_count_ - dq_pos_, dq_count_);
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    if (!(to_engage & (1u << i))) continue;
+    const bool open = dampers_.target_open(i);
+    damper_port_.set(zones_[i].damper_open_pin, open);
+    damper_port_.set(zones_[i].damper_close_pin, !open);
   }
-  dq_count_ = 0;
-  dq_pos_ = 0;
-
-  bool all_zones_off = (global_max_priority_ == 0);
+  if (!damper_port_.flush()) return;  // retried on next loop()
+  dampers_.advance(to_engage, now);
 
+  // Mirror the latch into the (internal) switch entities for HA
+  uint8_t moved = 0;
   for (uint8_t i = 0; i < num_zones_; i++) {
-    Zone &z = zones_[i];
-
-    // Disabled zones: force OFF, close damper
-    if (!z.enabled) {
-      z.state_new = ZoneState::OFF;
-      if (z.damper_state != 0) {
-        z.damper_state = 0;
-        ESP_LOGI(TAG, "Zone %d disabled — damper -> CLOSE", i + 1);
-        queue_close_damper_(i);
-      }
-      continue;
-    }
-
-    // Determine target damper position
-    uint8_t damper_target = 1;  // Default: open
-    if (z.state_new == ZoneState::WAIT || z.state_new == ZoneState::ERROR) {
-      damper_target = 0;  // Close for WAIT and ERROR
-    } else if (all_zones_off) {
-      damper_target = 1;  // All zones off: keep all dampers open
-    } else if (z.state_new == ZoneState::OFF) {
-      damper_target = 0;  // Zone off while others active: close
-    } else {
-      damper_target = 1;  // Active zone: open
-    }
-
-    // Queue damper change if needed
-    if (damper_target != z.damper_state) {
-      z.damper_state = damper_target;
-      if (damper_target == 1) {
-        ESP_LOGI(TAG, "Zone %d damper -> OPEN", i + 1);
-        queue_open_damper_(i);
-      } else {
-        ESP_LOGI(TAG, "Zone %d damper -> CLOSE", i + 1);
-        queue_close_damper_(i);
-      }
-    }
-  }
+    if (!(to_engage & (1u << i))) continue;
+    ZoneEntities &z = zones_[i];
+    const bool open = dampers_.target_open(i);
+    if (z.damper_open_sw) z.damper_open_sw->publish_state(open);
+    if (z.damper_close_sw) z.damper_close_sw->publish_state(!open);
+    moved++;
+  }
+  dampers_moved_ += moved;
+  cores_[0].events().push(now, Event::DAMPER_ENGAGED, EventLog::NO_ZONE, moved);
+  finish_damper_plan_();
+}
 
-  // Start processing queue
-  if (dq_count_ > 0) {
-    dq_next_ms_ = millis() + damper_ops_[0].delay_ms;
-    ESP_LOGI(TAG, "Damper queue: %d ops scheduled", dq_count_);
-  }
+void OpenZoningController::finish_damper_plan_() {
+  if (dampers_moved_ == 0 || dampers_.in_flight() != 0) return;
+  cores_[0].events().push(now_(), Event::DAMPER_QUEUE_DONE, EventLog::NO_ZONE, dampers_moved_);
+  dampers_moved_ = 0;
 }
 
 // ============================================================================
-// Damper queue methods — replaces the 12 ESPHome scripts
-// Each damper change is decomposed into 3 individual GPIO writes:
-//   1. Turn off opposite direction (50ms gap between zones)
-//   2. Turn off same direction (50ms after step 1)
-//   3. Engage target direction (250ms after step 2 — motor release delay)
-// Processed one-per-loop-iteration in loop() for ESP8266 I2C reliability.
+// Optimization #27: state journal — dirty state stays in RAM and is written
+// on the journal cadence, at once for the purge direction, and on shutdown
 // ============================================================================
-void OpenZoningController::queue_open_damper_(uint8_t zone) {
-  if (zone >= num_zones_ || dq_count_ + 3 > MAX_DAMPER_OPS) return;
-  Zone &z = zones_[zone];
-  if (!z.damper_open_sw || !z.damper_close_sw) return;
-
-  uint32_t gap = (dq_count_ == 0) ? 0 : 50;  // 50ms gap between zones
-
-  damper_ops_[dq_count_++] = {z.damper_close_sw, false, gap};   // stop opposite
-  damper_ops_[dq_count_++] = {z.damper_open_sw, false, 50};     // stop same
-  damper_ops_[dq_count_++] = {z.damper_open_sw, true, 250};     // engage open
+void OpenZoningController::persist_state_() {
+  // Purge direction of each unit in 2 bits, mode changes summed (see setup())
+  PersistedState state;
+  for (uint8_t u = 0; u < num_units_; u++) {
+    state.last_active_mode |= cores_[u].get_last_active_mode() << (2 * u);
+    state.mode_changes += cores_[u].get_mode_change_count();
+  }
+  // Purge direction: a crash before the next cadence must not lose it (rare)
+  const bool urgent = state.last_active_mode != journal_.get_state().last_active_mode;
+  if (journal_.update(state, now_ms_, urgent) || journal_.loop(now_ms_))
+    cores_[0].events().push(now_ms_, Event::STATE_SAVED, EventLog::NO_ZONE, journal_.get_last_slot(),
+                            static_cast<int32_t>(journal_.get_sequence()));
 }
 
-void OpenZoningController::queue_close_damper_(uint8_t zone) {
-  if (zone >= num_zones_ || dq_count_ + 3 > MAX_DAMPER_OPS) return;
-  Zone &z = zones_[zone];
-  if (!z.damper_open_sw || !z.damper_close_sw) return;
-
-  uint32_t gap = (dq_count_ == 0) ? 0 : 50;  // 50ms gap between zones
-
-  damper_ops_[dq_count_++] = {z.damper_open_sw, false, gap};    // stop opposite
-  damper_ops_[dq_count_++] = {z.damper_close_sw, false, 50};    // stop same
-  damper_ops_[dq_count_++] = {z.damper_close_sw, true, 250};    // engage close
+void OpenZoningController::on_shutdown() {
+  if (journal_.flush(now_())) {
+    global_preferences->sync();
+    ESP_LOGI(TAG, "State record %u saved before shutdown", journal_.get_sequence());
+  }
 }
 
 // ============================================================================
-// PASS 5: Central Unit Output Control
+// PASS 5 application: mode / LEDs → central unit switches
 // ============================================================================
-void OpenZoningController::pass5_output_control_() {
-  if (!auto_mode_) {
-    return;  // Manual mode — don't touch outputs
+void OpenZoningController::apply_outputs_() {
+  OZ_TIME_STAGE(&timings_, Stage::APPLY_OUTPUTS);
+  if (!cores_[0].get_auto_mode()) {
+    // Manual mode — don't touch outputs. They may be switched from HA
+    // meanwhile: the shadow no longer says what the pins hold.
+    outputs_known_ = false;
+    return;
   }
 
-  int new_mode = 0;  // Default: Arrêt (index 0)
-
-  // --- Error handling: force shutdown on zone error ---
-  if (zone_error_flag_) {
-    new_mode = 0;  // Arrêt
-    if (led_error_) led_error_->turn_on();
-    ESP_LOGE(TAG, "Zone error detected - forcing central unit to Arrêt");
-  } else {
-    if (led_error_) led_error_->turn_off();
-
-    // --- Determine base mode from global_max_priority ---
-    if (global_max_priority_ == 0) {
-      new_mode = 0;  // Arrêt
-
-    } else if (global_max_priority_ == 1) {
-      new_mode = 1;  // Fan1
-
-    } else if (global_max_priority_ == 2) {
-      // Cooling demand — check if any zone needs stage 2
-      bool needs_stage2 = false;
-      for (uint8_t i = 0; i < num_zones_; i++) {
-        if (zones_[i].state_new == ZoneState::COOLING_STAGE2) {
-          needs_stage2 = true;
-          break;
-        }
-      }
-      new_mode = needs_stage2 ? 3 : 2;  // Clim Stage 2 or 1
-      // Optimization #5: persist only when value changes to avoid flash wear
-      if (last_active_mode_ != 2) {
-        last_active_mode_ = 2;  // cooling
-        last_active_mode_pref_.save(&last_active_mode_);
-        ESP_LOGD(TAG, "Opt#5: saved last_active_mode=2 (cooling)");
-      }
-
-    } else if (global_max_priority_ == 4) {
-      // Heating demand — check if any zone needs stage 2
-      bool needs_stage2 = false;
-      for (uint8_t i = 0; i < num_zones_; i++) {
-        if (zones_[i].state_new == ZoneState::HEATING_STAGE2) {
-          needs_stage2 = true;
-          break;
-        }
-      }
-      new_mode = needs_stage2 ? 5 : 4;  // Chauffage Stage 2 or 1
-      // Optimization #5: persist only when value changes to avoid flash wear
-      if (last_active_mode_ != 1) {
-        last_active_mode_ = 1;  // heating
-        last_active_mode_pref_.save(&last_active_mode_);
-        ESP_LOGD(TAG, "Opt#5: saved last_active_mode=1 (heating)");
-      }
-
-    } else if (global_max_priority_ == 6) {
-      // Purge demand — fan only, preserve OB position from last active mode
-      new_mode = (last_active_mode_ == 2) ? 7 : 6;
-      // 7 = Purge Clim (G ON, OB ON), 6 = Purge Chauffage (G ON, OB OFF)
-    }
-
-    // --- Stage 2 escalation timer ---
-    if (new_mode == 2 || new_mode == 4) {
-      // Currently in Stage 1 — check escalation timer
-      if (current_mode_ != 2 && current_mode_ != 4) {
-        // Just entered Stage 1 — start timer
-        stage1_start_ms_ = millis();
-        ESP_LOGI(TAG, "Stage 1 started - escalation timer armed (%u ms)", stage2_escalation_ms_);
-      } else if (stage2_escalation_ms_ > 0) {
-        // Already in Stage 1 — check if escalation delay exceeded
-        unsigned long stage1_elapsed = millis() - stage1_start_ms_;
-        if (stage1_elapsed >= stage2_escalation_ms_) {
-          new_mode = new_mode + 1;  // 2→3 (Clim S2) or 4→5 (Chauffage S2)
-          ESP_LOGW(TAG, "Stage 2 ESCALATION triggered after %lu ms (threshold: %u ms)",
-                   stage1_elapsed, stage2_escalation_ms_);
-        }
-      }
-    } else {
-      // Not in Stage 1 — reset escalation timer
-      stage1_start_ms_ = 0;
-    }
+  // --- Apply each unit's mode change (unit 0 via the select entity) ---
+  for (uint8_t u = 0; u < num_units_; u++) {
+    const uint8_t mode = cores_[u].get_current_mode();
+    if (mode == applied_mode_[u]) continue;
+    applied_mode_[u] = mode;
+    apply_mode_(u, mode);
   }
 
-  // --- Apply mode change via select entity ---
-  if (new_mode != current_mode_) {
-    mode_change_count_++;  // Optimization #3: count real transitions
-    ESP_LOGI(TAG, "Mode change: %d -> %d (priority: %d)", current_mode_, new_mode, global_max_priority_);
-    current_mode_ = new_mode;
-    apply_mode_(new_mode);
-  }
+  // Only the bits that moved are written: every changed unit output in one
+  // write per expander; with no mode change only the error LED can move —
+  // no bus traffic when unchanged
+  write_outputs_(output_word_());
 }
 
 // ============================================================================
-// Apply mode — drives LEDs and outputs, syncs the select entity
-// Replaces the on_value lambda in select.yml
+// Apply mode — the caller writes the output word (output_word_()); the
+// select entity follows at the next loop() (sync_mode_select_()). Replaces
+// the on_value lambda in select.yml
 // ============================================================================
-void OpenZoningController::apply_mode_(int mode) {
-  // Sync the select entity to reflect the new mode in HA.
+void OpenZoningController::apply_mode_(uint8_t unit, uint8_t mode) {
+  if (unit == 0 && mode_select_) select_pending_ = true;
+  cores_[unit].events().push(now_(), Event::MODE_APPLIED, EventLog::NO_ZONE, mode);
+}
+
+// Sync the select entity with unit 0's applied mode, outside the pipeline:
+// its on_value automations and the API publish no longer delay the relays.
+// Modes applied since the last loop() coalesce into one call for the last
+// one, and none when the select already shows it (a mode that flapped back).
+void OpenZoningController::sync_mode_select_() {
+  OZ_TIME_STAGE(&timings_, Stage::APPLY_MODE);
+  select_pending_ = false;
+  const uint8_t mode = applied_mode_[0];
+  if (mode == select_mode_) return;
+  select_mode_ = mode;
+  select_syncs_++;
   // Set component_driving_select_ = true so the on_value callback (opt. #10)
   // can distinguish this internal update from a manual user change.
-  if (mode_select_) {
-    component_driving_select_ = true;
-    auto call = mode_select_->make_call();
-    call.set_index(mode);
-    call.perform();  // on_value fires synchronously here
-    component_driving_select_ = false;
-  }
-
-  // Default: all off
-  bool y1 = false, y2 = false, g = false, ob = false;
-  bool w1e = false, w2 = false, w3 = false;
-  bool l_fan = false, l_heat = false, l_cool = false, l_error = false;
-
-  switch (mode) {
-    case 0:  // Arrêt
-      ESP_LOGD(TAG, "Mode: Arrêt");
-      break;
-    case 1:  // Fan1
-      ESP_LOGD(TAG, "Mode: Fan");
-      l_fan = true;
-      g = true;
-      break;
-    case 2:  // Clim Stage 1
-      ESP_LOGD(TAG, "Mode: Clim Stage 1");
-      l_fan = true; l_cool = true;
-      y1 = true; g = true; ob = true;
-      break;
-    case 3:  // Clim Stage 2
-      ESP_LOGD(TAG, "Mode: Clim Stage 2");
-      l_fan = true; l_cool = true;
-      y1 = true; y2 = true; g = true; ob = true;
-      break;
-    case 4:  // Chauffage Stage 1
-      ESP_LOGD(TAG, "Mode: Chauffage Stage 1");
-      l_fan = true; l_heat = true;
-      y1 = true; g = true;
-      break;
-    case 5:  // Chauffage Stage 2
-      ESP_LOGD(TAG, "Mode: Chauffage Stage 2");
-      l_fan = true; l_heat = true;
-      y1 = true; y2 = true; g = true;
-      break;
-    case 6:  // Purge Chauffage (fan only, OB OFF)
-      ESP_LOGD(TAG, "Mode: Purge Chauffage");
-      l_fan = true;
-      g = true;
-      break;
-    case 7:  // Purge Clim (fan only, OB ON)
-      ESP_LOGD(TAG, "Mode: Purge Clim");
-      l_fan = true;
-      g = true; ob = true;
-      break;
-    default:
-      ESP_LOGW(TAG, "Unknown mode index: %d", mode);
-      break;
-  }
-
-  // Apply outputs
-  if (out_y1_)  { if (y1)  out_y1_->turn_on();  else out_y1_->turn_off();  }
-  if (out_y2_)  { if (y2)  out_y2_->turn_on();  else out_y2_->turn_off();  }
-  if (out_g_)   { if (g)   out_g_->turn_on();   else out_g_->turn_off();   }
-  if (out_ob_)  { if (ob)  out_ob_->turn_on();  else out_ob_->turn_off();  }
-  if (out_w1e_) { if (w1e) out_w1e_->turn_on(); else out_w1e_->turn_off(); }
-  if (out_w2_)  { if (w2)  out_w2_->turn_on();  else out_w2_->turn_off();  }
-  if (out_w3_)  { if (w3)  out_w3_->turn_on();  else out_w3_->turn_off();  }
-
-  // Apply LEDs
-  if (led_fan_)   { if (l_fan)   led_fan_->turn_on();   else led_fan_->turn_off();   }
-  if (led_heat_)  { if (l_heat)  led_heat_->turn_on();  else led_heat_->turn_off();  }
-  if (led_cool_)  { if (l_cool)  led_cool_->turn_on();  else led_cool_->turn_off();  }
-  if (led_error_) { if (l_error) led_error_->turn_on(); else led_error_->turn_off(); }
+  component_driving_select_ = true;
+  auto call = mode_select_->make_call();
+  call.set_index(mode);
+  call.perform();  // on_value fires synchronously here
+  component_driving_select_ = false;
 }
 
-// ============================================================================
-// PASS 2.5: Minimum Zone Demand Threshold
-// ============================================================================
-void OpenZoningController::pass2_5_minimum_demand_() {
-  if (min_active_zones_ <= 1) return;  // Feature disabled
+// Output word of the applied modes. Unknown indices map to all-off; a LED is
+// on when any unit's mode lights it, the error LED tracks every unit's zone
+// error flag.
+uint32_t OpenZoningController::output_word_() const {
+  uint32_t word = 0;
+  uint8_t leds = 0;
+  for (uint8_t u = 0; u < num_units_; u++) {
+    word |= static_cast<uint32_t>(ControlCore::mode_unit_bits(applied_mode_[u])) << (8 * u);
+    leds |= ControlCore::mode_led_bits(applied_mode_[u]) | (cores_[u].has_zone_error() ? ControlCore::LED_ERROR : 0);
+  }
+  return word | static_cast<uint32_t>(leds) << LED_SHIFT;
+}
 
-  // Count zones currently demanding (active states, not Purge/Error/Wait/Off)
-  uint8_t demanding = 0;
-  for (uint8_t i = 0; i < num_zones_; i++) {
-    if (!zones_[i].enabled) continue;
-    ZoneState s = zones_[i].state_new;
-    if (s == ZoneState::HEATING_STAGE1 || s == ZoneState::HEATING_STAGE2 ||
-        s == ZoneState::COOLING_STAGE1 || s == ZoneState::COOLING_STAGE2 ||
-        s == ZoneState::FAN_ONLY) {
-      demanding++;
+// Bind each bit of the output word to its switch and, when its expander is
+// owned by the component, to its latch pin. LEDs sharing the damper
+// expander must go through the latch shadow: a Switch write would make the
+// mcp23017 driver write back stale damper bits.
+void OpenZoningController::setup_output_channels_() {
+  McpPort *unit_port = output_port_.is_configured() ? &output_port_ : nullptr;
+  for (uint8_t u = 0; u < num_units_; u++) {
+    for (uint8_t k = 0; k < NUM_UNIT_OUTPUTS; k++) {
+      const uint8_t pin = output_pins_[u].pin[k];
+      const bool mapped = unit_port != nullptr && pin != McpPort::NO_PIN;
+      out_channels_[8 * u + k] = {unit_out_[u][k], mapped ? unit_port : nullptr, pin};
     }
   }
 
-  // Threshold met — reset override timer, let all zones through
-  if (demanding >= min_active_zones_) {
-    min_demand_wait_start_ms_ = 0;
-    return;
+  switch_::Switch *led_sw[4] = {led_heat_, led_cool_, led_fan_, led_error_};  // ControlCore::LED_* order
+  const uint8_t led_pins[4] = {led_heat_pin_, led_cool_pin_, led_fan_pin_, led_error_pin_};
+  McpPort *led_port = damper_port_.is_configured() ? &damper_port_ : nullptr;
+  for (uint8_t k = 0; k < 4; k++) {
+    const bool mapped = led_port != nullptr && led_pins[k] != McpPort::NO_PIN;
+    out_channels_[LED_SHIFT + k] = {led_sw[k], mapped ? led_port : nullptr, led_pins[k]};
   }
+  outputs_known_ = false;
+}
 
-  // System currently running — do not interrupt an active cycle
-  if (current_mode_ != 0) return;
-
-  // No zones demanding at all — nothing to hold
-  if (demanding == 0) {
-    min_demand_wait_start_ms_ = 0;
-    return;
-  }
-
-  // Below threshold and system is off — apply hold
-  unsigned long now_ms = millis();
-
-  // Start override timer on first hold cycle
-  if (min_demand_wait_start_ms_ == 0) {
-    min_demand_wait_start_ms_ = now_ms;
-    ESP_LOGD(TAG, "PASS2.5: threshold not met (%d/%d zones) — holding, override in %u ms",
-             demanding, min_active_zones_, min_demand_override_ms_);
+void OpenZoningController::write_outputs_(uint32_t word) {
+  const uint32_t changed = outputs_known_ ? word ^ outputs_written_ : ~0u;
+  if (changed == 0) return;
+
+  for (uint8_t k = 0; k < NUM_OUTPUT_BITS; k++) {
+    if (!(changed & (1u << k))) continue;
+    const OutputChannel &ch = out_channels_[k];
+    const bool on = word & (1u << k);
+    if (ch.port != nullptr) {
+      ch.port->set(ch.pin, on);
+      if (ch.sw && ch.sw->state != on) ch.sw->publish_state(on);  // mirror only
+    } else if (ch.sw) {
+      if (on) ch.sw->turn_on(); else ch.sw->turn_off();
+    }
   }
 
-  // Override: zone(s) have been waiting too long — force start
-  if (min_demand_override_ms_ > 0 &&
-      (now_ms - min_demand_wait_start_ms_) >= min_demand_override_ms_) {
-    ESP_LOGW(TAG, "PASS2.5: emergency override — zone(s) waiting >%u ms, forcing start",
-             min_demand_override_ms_);
-    min_demand_wait_start_ms_ = 0;
-    return;
-  }
+  // One OLAT write per expander (no-op when its bits did not change). A
+  // failed write leaves the port dirty and loop() retries it.
+  if (output_port_.is_configured()) output_port_.flush();
+  if (damper_port_.is_configured()) damper_port_.flush();
 
-  // Hold active-state zones to WAIT
-  for (uint8_t i = 0; i < num_zones_; i++) {
-    if (!zones_[i].enabled) continue;
-    ZoneState s = zones_[i].state_new;
-    if (s == ZoneState::HEATING_STAGE1 || s == ZoneState::HEATING_STAGE2 ||
-        s == ZoneState::COOLING_STAGE1 || s == ZoneState::COOLING_STAGE2 ||
-        s == ZoneState::FAN_ONLY) {
-      zones_[i].state_new = ZoneState::WAIT;
-      ESP_LOGD(TAG, "PASS2.5: Zone %d held (WAIT) — waiting for %d/%d zones",
-               i + 1, demanding, min_active_zones_);
-    }
-  }
+  outputs_written_ = word;
+  outputs_known_ = true;
 }
 
 // ============================================================================
@@ -765,82 +839,170 @@ void OpenZoningController::pass2_5_minimum_demand_() {
 // ============================================================================
 void OpenZoningController::check_i2c_health_() {
   if (i2c_bus_ == nullptr) return;
-
-  // Probe MCP23017 at 0x20 with a 0-byte write — just checks for address ACK.
-  // All three expanders share the same bus; if 0x20 is stuck, the bus is stuck.
-  const uint8_t dummy = 0;
-  i2c::ErrorCode result = i2c_bus_->write(0x20, &dummy, 0, true);
-
-  if (result != i2c::ERROR_OK) {
-    i2c_error_count_++;
-    ESP_LOGW(TAG, "I2C watchdog: MCP23017@0x20 no ACK (%d/%d) — error code: %d",
-             i2c_error_count_, i2c_error_threshold_, static_cast<int>(result));
-    if (i2c_healthy_) {
-      i2c_healthy_ = false;
-      if (i2c_health_sensor_) i2c_health_sensor_->publish_state(false);
-    }
-    if (i2c_error_count_ >= i2c_error_threshold_) {
-      ESP_LOGE(TAG, "I2C watchdog: bus stuck after %d consecutive failures — rebooting",
-               i2c_error_count_);
-      App.safe_reboot();
-    }
-  } else {
-    if (i2c_error_count_ > 0) {
-      ESP_LOGI(TAG, "I2C watchdog: MCP23017@0x20 recovered after %d failed checks",
-               i2c_error_count_);
+  OZ_TIME_STAGE(&timings_, Stage::I2C_HEALTH);
+
+  uint8_t failing = 0;
+  uint8_t stuck = 0;
+  bool reboot = false;
+  for (uint8_t k = 0; k < i2c_num_watched_; k++) {
+    const uint8_t address = i2c_watched_[k];
+    uint8_t &errors = i2c_error_count_[k];
+
+    // Latch writes and input reads that just succeeded already prove the
+    // expander answers; probe only the quiet or failing ones, with a 0-byte
+    // write (address ACK only).
+    i2c::ErrorCode result = i2c::ERROR_OK;
+    if (i2c_meter_.recently_ok(address, i2c_traffic_window_ms_)) {
+      i2c_probes_skipped_++;
+    } else {
+      const uint8_t dummy = 0;
+      result = i2c_bus_->write(address, &dummy, 0, true);
     }
-    i2c_error_count_ = 0;
-    if (!i2c_healthy_) {
-      i2c_healthy_ = true;
-      if (i2c_health_sensor_) i2c_health_sensor_->publish_state(true);
+
+    if (result != i2c::ERROR_OK) {
+      if (errors < 255) errors++;
+      ESP_LOGW(TAG, "I2C watchdog: MCP23017@0x%02X no ACK (%d/%d) — error code: %d", address, errors,
+               i2c_error_threshold_, static_cast<int>(result));
+      if (errors == i2c_error_threshold_)
+        ESP_LOGE(TAG, "I2C watchdog: MCP23017@0x%02X not responding after %d checks", address, errors);
+      failing++;
+      if (errors >= i2c_error_threshold_) {
+        stuck++;
+        reboot |= i2c_reboot_[k];
+      }
+    } else if (errors > 0) {
+      ESP_LOGI(TAG, "I2C watchdog: MCP23017@0x%02X recovered after %d failed checks", address, errors);
+      errors = 0;
     }
   }
+
+  const bool healthy = failing == 0;
+  if (healthy != i2c_healthy_) {
+    i2c_healthy_ = healthy;
+    if (i2c_health_sensor_) i2c_health_sensor_->publish_state(healthy);
+  }
+
+  // Every expander down: the bus itself is stuck. A reboot expander (the
+  // thermostat inputs by default) down alone is enough: no call is seen.
+  if (i2c_num_watched_ > 0 && stuck == i2c_num_watched_) {
+    ESP_LOGE(TAG, "I2C watchdog: bus stuck after %d consecutive failures — rebooting", i2c_error_threshold_);
+    App.safe_reboot();
+  } else if (reboot) {
+    ESP_LOGE(TAG, "I2C watchdog: reboot expander stuck after %d consecutive failures — rebooting",
+             i2c_error_threshold_);
+    App.safe_reboot();
+  }
 }
 
 // ============================================================================
-// Optimization #3: Diagnostic sensors — published every update() cycle
+// Optimization #3: Diagnostic sensors — computed every pipeline run,
+// published through their PublishGate (change-driven, rate-limited)
 // ============================================================================
 void OpenZoningController::publish_diagnostics_() {
+  // Every unit's zones (each core's enabled mask holds only its own)
+  uint16_t running = 0, short_cycle = 0;
+  uint32_t mode_changes = 0;
+  float stage1_elapsed = 0.0f;  // the unit longest in Stage 1
+  for (uint8_t u = 0; u < num_units_; u++) {
+    const ControlCore &core = cores_[u];
+    running |= core.get_running_zones() & core.get_enabled();
+    short_cycle |= core.get_short_cycle_zones() & core.get_enabled();
+    mode_changes += core.get_mode_change_count();
+    const uint8_t mode = core.get_current_mode();
+    if (mode == 2 || mode == 4) {
+      const float elapsed = (now_ms_ - core.get_stage1_start_ms()) / 1000.0f;
+      if (elapsed > stage1_elapsed) stage1_elapsed = elapsed;
+    }
+  }
+
   // --- Active zone count ---
   // Count zones that have an open damper and are doing something useful
   // (heating, cooling, fan, purge) — i.e. everything except OFF / WAIT / ERROR.
   if (active_zones_sensor_) {
-    uint8_t active_count = 0;
-    for (uint8_t i = 0; i < num_zones_; i++) {
-      if (!zones_[i].enabled) continue;
-      ZoneState s = zones_[i].state;
-      if (s != ZoneState::OFF && s != ZoneState::WAIT && s != ZoneState::ERROR)
-        active_count++;
-    }
-    active_zones_sensor_->publish_state(active_count);
+    const uint8_t active_count = __builtin_popcount(running);
+    if (diag_gates_[DIAG_ACTIVE_ZONES].check(active_count, now_ms_))
+      active_zones_sensor_->publish_state(active_count);
   }
 
   // --- Stage 1 elapsed time (seconds since Stage 1 entry, 0 if not in Stage 1) ---
   if (stage1_elapsed_sensor_) {
-    float elapsed = 0.0f;
-    if (stage1_start_ms_ > 0 && (current_mode_ == 2 || current_mode_ == 4)) {
-      elapsed = (millis() - stage1_start_ms_) / 1000.0f;
-    }
-    stage1_elapsed_sensor_->publish_state(elapsed);
+    if (diag_gates_[DIAG_STAGE1_ELAPSED].check(stage1_elapsed, now_ms_))
+      stage1_elapsed_sensor_->publish_state(stage1_elapsed);
   }
 
   // --- Short cycle protection: ON if any enabled zone is currently protected ---
   if (short_cycle_sensor_) {
-    bool any_protected = false;
-    for (uint8_t i = 0; i < num_zones_; i++) {
-      if (zones_[i].enabled && zones_[i].short_cycle_protection) {
-        any_protected = true;
-        break;
-      }
-    }
-    short_cycle_sensor_->publish_state(any_protected);
+    const bool any_protected = short_cycle != 0;
+    if (diag_gates_[DIAG_SHORT_CYCLE].check(any_protected ? 1.0f : 0.0f, now_ms_))
+      short_cycle_sensor_->publish_state(any_protected);
   }
 
-  // --- Mode change counter (cumulative since boot) ---
+  // --- Mode change counter (cumulative, restored from the state journal) ---
   if (mode_changes_sensor_) {
-    mode_changes_sensor_->publish_state(static_cast<float>(mode_change_count_));
+    const float changes = static_cast<float>(mode_changes);
+    if (diag_gates_[DIAG_MODE_CHANGES].check(changes, now_ms_))
+      mode_changes_sensor_->publish_state(changes);
   }
 }
 
+// ============================================================================
+// Runtime counters: read from the core (kept at each commit) and published
+// on their own slow cadence — no state history leaves the controller
+// ============================================================================
+void OpenZoningController::publish_runtime_() {
+  if (num_runtime_sensors_ == 0 || !time_reached(now_ms_, runtime_next_publish_ms_)) return;
+  runtime_next_publish_ms_ = now_ms_ + runtime_publish_ms_;
+
+  for (uint8_t k = 0; k < num_runtime_sensors_; k++) {
+    const RuntimeSensor &r = runtime_sensors_[k];
+    // A zone's counters are kept by the core of its unit
+    const uint8_t unit = r.zone == RUNTIME_UNIT ? r.unit : unit_of_(r.zone);
+    const RuntimeStats &rt = cores_[unit < num_units_ ? unit : 0].get_runtime();
+    float value;
+    if (r.zone == RUNTIME_UNIT) {
+      value = r.entries ? rt.mode_entries(r.index) : rt.mode_ms(r.index, now_ms_) / 3600000.0f;
+    } else {
+      const ZoneState s = static_cast<ZoneState>(r.index);
+      value = r.entries ? rt.zone_entries(r.zone, s) : rt.zone_ms(r.zone, s, now_ms_) / 3600000.0f;
+    }
+    r.sensor->publish_state(value);
+  }
+}
+
+#ifdef OPEN_ZONING_STAGE_TIMING
+// ============================================================================
+// Stage timing sensors — max and mean of each stage over the last window
+// ============================================================================
+void OpenZoningController::publish_stage_timings_() {
+  const uint32_t now = now_();
+  if (!time_reached(now, timing_next_publish_ms_)) return;
+  timing_next_publish_ms_ = now + timing_publish_ms_;
+
+  for (uint8_t i = 0; i < StageTimings::NUM_STAGES; i++) {
+    StageStats &s = timings_.get(static_cast<Stage>(i));
+    if (s.window_count > 0) {
+      if (stage_max_sensors_[i]) stage_max_sensors_[i]->publish_state(s.window_max_us);
+      if (stage_mean_sensors_[i]) stage_mean_sensors_[i]->publish_state(s.window_mean_us());
+    }
+    s.reset_window();
+  }
+}
+#endif
+
+#ifdef OPEN_ZONING_ALLOC_MONITOR
+// ============================================================================
+// Allocation monitor sensors — counters since boot
+// ============================================================================
+void OpenZoningController::publish_alloc_monitor_() {
+  const uint32_t now = now_();
+  if (!time_reached(now, alloc_next_publish_ms_)) return;
+  alloc_next_publish_ms_ = now + alloc_publish_ms_;
+
+  if (allocations_sensor_) allocations_sensor_->publish_state(AllocMonitor::allocations());
+  const uint32_t min_free = AllocMonitor::min_free_heap();
+  if (min_free_heap_sensor_ && min_free != UINT32_MAX) min_free_heap_sensor_->publish_state(min_free);
+}
+#endif
+
 }  // namespace open_zoning
 }  // namespace esphome
@@ -10,13 +10,55 @@
 #include "esphome/components/sensor/sensor.h"
 #include "esphome/core/preferences.h"
 #include "zone.h"
+#include "control_core.h"
+#include "mcp_port.h"
+#include "i2c_metrics.h"
+#include "damper_scheduler.h"
+#include "publish_gate.h"
+#include "thermostat_inputs.h"
+#include "state_journal.h"
+#include "alloc_monitor.h"
 
 namespace esphome {
 namespace open_zoning {
 
-static const char *const TAG = "open_zoning";
-static const uint8_t MAX_ZONES = 6;
+// Central units the component is built for: the codegen emits 1 + the
+// number of additional_units. Every unit's outputs and the LEDs share one
+// 32-bit output word.
+#ifndef OPEN_ZONING_MAX_UNITS
+#define OPEN_ZONING_MAX_UNITS 1
+#endif
+static constexpr uint8_t MAX_UNITS = OPEN_ZONING_MAX_UNITS;
+static_assert(MAX_UNITS >= 1 && MAX_UNITS <= 3, "unit outputs and LEDs share one 32-bit output word");
 
+/// ESPHome entities bound to one zone (set via codegen from __init__.py)
+struct ZoneEntities {
+  // --- Thermostat input sensors ---
+  binary_sensor::BinarySensor *y1{nullptr};
+  binary_sensor::BinarySensor *y2{nullptr};
+  binary_sensor::BinarySensor *g{nullptr};
+  binary_sensor::BinarySensor *ob{nullptr};
+
+  // --- Damper output switches ---
+  switch_::Switch *damper_open_sw{nullptr};
+  switch_::Switch *damper_close_sw{nullptr};
+
+  // Damper pins on the damper expander latch (damper_port mode), 255 = unmapped
+  uint8_t damper_open_pin{255};
+  uint8_t damper_close_pin{255};
+
+  // --- Text sensor for zone state display in HA ---
+  text_sensor::TextSensor *state_sensor{nullptr};
+};
+
+/// ESPHome adapter around ControlCore: packs the thermostat entities into a
+/// CoreInput, runs the core, and turns the CoreOutput into damper motor
+/// sequences, central unit outputs, LEDs, select sync and HA publishes.
+///
+/// Each central unit runs its own ControlCore over the zones assigned to it
+/// (the other zones are disabled in its input): priority, purge, stage 2
+/// and the unit mode are decided per unit. The input read, the damper
+/// scheduler and the output write are shared.
 class OpenZoningController : public PollingComponent {
  public:
   // --- PollingComponent overrides ---
@@ -25,6 +67,7 @@ class OpenZoningController : public PollingComponent {
   void loop() override;
   void dump_config() override;
   float get_setup_priority() const override { return setup_priority::DATA; }
+  void on_shutdown() override;
 
   // --- Configuration setters (called from __init__.py codegen) ---
   void set_zone_sensors(uint8_t index,
@@ -36,45 +79,181 @@ class OpenZoningController : public PollingComponent {
                         switch_::Switch *damper_open,
                         switch_::Switch *damper_close);
   void set_zone_state_sensor(uint8_t index, text_sensor::TextSensor *sensor);
-  void set_num_zones(uint8_t n) { num_zones_ = n; }
-  void set_min_cycle_time(uint32_t ms) { min_cycle_time_ms_ = ms; }
-  void set_purge_duration(uint32_t ms) { purge_duration_ms_ = ms; }
+  void set_zone_damper_pins(uint8_t index, uint8_t open_pin, uint8_t close_pin);
+  void set_num_zones(uint8_t n) { num_zones_ = n > MAX_ZONES ? MAX_ZONES : n; }
+  void set_min_cycle_time(uint32_t ms) {
+    for (auto &core : cores_) core.set_min_cycle_time(ms);
+  }
+  void set_purge_duration(uint32_t ms) {
+    for (auto &core : cores_) core.set_purge_duration(ms);
+  }
+
+  // --- Central units (unit 0: the out_* outputs and the mode select) ---
+  void set_num_units(uint8_t n) { num_units_ = n < 1 ? 1 : (n > MAX_UNITS ? MAX_UNITS : n); }
+  // Zones start on unit 0
+  void set_zone_unit(uint8_t index, uint8_t unit) {
+    if (index >= MAX_ZONES || unit >= MAX_UNITS) return;
+    const uint16_t bit = static_cast<uint16_t>(1u << index);
+    for (auto &zones : unit_zones_) zones &= static_cast<uint16_t>(~bit);
+    unit_zones_[unit] |= bit;
+  }
+  // Outputs of units 1..; unit 0 uses set_out_y1() and the like
+  void set_unit_outputs(uint8_t unit, switch_::Switch *y1, switch_::Switch *y2, switch_::Switch *g,
+                        switch_::Switch *ob, switch_::Switch *w1e, switch_::Switch *w2, switch_::Switch *w3) {
+    if (unit >= MAX_UNITS) return;
+    switch_::Switch *sw[NUM_UNIT_OUTPUTS] = {y1, y2, g, ob, w1e, w2, w3};
+    for (uint8_t k = 0; k < NUM_UNIT_OUTPUTS; k++) unit_out_[unit][k] = sw[k];
+  }
+  uint8_t get_num_units() const { return num_units_; }
+  // Out-of-range units read the first one
+  uint16_t get_unit_zones(uint8_t unit) const { return unit_zones_[unit < MAX_UNITS ? unit : 0]; }
+  uint8_t get_unit_mode(uint8_t unit) const { return get_unit_core(unit).get_current_mode(); }
+  const ControlCore &get_unit_core(uint8_t unit) const { return cores_[unit < MAX_UNITS ? unit : 0]; }
+
+  // --- Event-driven evaluation setters ---
+  void set_event_driven(bool v) { event_driven_ = v; }
+  void set_event_latency(uint32_t ms) { event_latency_ms_ = ms; }
 
   // --- Output / LED / Select setters ---
-  void set_out_y1(switch_::Switch *sw) { out_y1_ = sw; }
-  void set_out_y2(switch_::Switch *sw) { out_y2_ = sw; }
-  void set_out_g(switch_::Switch *sw) { out_g_ = sw; }
-  void set_out_ob(switch_::Switch *sw) { out_ob_ = sw; }
-  void set_out_w1e(switch_::Switch *sw) { out_w1e_ = sw; }
-  void set_out_w2(switch_::Switch *sw) { out_w2_ = sw; }
-  void set_out_w3(switch_::Switch *sw) { out_w3_ = sw; }
+  void set_out_y1(switch_::Switch *sw) { unit_out_[0][0] = sw; }
+  void set_out_y2(switch_::Switch *sw) { unit_out_[0][1] = sw; }
+  void set_out_g(switch_::Switch *sw) { unit_out_[0][2] = sw; }
+  void set_out_ob(switch_::Switch *sw) { unit_out_[0][3] = sw; }
+  void set_out_w1e(switch_::Switch *sw) { unit_out_[0][4] = sw; }
+  void set_out_w2(switch_::Switch *sw) { unit_out_[0][5] = sw; }
+  void set_out_w3(switch_::Switch *sw) { unit_out_[0][6] = sw; }
   void set_led_heat(switch_::Switch *sw) { led_heat_ = sw; }
   void set_led_cool(switch_::Switch *sw) { led_cool_ = sw; }
   void set_led_fan(switch_::Switch *sw) { led_fan_ = sw; }
   void set_led_error(switch_::Switch *sw) { led_error_ = sw; }
   void set_mode_select(select::Select *sel) { mode_select_ = sel; }
-  void set_auto_mode(bool v) { auto_mode_ = v; }
-  void set_stage2_escalation_delay(uint32_t ms) { stage2_escalation_ms_ = ms; }
+  void set_auto_mode(bool v) {
+    for (auto &core : cores_) core.set_auto_mode(v);
+  }
+  void set_stage2_escalation_delay(uint32_t ms) {
+    for (auto &core : cores_) core.set_stage2_escalation_delay(ms);
+  }
+
+  // --- Damper motion setters ---
+  // Motors engaged within one inrush window (0: no cap)
+  void set_max_moving_dampers(uint8_t n) { dampers_.set_max_moving(n); }
+  void set_damper_inrush_window(uint32_t ms) { dampers_.set_inrush_window(ms); }
+
+  // --- State journal setters (batched, rotating flash persistence) ---
+  void set_persist_interval(uint32_t ms) { journal_.set_commit_interval(ms); }
+  void set_persist_slots(uint8_t n) { journal_.set_slots(n); }
+  const StateJournal &get_state_journal() const { return journal_; }
+  const DamperScheduler &get_damper_scheduler() const { return dampers_; }
+
+  // --- Damper port setters (batched OLAT writes, requires i2c_bus) ---
+  void set_damper_port(uint8_t address, bool inverted) {
+    damper_port_enabled_ = true;
+    damper_port_.set_address(address);
+    damper_port_.set_inverted(inverted);
+  }
+  void set_led_pins(uint8_t heat, uint8_t cool, uint8_t fan, uint8_t error) {
+    led_heat_pin_ = heat;
+    led_cool_pin_ = cool;
+    led_fan_pin_ = fan;
+    led_error_pin_ = error;
+  }
+
+  // --- Output port setters (central unit outputs as one OLAT write, requires i2c_bus) ---
+  void set_output_port(uint8_t address, bool inverted) {
+    output_port_enabled_ = true;
+    output_port_.set_address(address);
+    output_port_.set_inverted(inverted);
+  }
+  void set_output_pins(uint8_t y1, uint8_t y2, uint8_t g, uint8_t ob, uint8_t w1e, uint8_t w2, uint8_t w3) {
+    set_unit_output_pins(0, y1, y2, g, ob, w1e, w2, w3);
+  }
+  // Every unit's pins are on the same output port: one OLAT write covers them all
+  void set_unit_output_pins(uint8_t unit, uint8_t y1, uint8_t y2, uint8_t g, uint8_t ob, uint8_t w1e, uint8_t w2,
+                            uint8_t w3) {
+    if (unit >= MAX_UNITS) return;
+    const uint8_t pins[NUM_UNIT_OUTPUTS] = {y1, y2, g, ob, w1e, w2, w3};  // ControlCore::UNIT_* bit order
+    for (uint8_t k = 0; k < NUM_UNIT_OUTPUTS; k++) output_pins_[unit].pin[k] = pins[k];
+  }
+
+  // --- Thermostat input ports (bulk GPIO reads, requires i2c_bus) ---
+  void add_input_port(uint8_t address, bool inverted) { inputs_.add_port(address, inverted); }
+  void set_zone_input_pins(uint8_t index, uint8_t port, uint8_t y1, uint8_t y2, uint8_t g, uint8_t ob) {
+    inputs_.set_zone_pins(index, port, y1, y2, g, ob);
+  }
+  void set_input_debounce(uint32_t ms) { inputs_.set_debounce(ms); }
+  void set_input_sample_interval(uint32_t ms) { input_sample_ms_ = ms; }
+  // Open a damper on the raw call edge, ahead of the debounce (rolled back
+  // when the debounced input does not confirm it)
+  void set_preposition_dampers(bool v) { preposition_ = v; }
+  uint16_t get_prepositioned() const { return prepositioned_; }
+  uint32_t get_prepositions() const { return prepositions_; }
+  uint32_t get_preposition_rollbacks() const { return preposition_rollbacks_; }
 
   // --- I2C watchdog setters ---
-  void set_i2c_bus(i2c::I2CBus *bus) { i2c_bus_ = bus; }
+  // The component's own traffic goes through i2c_meter_ (per-address metrics)
+  void set_i2c_bus(i2c::I2CBus *bus) {
+    i2c_meter_.set_parent(bus);
+    i2c_bus_ = bus ? &i2c_meter_ : nullptr;
+  }
   void set_i2c_health_sensor(binary_sensor::BinarySensor *s) { i2c_health_sensor_ = s; }
   void set_i2c_error_threshold(uint8_t n) { i2c_error_threshold_ = n; }
+  // Expanders checked by the watchdog (default 0x20, 0x21, 0x22); the first
+  // call replaces the defaults. `reboot`: this expander stuck alone reboots
+  // (default: 0x20, the thermostat inputs).
+  void add_i2c_watch_address(uint8_t address, bool reboot = false) {
+    if (!i2c_watch_custom_) {
+      i2c_watch_custom_ = true;
+      i2c_num_watched_ = 0;
+    }
+    if (i2c_num_watched_ >= MAX_WATCHED) return;
+    i2c_reboot_[i2c_num_watched_] = reboot;
+    i2c_watched_[i2c_num_watched_++] = address;
+  }
+  // Successful traffic younger than this stands in for the probe
+  void set_i2c_traffic_window(uint32_t ms) { i2c_traffic_window_ms_ = ms; }
+  const MeteredBus &get_i2c_metrics() const { return i2c_meter_; }
+  uint32_t get_i2c_probes_skipped() const { return i2c_probes_skipped_; }
 
   // --- Minimum zone demand setters ---
-  void set_min_active_zones(uint8_t n) { min_active_zones_ = n; }
-  void set_min_demand_override_delay(uint32_t ms) { min_demand_override_ms_ = ms; }
+  // (per unit: each unit counts its own demanding zones)
+  void set_min_active_zones(uint8_t n) {
+    for (auto &core : cores_) core.set_min_active_zones(n);
+  }
+  void set_min_demand_override_delay(uint32_t ms) {
+    for (auto &core : cores_) core.set_min_demand_override_delay(ms);
+  }
+
+  // --- Damper policy setters (ControlCore PASS 4, every unit) ---
+  void set_damper_min_dwell(uint32_t ms) {
+    for (auto &core : cores_) core.set_damper_min_dwell(ms);
+  }
+  void set_damper_idle_hold(bool v) {
+    for (auto &core : cores_) core.set_damper_idle_hold(v);
+  }
+  void set_damper_close_lookahead(uint32_t ms) {
+    for (auto &core : cores_) core.set_damper_close_lookahead(ms);
+  }
 
   // --- Zone enable/disable (optimization #2) ---
   void set_zone_enabled(uint8_t index, bool enabled) {
-    if (index < num_zones_) zones_[index].enabled = enabled;
+    if (index >= num_zones_) return;
+    if (enabled) {
+      enabled_mask_ |= static_cast<uint16_t>(1u << index);
+    } else {
+      enabled_mask_ &= static_cast<uint16_t>(~(1u << index));
+    }
   }
 
   // --- O/B polarity per zone (optimization #12) ---
   // on_heat=true  : O/B active → heating (default)
   // on_heat=false : O/B active → cooling
   void set_zone_ob_on_heat(uint8_t index, bool on_heat) {
-    if (index < num_zones_) zones_[index].ob_on_heat = on_heat;
+    if (index >= num_zones_) return;
+    if (on_heat) {
+      ob_on_heat_mask_ |= static_cast<uint16_t>(1u << index);
+    } else {
+      ob_on_heat_mask_ &= static_cast<uint16_t>(~(1u << index));
+    }
   }
 
   // --- Optimization #3: diagnostic sensor setters ---
@@ -83,70 +262,253 @@ class OpenZoningController : public PollingComponent {
   void set_mode_changes_sensor(sensor::Sensor *s)       { mode_changes_sensor_ = s; }
   void set_short_cycle_sensor(binary_sensor::BinarySensor *s) { short_cycle_sensor_ = s; }
 
+  // --- Diagnostic publish policies (one per diagnostic sensor) ---
+  enum Diagnostic : uint8_t {
+    DIAG_ACTIVE_ZONES = 0,
+    DIAG_STAGE1_ELAPSED,
+    DIAG_MODE_CHANGES,
+    DIAG_SHORT_CYCLE,
+    NUM_DIAGNOSTICS
+  };
+  void set_diagnostic_policy(uint8_t diag, uint32_t min_interval_ms, uint32_t max_interval_ms, float deadband) {
+    if (diag < NUM_DIAGNOSTICS) diag_gates_[diag].set_policy({min_interval_ms, max_interval_ms, deadband});
+  }
+
+  // --- Runtime counter sensors (ControlCore::get_runtime(), slow cadence) ---
+  static constexpr uint8_t MAX_RUNTIME_SENSORS = 16;
+  static constexpr uint8_t RUNTIME_UNIT = 0xFF;  // zone value: central unit mode
+  // zone 0-based with a ZoneState value as `index`, or RUNTIME_UNIT with a
+  // mode index of central unit `unit`; hours in the state / mode, or entries
+  // when `entries`
+  void add_runtime_sensor(sensor::Sensor *s, uint8_t zone, uint8_t index, bool entries, uint8_t unit = 0) {
+    if (num_runtime_sensors_ < MAX_RUNTIME_SENSORS)
+      runtime_sensors_[num_runtime_sensors_++] = {s, zone, index, entries, unit};
+  }
+  void set_runtime_publish_interval(uint32_t ms) { runtime_publish_ms_ = ms; }
+
   // --- Optimization #10: anti-conflict select guard ---
   // Immediately re-applies the component's current mode, overriding any manual
-  // select change made from Home Assistant while auto_mode is active.
-  void reapply_mode() { apply_mode_(current_mode_); }
+  // select change made from Home Assistant while auto_mode is active. The
+  // select itself is set back by the next loop() (called from its on_value).
+  void reapply_mode() {
+    outputs_known_ = false;  // re-drive every output, not just the diff
+    select_mode_ = NO_MODE;  // the select shows the manual choice
+    apply_mode_(0, cores_[0].get_current_mode());
+    write_outputs_(output_word_());
+  }
+  // Log every event still in the rings, with its timestamp (bound to an API
+  // service in YAML, see packages/configurations.yml).
+  void dump_event_log() const {
+    for (uint8_t u = 0; u < num_units_; u++) cores_[u].events().dump();
+  }
+  // Unit 0's ring, which also holds the adapter's events
+  const EventLog &get_event_log() const { return cores_[0].events(); }
+  // false: events are only kept in the ring, formatted by dump_event_log()
+  void set_event_log_live(bool v) { event_log_live_ = v; }
+
+#ifdef OPEN_ZONING_STAGE_TIMING
+  // --- Stage timing (stage_timing: block, see stage_timing.h) ---
+  void set_stage_timing_publish_interval(uint32_t ms) { timing_publish_ms_ = ms; }
+  void set_stage_sensors(uint8_t stage, sensor::Sensor *max_us, sensor::Sensor *mean_us) {
+    if (stage >= StageTimings::NUM_STAGES) return;
+    stage_max_sensors_[stage] = max_us;
+    stage_mean_sensors_[stage] = mean_us;
+  }
+  StageTimings &get_stage_timings() { return timings_; }
+#endif
+
+#ifdef OPEN_ZONING_ALLOC_MONITOR
+  // --- Heap allocation monitor (alloc_monitor: block, see alloc_monitor.h) ---
+  void set_alloc_publish_interval(uint32_t ms) { alloc_publish_ms_ = ms; }
+  void set_allocations_sensor(sensor::Sensor *s) { allocations_sensor_ = s; }
+  void set_min_free_heap_sensor(sensor::Sensor *s) { min_free_heap_sensor_ = s; }
+#endif
+
   // Returns true while the component itself is driving the select entity,
   // allowing on_value callbacks to distinguish component vs. user changes.
   bool is_component_driving_select() const { return component_driving_select_; }
+  // Select calls made by the component (one per loop() at most, final mode only)
+  uint32_t get_select_syncs() const { return select_syncs_; }
+
+  // --- Time source ---
+  // Defaults to millis(). Replaceable so the pass logic can be driven by a
+  // virtual clock (replay / simulation builds).
+  using TimeSource = uint32_t (*)();
+  void set_time_source(TimeSource src) { time_source_ = src; }
 
   // --- Runtime getters (for template entities in YAML) ---
-  bool get_auto_mode() const { return auto_mode_; }
-  uint32_t get_min_cycle_time_ms() const { return min_cycle_time_ms_; }
-  uint32_t get_purge_duration_ms() const { return purge_duration_ms_; }
-  uint8_t get_min_active_zones() const { return min_active_zones_; }
+  bool get_auto_mode() const { return cores_[0].get_auto_mode(); }
+  uint32_t get_min_cycle_time_ms() const { return cores_[0].get_min_cycle_time_ms(); }
+  uint32_t get_purge_duration_ms() const { return cores_[0].get_purge_duration_ms(); }
+  uint8_t get_min_active_zones() const { return cores_[0].get_min_active_zones(); }
+  // Pipeline runs triggered by a timer deadline
+  uint32_t get_deadline_runs() const { return deadline_runs_; }
+  // Pipeline runs triggered by thermostat input edges (one per coalesced burst)
+  uint32_t get_event_runs() const { return event_runs_; }
 
  protected:
-  // --- Pass methods ---
-  void pass1_calc_zone_states_();
-  void pass1_5_short_cycle_protection_();
-  void pass2_purge_management_();
-  void pass2_5_minimum_demand_();
-  void pass3_priority_analysis_();
-  void pass4_damper_control_();
-  void pass5_output_control_();
+  // --- Pipeline ---
+  // Runs PASS 1–5 + state commit. periodic=false for event-driven runs.
+  void run_pipeline_(bool periodic);
+  void mark_dirty_();
+
+  // --- Deadline scheduling ---
+  // One "deadline" timeout at the earliest timer deadline of the units
+  // (ControlCore::next_deadline()), re-armed only when it moves.
+  bool deadline_armed_{false};
+  uint32_t deadline_ms_{0};
+  uint32_t deadline_runs_{0};
+  void schedule_deadline_();
+
+  // --- Adapter stages around ControlCore::evaluate() ---
+  CoreInput read_inputs_() const;
+  void apply_dampers_(uint16_t targets);     // damper targets → motor sequences
+  void apply_outputs_();                      // unit modes / LEDs → switches + select
+  uint16_t core_dampers_() const;  // each unit's damper targets over its own zones
+  void persist_state_();  // core state → journal (committed on its cadence)
+  void publish_zone_states_();
   void check_i2c_health_();
   void publish_diagnostics_();  // Optimization #3
 
-  // --- Damper operation queue ---
-  // Each damper change is split into 3 individual I2C operations
-  // processed one-per-loop-iteration for ESP8266 I2C reliability.
-  // This mimics how the old ESPHome scripts worked (yield between each action).
-  struct DamperOp {
+  // --- Damper motion ---
+  // dampers_ plans every motor at once (see DamperScheduler); loop()
+  // performs its writes, still one I2C operation per loop iteration for
+  // ESP8266 reliability: one switch write, or one latch write covering every
+  // due motor with damper_port. A new target merges into the plan in flight.
+  DamperScheduler dampers_;
+  uint8_t dampers_moved_{0};  // motors engaged since the plan started
+
+  void process_damper_switches_();
+  void process_damper_port_();
+  void finish_damper_plan_();
+
+  // --- Damper port (batched OLAT writes) ---
+  McpPort damper_port_;
+  bool damper_port_enabled_{false};
+  uint8_t led_heat_pin_{McpPort::NO_PIN};
+  uint8_t led_cool_pin_{McpPort::NO_PIN};
+  uint8_t led_fan_pin_{McpPort::NO_PIN};
+  uint8_t led_error_pin_{McpPort::NO_PIN};
+
+  // --- Central unit outputs and LEDs ---
+  // Output word: the ControlCore::UNIT_* bits of unit u in byte u, the LED_*
+  // bits above the last unit (LEDs: any unit heating / cooling / fan / in
+  // error). outputs_written_ shadows the last word written; only the bits
+  // that differ are written. Each channel goes to its expander shadow
+  // (output_port_ / damper_port_, one OLAT write per expander) or, unmapped,
+  // to its Switch.
+  struct OutputChannel {
     switch_::Switch *sw;
-    bool turn_on;
-    uint32_t delay_ms;  // ms to wait after previous op before executing
+    McpPort *port;  // nullptr: written through the switch
+    uint8_t pin;
+  };
+  static constexpr uint8_t NUM_UNIT_OUTPUTS = 7;
+  static constexpr uint8_t LED_SHIFT = 8 * MAX_UNITS;
+  static constexpr uint8_t NUM_OUTPUT_BITS = LED_SHIFT + 4;
+  OutputChannel out_channels_[NUM_OUTPUT_BITS]{};
+  uint32_t outputs_written_{0};
+  bool outputs_known_{false};  // false: next write drives every channel
+
+  McpPort output_port_;
+  bool output_port_enabled_{false};
+  struct UnitPins {
+    uint8_t pin[NUM_UNIT_OUTPUTS]{McpPort::NO_PIN, McpPort::NO_PIN, McpPort::NO_PIN, McpPort::NO_PIN,
+                                  McpPort::NO_PIN, McpPort::NO_PIN, McpPort::NO_PIN};
   };
-  static constexpr uint8_t MAX_DAMPER_OPS = MAX_ZONES * 3;  // 3 steps per damper change
-  DamperOp damper_ops_[MAX_DAMPER_OPS];
-  uint8_t dq_count_{0};
-  uint8_t dq_pos_{0};
-  unsigned long dq_next_ms_{0};
+  UnitPins output_pins_[MAX_UNITS];
+
+  void setup_output_channels_();
+  uint32_t output_word_() const;  // from the applied mode of every unit
+  void write_outputs_(uint32_t word);
+
+  // --- Thermostat input ports ---
+  // With input ports configured, loop() samples every expander once per
+  // input_sample_ms_ and the y1/y2/g/ob binary sensors become mirrors,
+  // published only when a debounced input changes.
+  ThermostatInputs inputs_;
+  uint32_t input_sample_ms_{50};
+  unsigned long input_next_sample_ms_{0};
+
+  void sample_inputs_();
+  void publish_input_mirrors_(InputWord previous, InputWord current);
+
+  // Damper pre-positioning: zones opened from the raw sample before the core
+  // decides (ControlCore::preposition_dampers()). A zone stays in
+  // prepositioned_ until the core opens its damper itself; when the raw call
+  // goes away first, its damper closes again.
+  bool preposition_{false};
+  uint16_t prepositioned_{0};
+  uint32_t prepositions_{0};
+  uint32_t preposition_rollbacks_{0};
+
+  uint16_t update_preposition_();  // returns prepositioned_
 
-  void queue_open_damper_(uint8_t zone);
-  void queue_close_damper_(uint8_t zone);
+  // --- Event log ---
+  // The passes record events in their unit's ring, the adapter in unit 0's;
+  // loop() formats at most EVENT_DRAIN_PER_LOOP of them per ring and
+  // iteration when live.
+  static constexpr uint8_t EVENT_DRAIN_PER_LOOP = 4;
+  bool event_log_live_{true};
+
+#ifdef OPEN_ZONING_STAGE_TIMING
+  // --- Stage timing ---
+  // Every stage runs inside an OZ_TIME_STAGE() scope; update() publishes
+  // the window max / mean of each stage every timing_publish_ms_.
+  StageTimings timings_;
+  sensor::Sensor *stage_max_sensors_[StageTimings::NUM_STAGES]{};
+  sensor::Sensor *stage_mean_sensors_[StageTimings::NUM_STAGES]{};
+  uint32_t timing_publish_ms_{60000};
+  uint32_t timing_next_publish_ms_{0};
+  void publish_stage_timings_();
+#endif
+
+#ifdef OPEN_ZONING_ALLOC_MONITOR
+  // --- Heap allocation monitor ---
+  // update(), loop() and the pipeline runs of the scheduler open an
+  // OZ_ALLOC_SCOPE(); update() publishes the counters every alloc_publish_ms_.
+  sensor::Sensor *allocations_sensor_{nullptr};
+  sensor::Sensor *min_free_heap_sensor_{nullptr};
+  uint32_t alloc_publish_ms_{60000};
+  uint32_t alloc_next_publish_ms_{0};
+  void publish_alloc_monitor_();
+#endif
+
+  // --- Clock ---
+  TimeSource time_source_{&millis};
+  unsigned long now_ms_{0};  // sampled once at the start of each pipeline run
+  uint32_t now_() const { return time_source_(); }
 
   // --- Central unit mode application ---
-  void apply_mode_(int mode);
+  void apply_mode_(uint8_t unit, uint8_t mode);
+  // Deferred select sync (loop()): one call for the last mode applied
+  void sync_mode_select_();
+  static constexpr uint8_t NO_MODE = 0xFF;
+
+  // --- Decision logic: one core per central unit ---
+  ControlCore cores_[MAX_UNITS];
+  uint16_t unit_zones_[MAX_UNITS]{0xFFFF};  // zones served by each unit (bit per zone)
+  uint8_t num_units_{1};
+  uint8_t unit_of_(uint8_t zone) const {
+    for (uint8_t u = 1; u < num_units_ && u < MAX_UNITS; u++) {
+      if (unit_zones_[u] & (1u << zone)) return u;
+    }
+    return 0;
+  }
 
   // --- Zone data ---
-  Zone zones_[MAX_ZONES];
+  ZoneEntities zones_[MAX_ZONES];
   uint8_t num_zones_{0};
+  uint16_t enabled_mask_{0xFFFF};     // bit per zone, all enabled by default
+  uint16_t ob_on_heat_mask_{0xFFFF};  // bit per zone, O/B → heating by default
 
-  // --- Configuration ---
-  uint32_t min_cycle_time_ms_{480000};    // 8 minutes default
-  uint32_t purge_duration_ms_{300000};    // 5 minutes default
-  uint32_t stage2_escalation_ms_{3600000}; // 1 hour default
+  // Commanded damper positions (bit per zone: 1 = open). A zone outside
+  // damper_known_ is in an unknown position — forces the first update to
+  // drive it.
+  uint16_t damper_open_{0};
+  uint16_t damper_known_{0};
 
-  // --- Central unit output switches ---
-  switch_::Switch *out_y1_{nullptr};
-  switch_::Switch *out_y2_{nullptr};
-  switch_::Switch *out_g_{nullptr};
-  switch_::Switch *out_ob_{nullptr};
-  switch_::Switch *out_w1e_{nullptr};
-  switch_::Switch *out_w2_{nullptr};
-  switch_::Switch *out_w3_{nullptr};
+  // --- Central unit output switches (Y1 Y2 G OB W1e W2 W3 per unit) ---
+  switch_::Switch *unit_out_[MAX_UNITS][NUM_UNIT_OUTPUTS]{};
 
   // --- LED indicator switches ---
   switch_::Switch *led_heat_{nullptr};
@@ -158,33 +520,69 @@ class OpenZoningController : public PollingComponent {
   select::Select *mode_select_{nullptr};
 
   // --- I2C watchdog ---
-  i2c::I2CBus *i2c_bus_{nullptr};
+  // Each periodic run checks every watched expander: recent successful
+  // traffic (i2c_meter_) counts as healthy, otherwise a 0-byte write probes
+  // it. One failing expander clears the health sensor. A reboot follows
+  // i2c_error_threshold_ failed checks in a row of a reboot expander (the
+  // inputs: without them no call is seen), or of all of them (stuck bus).
+  static constexpr uint8_t MAX_WATCHED = 4;
+  i2c::I2CBus *i2c_bus_{nullptr};  // &i2c_meter_ once a bus is set
+  MeteredBus i2c_meter_;
   binary_sensor::BinarySensor *i2c_health_sensor_{nullptr};
-  uint8_t i2c_error_count_{0};
+  uint8_t i2c_watched_[MAX_WATCHED]{0x20, 0x21, 0x22};
+  bool i2c_reboot_[MAX_WATCHED]{true, false, false};
+  uint8_t i2c_num_watched_{3};
+  bool i2c_watch_custom_{false};
+  uint8_t i2c_error_count_[MAX_WATCHED]{};  // consecutive failed checks per expander
   uint8_t i2c_error_threshold_{3};
+  uint32_t i2c_traffic_window_ms_{10000};
+  uint32_t i2c_probes_skipped_{0};
   bool i2c_healthy_{true};
 
-  // --- Minimum zone demand ---
-  uint8_t min_active_zones_{1};           // 1 = disabled (all single requests allowed)
-  uint32_t min_demand_override_ms_{1800000}; // 30 min emergency override
-  unsigned long min_demand_wait_start_ms_{0};
+  // --- Event-driven evaluation ---
+  // Thermostat input edges mark the controller dirty; a single coalesced
+  // pipeline run follows within event_latency_ms_. update() stays as the
+  // periodic safety net for timer expiry (purge, short-cycle, escalation).
+  bool event_driven_{true};
+  uint32_t event_latency_ms_{100};
+  bool dirty_{false};
+  bool event_eval_scheduled_{false};
+  uint32_t event_runs_{0};
 
   // --- Runtime state ---
-  bool zone_error_flag_{false};
-  int global_max_priority_{0};
-  int current_mode_{0};       // Tracks active mode index (0-7)
-  int last_active_mode_{0};   // 0=unknown, 1=heating, 2=cooling
-  bool auto_mode_{true};      // Auto mode enabled by default
-  unsigned long stage1_start_ms_{0};  // Stage 2 escalation timer
+  uint8_t applied_mode_[MAX_UNITS]{};  // last mode written to each unit's outputs (0-7)
   bool component_driving_select_{false};  // Optimization #10: true while component drives the select
-  ESPPreferenceObject last_active_mode_pref_;  // Optimization #5: flash persistence
+  bool select_pending_{false};            // unit 0 mode applied, select not synced yet
+  uint8_t select_mode_{NO_MODE};          // mode the select was last set to by the component
+  uint32_t select_syncs_{0};
+  StateJournal journal_;  // Optimizations #5 / #27: flash persistence
 
   // --- Optimization #3: diagnostic sensors ---
   sensor::Sensor *active_zones_sensor_{nullptr};
   sensor::Sensor *stage1_elapsed_sensor_{nullptr};
   sensor::Sensor *mode_changes_sensor_{nullptr};
   binary_sensor::BinarySensor *short_cycle_sensor_{nullptr};
-  uint32_t mode_change_count_{0};  // incremented at each real mode transition
+  struct RuntimeSensor {
+    sensor::Sensor *sensor;
+    uint8_t zone;   // RUNTIME_UNIT: mode counters
+    uint8_t index;  // ZoneState value or mode index
+    bool entries;   // false: hours
+    uint8_t unit;   // RUNTIME_UNIT sensors: central unit
+  };
+  RuntimeSensor runtime_sensors_[MAX_RUNTIME_SENSORS]{};
+  uint8_t num_runtime_sensors_{0};
+  uint32_t runtime_publish_ms_{900000};  // 15 min
+  uint32_t runtime_next_publish_ms_{0};
+  void publish_runtime_();
+  // Change-driven publishing: each run computes the values, the gates
+  // (indexed by Diagnostic) decide which ones leave as API frames. Defaults
+  // match the YAML schema.
+  PublishGate diag_gates_[NUM_DIAGNOSTICS]{
+      PublishGate({10000, 900000, 0.0f}),   // active zones
+      PublishGate({10000, 900000, 60.0f}),  // stage 1 elapsed (s)
+      PublishGate({10000, 900000, 0.0f}),   // mode changes
+      PublishGate({10000, 900000, 0.0f}),   // short cycle
+  };
 };
 
 }  // namespace open_zoning
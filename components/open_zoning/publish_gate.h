@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+namespace open_zoning {
+
+/// When one diagnostic value goes to Home Assistant.
+///
+/// A value is published when it moved by at least `deadband` (any change
+/// when 0) and `min_interval_ms` has passed since the previous publish. An
+/// unchanged value is republished once `max_interval_ms` has passed (0:
+/// never). A return to 0 ignores the deadband, so a reset is never held back.
+struct PublishPolicy {
+  uint32_t min_interval_ms{0};
+  uint32_t max_interval_ms{0};
+  float deadband{0.0f};
+};
+
+/// Applies a PublishPolicy to the successive values of one sensor.
+class PublishGate {
+ public:
+  explicit PublishGate(const PublishPolicy &policy = {}) : policy_(policy) {}
+
+  void set_policy(const PublishPolicy &policy) { policy_ = policy; }
+  const PublishPolicy &get_policy() const { return policy_; }
+
+  /// Returns true when `value` must be published now, and records it as the
+  /// last published value. The first value is always published.
+  bool check(float value, uint32_t now_ms) {
+    if (!published_) return commit_(value, now_ms);
+    const uint32_t since = now_ms - last_ms_;
+    const bool moved = value != last_ && (std::fabs(value - last_) >= policy_.deadband || value == 0.0f);
+    if (moved && since >= policy_.min_interval_ms) return commit_(value, now_ms);
+    if (policy_.max_interval_ms != 0 && since >= policy_.max_interval_ms) return commit_(value, now_ms);
+    return false;
+  }
+
+  /// Forget the last published value: the next check() publishes.
+  void reset() { published_ = false; }
+
+ protected:
+  bool commit_(float value, uint32_t now_ms) {
+    last_ = value;
+    last_ms_ = now_ms;
+    published_ = true;
+    return true;
+  }
+
+  PublishPolicy policy_;
+  float last_{0.0f};
+  uint32_t last_ms_{0};
+  bool published_{false};
+};
+
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,33 @@
+#include "runtime_stats.h"
+
+namespace esphome {
+namespace open_zoning {
+
+void RuntimeStats::start(uint32_t now_ms) {
+  for (auto &z : zones_) {
+    z = Counters<NUM_STATES>{};
+    z.since_ms = now_ms;
+  }
+  unit_ = Counters<NUM_MODES>{};
+  unit_.since_ms = now_ms;
+  started_ = true;
+}
+
+void RuntimeStats::zone_changed(uint8_t zone, ZoneState to, uint32_t now_ms) {
+  if (zone < MAX_ZONES) zones_[zone].enter(state_slot(to), now_ms);
+}
+
+void RuntimeStats::mode_changed(uint8_t to, uint32_t now_ms) {
+  if (to < NUM_MODES) unit_.enter(to, now_ms);
+}
+
+uint64_t RuntimeStats::zone_ms(uint8_t zone, ZoneState s, uint32_t now_ms) const {
+  return zone < MAX_ZONES ? zones_[zone].total(state_slot(s), now_ms) : 0;
+}
+
+uint64_t RuntimeStats::mode_ms(uint8_t mode, uint32_t now_ms) const {
+  return mode < NUM_MODES ? unit_.total(mode, now_ms) : 0;
+}
+
+}  // namespace open_zoning
+}  // namespace esphome
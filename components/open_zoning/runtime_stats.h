@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include "zone.h"
+
+namespace esphome {
+namespace open_zoning {
+
+/// Accumulated time and entry count of each zone state (per zone) and each
+/// central unit mode, since boot.
+///
+/// Updated only at transitions (ControlCore commit / mode change): leaving a
+/// state adds the time spent in it. The state in progress is added at query
+/// time, so a settled core that skips its evaluations still reads exact
+/// totals.
+class RuntimeStats {
+ public:
+  static constexpr uint8_t NUM_STATES = 9;  // ZoneState OFF … WAIT, then ERROR
+  static constexpr uint8_t NUM_MODES = 8;   // ControlCore mode indices
+
+  static uint8_t state_slot(ZoneState s) {
+    return s == ZoneState::ERROR ? NUM_STATES - 1 : static_cast<uint8_t>(s);
+  }
+
+  /// Every zone OFF and the unit in mode 0 from now_ms, counters cleared
+  void start(uint32_t now_ms);
+  bool started() const { return started_; }
+
+  void zone_changed(uint8_t zone, ZoneState to, uint32_t now_ms);
+  void mode_changed(uint8_t to, uint32_t now_ms);
+
+  uint64_t zone_ms(uint8_t zone, ZoneState s, uint32_t now_ms) const;
+  uint32_t zone_entries(uint8_t zone, ZoneState s) const { return zones_[zone].entries[state_slot(s)]; }
+  uint64_t mode_ms(uint8_t mode, uint32_t now_ms) const;
+  uint32_t mode_entries(uint8_t mode) const { return unit_.entries[mode]; }
+
+ protected:
+  template<uint8_t N> struct Counters {
+    uint64_t ms[N]{};
+    uint32_t entries[N]{};
+    uint32_t since_ms{0};  // entry time of the current slot
+    uint8_t current{0};
+
+    void enter(uint8_t slot, uint32_t now_ms) {
+      ms[current] += now_ms - since_ms;
+      entries[slot]++;
+      current = slot;
+      since_ms = now_ms;
+    }
+    uint64_t total(uint8_t slot, uint32_t now_ms) const {
+      return ms[slot] + (slot == current ? now_ms - since_ms : 0);
+    }
+  };
+
+  Counters<NUM_STATES> zones_[MAX_ZONES];
+  Counters<NUM_MODES> unit_;
+  bool started_{false};
+};
+
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,67 @@
+#include "stage_timing.h"
+
+#ifdef OPEN_ZONING_STAGE_TIMING
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+#include "zone.h"
+
+namespace esphome {
+namespace open_zoning {
+
+StageTimings::StageTimings() : clock_(&micros) {}
+
+const char *StageTimings::stage_name(Stage stage) {
+  switch (stage) {
+    case Stage::I2C_HEALTH:
+      return "i2c_health";
+    case Stage::PASS1:
+      return "pass1";
+    case Stage::PASS1_5:
+      return "pass1_5";
+    case Stage::PASS2:
+      return "pass2";
+    case Stage::PASS2_5:
+      return "pass2_5";
+    case Stage::PASS3:
+      return "pass3";
+    case Stage::PASS4:
+      return "pass4";
+    case Stage::PASS5:
+      return "pass5";
+    case Stage::COMMIT:
+      return "commit";
+    case Stage::APPLY_DAMPERS:
+      return "apply_dampers";
+    case Stage::APPLY_OUTPUTS:
+      return "apply_outputs";
+    case Stage::APPLY_MODE:
+      return "apply_mode";
+    case Stage::PUBLISH:
+      return "publish";
+    case Stage::PIPELINE:
+      return "pipeline";
+    case Stage::DAMPER_OP:
+      return "damper_op";
+    case Stage::INPUT_SAMPLE:
+      return "input_sample";
+    default:
+      return "unknown";
+  }
+}
+
+void StageTimings::dump() const {
+  ESP_LOGCONFIG(TAG, "  Stage timing (µs: count min/mean/max | <16 <64 <256 <1k <4k <16k <64k >=64k):");
+  for (uint8_t i = 0; i < NUM_STAGES; i++) {
+    const StageStats &s = stats_[i];
+    if (s.count == 0) continue;
+    const uint32_t *h = s.histogram;
+    ESP_LOGCONFIG(TAG, "    %-13s %6u %u/%u/%u | %u %u %u %u %u %u %u %u", stage_name(static_cast<Stage>(i)),
+                  s.count, s.min_us, s.mean_us(), s.max_us, h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7]);
+  }
+}
+
+}  // namespace open_zoning
+}  // namespace esphome
+
+#endif  // OPEN_ZONING_STAGE_TIMING
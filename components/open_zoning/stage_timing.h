@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include "esphome/core/defines.h"
+
+// Per-stage execution timing of update() and loop(). Compiled in only when
+// the YAML has a stage_timing: block (codegen defines OPEN_ZONING_STAGE_TIMING);
+// otherwise OZ_TIME_STAGE() expands to nothing and no timing state exists.
+
+namespace esphome {
+namespace open_zoning {
+
+/// Timed stages, in pipeline order (index into StageTimings)
+enum class Stage : uint8_t {
+  I2C_HEALTH,     // check_i2c_health_()
+  PASS1,          // zone states from the inputs
+  PASS1_5,        // short cycle protection
+  PASS2,          // purge
+  PASS2_5,        // minimum demand
+  PASS3,          // priority analysis
+  PASS4,          // damper targets
+  PASS5,          // mode / outputs
+  COMMIT,         // state commit
+  APPLY_DAMPERS,  // damper targets → queue / latch plan
+  APPLY_OUTPUTS,  // outputs, LEDs (apply_mode_ included)
+  APPLY_MODE,     // loop(): mode select sync (deferred from apply_mode_())
+  PUBLISH,        // zone states + diagnostics
+  PIPELINE,       // whole run_pipeline_()
+  DAMPER_OP,      // loop(): one damper op or one latch write
+  INPUT_SAMPLE,   // loop(): thermostat input sample
+  NUM_STAGES
+};
+
+#ifdef OPEN_ZONING_STAGE_TIMING
+
+/// Running statistics of one stage, in microseconds.
+struct StageStats {
+  // Log-scale histogram, factor 4 per bucket: <16, <64, <256, <1k, <4k,
+  // <16k, <64k, >=64k µs
+  static constexpr uint8_t NUM_BUCKETS = 8;
+
+  uint32_t count{0};
+  uint32_t min_us{UINT32_MAX};
+  uint32_t max_us{0};
+  uint64_t total_us{0};
+  uint32_t histogram[NUM_BUCKETS]{};
+  // Since the last take_window() (sensor publish)
+  uint32_t window_count{0};
+  uint32_t window_max_us{0};
+  uint64_t window_total_us{0};
+
+  static uint8_t bucket(uint32_t us) {
+    uint8_t b = 0;
+    for (us >>= 4; us != 0 && b < NUM_BUCKETS - 1; us >>= 2) b++;
+    return b;
+  }
+
+  void add(uint32_t us) {
+    count++;
+    if (us < min_us) min_us = us;
+    if (us > max_us) max_us = us;
+    total_us += us;
+    histogram[bucket(us)]++;
+    window_count++;
+    if (us > window_max_us) window_max_us = us;
+    window_total_us += us;
+  }
+  uint32_t mean_us() const { return count ? static_cast<uint32_t>(total_us / count) : 0; }
+  uint32_t window_mean_us() const { return window_count ? static_cast<uint32_t>(window_total_us / window_count) : 0; }
+  void reset_window() {
+    window_count = 0;
+    window_max_us = 0;
+    window_total_us = 0;
+  }
+};
+
+/// Statistics of every Stage, timed with a microsecond clock (micros() on
+/// the device, replaceable for the host build).
+class StageTimings {
+ public:
+  using MicrosSource = uint32_t (*)();
+  static constexpr uint8_t NUM_STAGES = static_cast<uint8_t>(Stage::NUM_STAGES);
+
+  StageTimings();
+  void set_clock(MicrosSource src) { clock_ = src; }
+  uint32_t now_us() const { return clock_(); }
+
+  void add(Stage stage, uint32_t us) { stats_[static_cast<uint8_t>(stage)].add(us); }
+  StageStats &get(Stage stage) { return stats_[static_cast<uint8_t>(stage)]; }
+  const StageStats &get(Stage stage) const { return stats_[static_cast<uint8_t>(stage)]; }
+
+  static const char *stage_name(Stage stage);
+  /// One line per stage that ran: count, min/mean/max and the histogram
+  void dump() const;
+
+ protected:
+  MicrosSource clock_;
+  StageStats stats_[NUM_STAGES];
+};
+
+/// Times the enclosing scope into one stage (no-op without StageTimings).
+class StageTimer {
+ public:
+  StageTimer(StageTimings *timings, Stage stage)
+      : timings_(timings), stage_(stage), start_us_(timings ? timings->now_us() : 0) {}
+  ~StageTimer() {
+    if (timings_) timings_->add(stage_, timings_->now_us() - start_us_);
+  }
+  StageTimer(const StageTimer &) = delete;
+  StageTimer &operator=(const StageTimer &) = delete;
+
+ protected:
+  StageTimings *timings_;
+  Stage stage_;
+  uint32_t start_us_;
+};
+
+#define OZ_TIME_STAGE_CAT_(a, b) a##b
+#define OZ_TIME_STAGE_VAR_(line) OZ_TIME_STAGE_CAT_(oz_stage_timer_, line)
+#define OZ_TIME_STAGE(timings, stage) ::esphome::open_zoning::StageTimer OZ_TIME_STAGE_VAR_(__LINE__)(timings, stage)
+
+#else
+
+#define OZ_TIME_STAGE(timings, stage) \
+  do { \
+  } while (0)
+
+#endif  // OPEN_ZONING_STAGE_TIMING
+
+}  // namespace open_zoning
+}  // namespace esphome
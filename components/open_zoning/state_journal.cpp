@@ -0,0 +1,73 @@
+#include "state_journal.h"
+#include <cstddef>
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+namespace open_zoning {
+
+uint32_t StateJournal::checksum_(const Record &r) {
+  const auto *bytes = reinterpret_cast<const uint8_t *>(&r);
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < offsetof(Record, checksum); i++) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+bool StateJournal::load(PersistedState *state) {
+  const uint32_t key = fnv1_hash("open_zoning_journal");
+  bool found = false;
+  slot_ = slots_ - 1;  // the first record goes to slot 0
+  for (uint8_t i = 0; i < slots_; i++) {
+    // In flash whatever restore_from_flash says: the ESP8266 default is RTC
+    // memory, lost on power loss
+    prefs_[i] = global_preferences->make_preference<Record>(key + i, true);
+    Record r{};
+    if (!prefs_[i].load(&r) || r.version != VERSION || r.checksum != checksum_(r)) continue;
+    if (found && static_cast<int32_t>(r.sequence - sequence_) <= 0) continue;
+    found = true;
+    sequence_ = r.sequence;
+    slot_ = i;
+    state_.last_active_mode = r.last_active_mode;
+    state_.mode_changes = r.mode_changes;
+  }
+  if (found) *state = state_;
+  return found;
+}
+
+bool StateJournal::update(const PersistedState &state, uint32_t now_ms, bool urgent) {
+  if (state != state_) {
+    state_ = state;
+    dirty_ = true;
+  }
+  return urgent && dirty_ && commit_(now_ms);
+}
+
+bool StateJournal::loop(uint32_t now_ms) {
+  if (!dirty_ || now_ms - last_commit_ms_ < interval_ms_) return false;
+  return commit_(now_ms);
+}
+
+bool StateJournal::flush(uint32_t now_ms) { return dirty_ && commit_(now_ms); }
+
+bool StateJournal::commit_(uint32_t now_ms) {
+  Record r{};
+  r.version = VERSION;
+  r.last_active_mode = state_.last_active_mode;
+  r.sequence = sequence_ + 1;
+  r.mode_changes = state_.mode_changes;
+  r.checksum = checksum_(r);
+
+  const uint8_t slot = static_cast<uint8_t>((slot_ + 1) % slots_);
+  last_commit_ms_ = now_ms;
+  if (!prefs_[slot].save(&r)) return false;  // stays dirty: retried at the next cadence
+  sequence_ = r.sequence;
+  slot_ = slot;
+  dirty_ = false;
+  commits_++;
+  return true;
+}
+
+}  // namespace open_zoning
+}  // namespace esphome
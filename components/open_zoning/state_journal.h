@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include "esphome/core/preferences.h"
+
+namespace esphome {
+namespace open_zoning {
+
+/// Controller state kept across reboots.
+struct PersistedState {
+  uint8_t last_active_mode{0};  // purge direction, 2 bits per central unit: 0 unknown, 1 heating, 2 cooling
+  uint32_t mode_changes{0};     // ControlCore::get_mode_change_count()
+
+  bool operator==(const PersistedState &o) const {
+    return last_active_mode == o.last_active_mode && mode_changes == o.mode_changes;
+  }
+  bool operator!=(const PersistedState &o) const { return !(*this == o); }
+};
+
+/// Batched, rotating persistence of PersistedState.
+///
+/// update() only records the state in RAM; a changed state is written as one
+/// versioned, checksummed record at most once per commit interval, at the
+/// next loop() after the interval, or at once by flush() (graceful shutdown)
+/// or an urgent update (purge direction). Successive records go to the next
+/// of `slots` preference entries, so each entry is written 1/slots as often;
+/// load() keeps the valid record with the highest sequence number, and a torn
+/// or corrupted write falls back to the previous one.
+class StateJournal {
+ public:
+  static constexpr uint8_t MAX_SLOTS = 8;
+  static constexpr uint8_t VERSION = 1;
+
+  void set_slots(uint8_t n) { slots_ = n < 1 ? 1 : (n > MAX_SLOTS ? MAX_SLOTS : n); }
+  void set_commit_interval(uint32_t ms) { interval_ms_ = ms; }
+  uint8_t get_slots() const { return slots_; }
+  uint32_t get_commit_interval() const { return interval_ms_; }
+
+  /// Opens the slots and restores the newest valid record into `state`.
+  /// Returns false (state untouched) when no slot holds one.
+  bool load(PersistedState *state);
+
+  /// New state; committed at once when `urgent`, else on the cadence.
+  /// Returns true when a record was written.
+  bool update(const PersistedState &state, uint32_t now_ms, bool urgent = false);
+  /// Commits the pending state when the interval has passed since the last commit
+  bool loop(uint32_t now_ms);
+  /// Commits the pending state now (graceful shutdown)
+  bool flush(uint32_t now_ms);
+
+  const PersistedState &get_state() const { return state_; }
+  bool is_dirty() const { return dirty_; }
+  uint32_t get_commits() const { return commits_; }
+  uint32_t get_sequence() const { return sequence_; }
+  uint8_t get_last_slot() const { return slot_; }
+
+ protected:
+  /// On-flash layout: fixed size, no padding, checksum last
+  struct Record {
+    uint8_t version;
+    uint8_t last_active_mode;
+    uint16_t reserved;
+    uint32_t sequence;
+    uint32_t mode_changes;
+    uint32_t checksum;  // FNV-1a of the bytes above
+  };
+  static uint32_t checksum_(const Record &r);
+  bool commit_(uint32_t now_ms);
+
+  ESPPreferenceObject prefs_[MAX_SLOTS];
+  uint8_t slots_{4};
+  uint32_t interval_ms_{600000};  // 10 min
+  PersistedState state_{};
+  bool dirty_{false};
+  uint32_t sequence_{0};   // of the newest record
+  uint8_t slot_{0};        // holding the newest record
+  uint32_t last_commit_ms_{0};
+  uint32_t commits_{0};
+};
+
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,88 @@
+#include "thermostat_inputs.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace open_zoning {
+
+void ThermostatInputs::set_bus(i2c::I2CBus *bus) {
+  for (uint8_t p = 0; p < num_ports_; p++) ports_[p].set_bus(bus);
+}
+
+uint8_t ThermostatInputs::add_port(uint8_t address, bool inverted) {
+  if (num_ports_ >= MAX_PORTS) {
+    ESP_LOGE(TAG, "Thermostat inputs: more than %d ports", MAX_PORTS);
+    return MAX_PORTS;
+  }
+  ports_[num_ports_].set_address(address);
+  ports_[num_ports_].set_inverted(inverted);
+  return num_ports_++;
+}
+
+void ThermostatInputs::set_zone_pins(uint8_t zone, uint8_t port, uint8_t y1, uint8_t y2, uint8_t g, uint8_t ob) {
+  if (zone >= MAX_ZONES || port >= MAX_PORTS) return;
+  const uint8_t pins[4] = {y1, y2, g, ob};  // ControlCore::IN_* bit order
+  for (uint8_t k = 0; k < 4; k++) {
+    if (pins[k] >= 16) continue;
+    map_[4 * zone + k] = static_cast<uint8_t>(port << 4 | pins[k]);
+    used_pins_[port] |= static_cast<uint16_t>(1u << pins[k]);
+  }
+}
+
+void ThermostatInputs::setup() {
+  for (uint8_t p = 0; p < num_ports_; p++) {
+    if (ports_[p].configure_inputs(used_pins_[p])) port_ready_ |= static_cast<uint8_t>(1u << p);
+  }
+}
+
+bool ThermostatInputs::sample(uint32_t now_ms) {
+  // One GPIOA/GPIOB read per expander
+  uint16_t levels[MAX_PORTS] = {};
+  uint8_t read_ok = 0;
+  for (uint8_t p = 0; p < num_ports_; p++) {
+    const uint8_t bit = static_cast<uint8_t>(1u << p);
+    if (!(port_ready_ & bit)) {
+      if (!ports_[p].configure_inputs(used_pins_[p])) {
+        read_errors_++;
+        continue;
+      }
+      port_ready_ |= bit;
+    }
+    if (ports_[p].read_gpio(&levels[p])) {
+      read_ok |= bit;
+    } else {
+      read_errors_++;
+    }
+  }
+  if (read_ok == 0) return false;
+
+  // Distribute the port bits to the zone nibbles
+  InputWord raw = raw_;
+  for (uint8_t k = 0; k < NUM_INPUTS; k++) {
+    const uint8_t m = map_[k];
+    if (m == NO_INPUT || !(read_ok & (1u << (m >> 4)))) continue;
+    if ((levels[m >> 4] >> (m & 0x0F)) & 1u) {
+      raw |= static_cast<InputWord>(1) << k;
+    } else {
+      raw &= ~(static_cast<InputWord>(1) << k);
+    }
+  }
+
+  // Debounce: restart the hold time of every input that moved, accept the
+  // inputs whose raw level differs from the debounced one for long enough
+  InputWord edges = raw ^ raw_;
+  raw_ = raw;
+  for (uint8_t k = 0; edges != 0; k++, edges >>= 1) {
+    if (edges & 1u) changed_at_[k] = now_ms;
+  }
+
+  InputWord pending = raw_ ^ stable_;
+  InputWord accepted = 0;
+  for (uint8_t k = 0; pending != 0; k++, pending >>= 1) {
+    if ((pending & 1u) && now_ms - changed_at_[k] >= debounce_ms_) accepted |= static_cast<InputWord>(1) << k;
+  }
+  stable_ ^= accepted;
+  return accepted != 0;
+}
+
+}  // namespace open_zoning
+}  // namespace esphome
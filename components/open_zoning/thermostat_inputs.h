@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include "esphome/components/i2c/i2c.h"
+#include "zone.h"
+#include "mcp_port.h"
+
+namespace esphome {
+namespace open_zoning {
+
+/// Thermostat inputs read by the component itself, instead of one gpio
+/// binary sensor per pin.
+///
+/// Each sample is one 16-bit GPIOA/GPIOB read per expander; the bits are
+/// distributed to the zone nibbles (ControlCore::IN_*) through the per-zone
+/// pin map, then debounced in software the way the delayed_on / delayed_off
+/// filters of packages/binary_sensors.yml did: a bit changes once its raw
+/// level has held for the whole debounce time.
+class ThermostatInputs {
+ public:
+  static constexpr uint8_t MAX_PORTS = 4;
+  static constexpr uint8_t NUM_INPUTS = MAX_ZONES * 4;
+
+  ThermostatInputs() {
+    for (auto &m : map_) m = NO_INPUT;
+  }
+
+  void set_bus(i2c::I2CBus *bus);
+  /// Returns the port index used by set_zone_pins(), or MAX_PORTS when full.
+  uint8_t add_port(uint8_t address, bool inverted);
+  /// Pins of one zone on port `port`, in ControlCore::IN_* order.
+  void set_zone_pins(uint8_t zone, uint8_t port, uint8_t y1, uint8_t y2, uint8_t g, uint8_t ob);
+  void set_debounce(uint32_t ms) { debounce_ms_ = ms; }
+
+  bool is_configured() const { return num_ports_ > 0 && ports_[0].is_configured(); }
+  uint8_t get_num_ports() const { return num_ports_; }
+  const McpPort &port(uint8_t i) const { return ports_[i]; }
+  uint32_t get_debounce_ms() const { return debounce_ms_; }
+
+  /// Configure the mapped pins as inputs with pull-ups. Ports that fail are
+  /// retried at each sample until they succeed.
+  void setup();
+
+  /// Read every port once and advance the debounce. Returns true when the
+  /// debounced word changed. A port that fails to read keeps its last bits.
+  bool sample(uint32_t now_ms);
+
+  /// Debounced inputs, one nibble per zone (CoreInput::thermostats layout)
+  InputWord get_state() const { return stable_; }
+  /// Last raw sample, same layout
+  InputWord get_raw() const { return raw_; }
+  uint32_t get_read_errors() const { return read_errors_; }
+
+ protected:
+  static constexpr uint8_t NO_INPUT = 0xFF;
+
+  McpPort ports_[MAX_PORTS];
+  uint8_t num_ports_{0};
+  uint16_t used_pins_[MAX_PORTS]{};   // mapped pins per port
+  uint8_t port_ready_{0};             // bit per port: input configuration done
+
+  // Input k (zone k/4, ControlCore::IN_* bit k%4): port << 4 | pin
+  uint8_t map_[NUM_INPUTS];
+
+  uint32_t debounce_ms_{1000};
+  InputWord raw_{0};
+  InputWord stable_{0};
+  uint32_t changed_at_[NUM_INPUTS]{};  // last raw edge of each input
+  uint32_t read_errors_{0};
+};
+
+}  // namespace open_zoning
+}  // namespace esphome
@@ -1,13 +1,27 @@
 #pragma once
 
 #include <cstdint>
-#include "esphome/components/binary_sensor/binary_sensor.h"
-#include "esphome/components/switch/switch.h"
-#include "esphome/components/text_sensor/text_sensor.h"
+#include <type_traits>
+#include "esphome/core/defines.h"
+#include "event_log.h"
 
 namespace esphome {
 namespace open_zoning {
 
+static const char *const TAG = "open_zoning";
+// Zones the component is built for: the codegen emits the number of
+// configured zones, so every per-zone array is sized to them exactly. The
+// 6-zone panel when built without it.
+#ifndef OPEN_ZONING_MAX_ZONES
+#define OPEN_ZONING_MAX_ZONES 6
+#endif
+static constexpr uint8_t MAX_ZONES = OPEN_ZONING_MAX_ZONES;
+static_assert(MAX_ZONES >= 1 && MAX_ZONES <= 16, "zone masks are 16 bits wide");
+
+/// Thermostat inputs, one nibble per zone (ControlCore::IN_*): 32 bits up to
+/// 8 zones, 64 beyond.
+using InputWord = std::conditional<(MAX_ZONES > 8), uint64_t, uint32_t>::type;
+
 /// Zone operating states — matches the original #define values
 enum class ZoneState : uint8_t {
   OFF = 0,
@@ -66,73 +80,23 @@ inline const char *state_to_string(ZoneState state) {
   }
 }
 
-/// Per-zone state container — holds all runtime data for one zone
+inline bool is_heating_state(ZoneState s) { return s == ZoneState::HEATING_STAGE1 || s == ZoneState::HEATING_STAGE2; }
+inline bool is_cooling_state(ZoneState s) { return s == ZoneState::COOLING_STAGE1 || s == ZoneState::COOLING_STAGE2; }
+
+/// Read-only snapshot of one zone's decision state (ControlCore::zone()).
+/// The live state is stored column-wise in ControlCore — one array per field,
+/// one bitmask per flag — so cross-zone questions are mask operations.
+/// Entity-free: the entity pointers live in the ESPHome adapter
+/// (OpenZoningController).
 struct Zone {
   uint8_t index{0};  // Zone number (0-based internally, 1-based for logging)
-
-  // --- Thermostat input sensors (set via codegen from __init__.py) ---
-  binary_sensor::BinarySensor *y1{nullptr};
-  binary_sensor::BinarySensor *y2{nullptr};
-  binary_sensor::BinarySensor *g{nullptr};
-  binary_sensor::BinarySensor *ob{nullptr};
-
-  // --- Damper output switches (set via codegen from __init__.py) ---
-  switch_::Switch *damper_open_sw{nullptr};
-  switch_::Switch *damper_close_sw{nullptr};
-
-  // --- Text sensor for zone state display in HA ---
-  text_sensor::TextSensor *state_sensor{nullptr};
-
-  // Current and next computed state
-  ZoneState state{ZoneState::OFF};
-  ZoneState state_new{ZoneState::OFF};
-
-  // Error detection
+  ZoneState state{ZoneState::OFF};  // committed at the last evaluation
   uint8_t error_count{0};
-
-  // Damper tracking
-  uint8_t damper_state{255};  // 255 = unknown (forces first update to drive correct position), 1 = open, 0 = closed
-
-  // Purge timer
-  unsigned long purge_end_ms{0};
-
-  // Short cycle protection
-  unsigned long active_start_ms{0};
+  bool purging{false};           // purge timer armed
+  bool in_cycle{false};          // active cycle under way (minimum cycle timer)
+  uint32_t purge_end_ms{0};      // 0 unless purging
+  uint32_t active_start_ms{0};   // 0 unless in_cycle
   bool short_cycle_protection{false};
-
-  // Zone enable flag (for future optimization #2)
-  bool enabled{true};
-
-  // O/B signal polarity (optimization #12)
-  // true  = O/B active → heating (default, most heat pumps)
-  // false = O/B active → cooling (some heat pumps, e.g. Carrier)
-  bool ob_on_heat{true};
-
-  // --- PASS 1: Calculate zone state from thermostat inputs ---
-  // Returns true if this zone triggered an error
-  bool calc_state();
-
-  // --- PASS 1.5: Short cycle protection ---
-  void apply_short_cycle_protection(unsigned long current_time, unsigned long min_cycle_time_ms);
-
-  // --- PASS 3: Priority ---
-  int get_priority() const { return state_to_priority(state_new); }
-
-  // --- Helper methods ---
-  bool is_heating() const {
-    return state_new == ZoneState::HEATING_STAGE1 || state_new == ZoneState::HEATING_STAGE2;
-  }
-  bool is_cooling() const {
-    return state_new == ZoneState::COOLING_STAGE1 || state_new == ZoneState::COOLING_STAGE2;
-  }
-  bool was_heating() const {
-    return state == ZoneState::HEATING_STAGE1 || state == ZoneState::HEATING_STAGE2;
-  }
-  bool was_cooling() const {
-    return state == ZoneState::COOLING_STAGE1 || state == ZoneState::COOLING_STAGE2;
-  }
-  bool is_active() const { return is_heating() || is_cooling(); }
-  bool was_active() const { return was_heating() || was_cooling(); }
 };
 
 }  // namespace open_zoning
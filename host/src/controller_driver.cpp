@@ -0,0 +1,74 @@
+#include "controller_driver.h"
+#include "platform.h"
+
+namespace esphome {
+namespace open_zoning {
+
+uint32_t ControllerDriver::host_now_() { return host::now(); }
+
+void ControllerDriver::wire(uint8_t num_zones) {
+  num_zones_ = num_zones > MAX_ZONES ? MAX_ZONES : num_zones;
+  ctrl_->set_num_zones(num_zones_);
+  ctrl_->set_time_source(&host::now);
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    ctrl_->set_zone_sensors(i, &y1_[i], &y2_[i], &g_[i], &ob_[i]);
+    ctrl_->set_zone_dampers(i, &open_[i], &close_[i]);
+    ctrl_->set_zone_state_sensor(i, &state_[i]);
+  }
+  ctrl_->set_out_y1(&out_[0]);
+  ctrl_->set_out_y2(&out_[1]);
+  ctrl_->set_out_g(&out_[2]);
+  ctrl_->set_out_ob(&out_[3]);
+  ctrl_->set_out_w1e(&out_[4]);
+  ctrl_->set_out_w2(&out_[5]);
+  ctrl_->set_out_w3(&out_[6]);
+  ctrl_->set_led_heat(&led_[0]);
+  ctrl_->set_led_cool(&led_[1]);
+  ctrl_->set_led_fan(&led_[2]);
+  ctrl_->set_led_error(&led_[3]);
+  ctrl_->set_mode_select(&select_);
+}
+
+void ControllerDriver::start() {
+  ctrl_->setup();
+  updates_ = 1;
+  elapsed_ms_ = 0;
+  ctrl_->update();
+  next_update_ms_ = host_now_() + ctrl_->get_update_interval();
+}
+
+void ControllerDriver::set_zone_input(uint8_t zone, uint8_t bits) {
+  if (zone >= num_zones_) return;
+  y1_[zone].publish_state(bits & ControlCore::IN_Y1);
+  y2_[zone].publish_state(bits & ControlCore::IN_Y2);
+  g_[zone].publish_state(bits & ControlCore::IN_G);
+  ob_[zone].publish_state(bits & ControlCore::IN_OB);
+}
+
+void ControllerDriver::run_until(uint32_t t) {
+  while (static_cast<int32_t>(host_now_() - t) < 0) {
+    const uint32_t now = host_now_();
+    if (static_cast<int32_t>(now - next_update_ms_) >= 0) {
+      next_update_ms_ += ctrl_->get_update_interval();
+      updates_++;
+      ctrl_->update();
+    }
+    host::run_scheduler();
+    ctrl_->loop();
+    if (on_loop_) on_loop_(now);
+    // The last step lands on t exactly
+    const uint32_t step = static_cast<int32_t>(t - now) < static_cast<int32_t>(LOOP_MS) ? t - now : LOOP_MS;
+    host::advance(step);
+    elapsed_ms_ += step;
+  }
+}
+
+uint16_t ControllerDriver::dampers_open() const {
+  uint16_t open = 0;
+  for (uint8_t i = 0; i < num_zones_; i++)
+    if (open_[i].state) open |= static_cast<uint16_t>(1u << i);
+  return open;
+}
+
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "open_zoning.h"
+
+namespace esphome {
+namespace open_zoning {
+
+/// Drives an OpenZoningController (the ESPHome adapter) on the host virtual
+/// clock the way ESPHome does: loop() every 16 ms after the due timeouts,
+/// update() every update interval, the first one at start(). The zones'
+/// thermostat binary sensors, damper switches and state text sensors, the
+/// unit outputs, the LEDs and the mode select are stand-in entities, so
+/// event runs, deadline runs and damper motor sequences are the adapter's.
+class ControllerDriver {
+ public:
+  static constexpr uint32_t LOOP_MS = 16;
+  using LoopCallback = std::function<void(uint32_t now_ms)>;
+
+  explicit ControllerDriver(OpenZoningController *ctrl) : ctrl_(ctrl) {}
+
+  /// Wire the entities of zones 0..n-1 (before start())
+  void wire(uint8_t num_zones);
+  /// setup() and the first update() at the current virtual time: inputs
+  /// set afterwards reach the passes through an event run
+  void start();
+  /// Called after every loop()
+  void set_on_loop(LoopCallback cb) { on_loop_ = std::move(cb); }
+
+  /// Thermostat inputs of a zone (ControlCore::IN_* bits), published on its
+  /// four binary sensors
+  void set_zone_input(uint8_t zone, uint8_t bits);
+
+  /// Advance the virtual clock to t, one loop() at a time
+  void run_until(uint32_t t);
+  void run_for(uint32_t ms) { run_until(host_now_() + ms); }
+
+  /// Pipeline runs: periodic updates, coalesced input events, deadlines
+  uint32_t get_evaluations() const {
+    return updates_ + ctrl_->get_event_runs() + ctrl_->get_deadline_runs();
+  }
+  /// Virtual time since start(), without the 32-bit wrap
+  uint64_t get_elapsed_ms() const { return elapsed_ms_; }
+
+  /// Dampers whose open motor output is on (bit per zone)
+  uint16_t dampers_open() const;
+  /// Zone state text sensor ("Heating Stage 1")
+  const std::string &zone_state(uint8_t zone) const { return state_[zone].state; }
+  /// Mode select index (the mode of unit 0)
+  size_t mode() const { return select_.active_index; }
+
+ protected:
+  static uint32_t host_now_();
+
+  OpenZoningController *ctrl_;
+  LoopCallback on_loop_;
+  uint8_t num_zones_{0};
+  uint32_t next_update_ms_{0};
+  uint32_t updates_{0};
+  uint64_t elapsed_ms_{0};
+
+  binary_sensor::BinarySensor y1_[MAX_ZONES], y2_[MAX_ZONES], g_[MAX_ZONES], ob_[MAX_ZONES];
+  switch_::Switch open_[MAX_ZONES], close_[MAX_ZONES];
+  text_sensor::TextSensor state_[MAX_ZONES];
+  switch_::Switch out_[7];  // Y1 Y2 G OB W1e W2 W3
+  switch_::Switch led_[4];  // heat cool fan error
+  select::Select select_;
+};
+
+}  // namespace open_zoning
+}  // namespace esphome
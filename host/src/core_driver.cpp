@@ -0,0 +1,64 @@
+#include "core_driver.h"
+#include "deadline.h"
+#include "platform.h"
+
+namespace esphome {
+namespace open_zoning {
+
+uint32_t CoreDriver::host_now_() { return host::now(); }
+
+void CoreDriver::start() {
+  next_poll_ms_ = host_now_();
+  event_pending_ = false;
+  elapsed_ms_ = 0;
+}
+
+void CoreDriver::set_input(const CoreInput &in) {
+  if (in.thermostats == input_.thermostats && in.enabled == input_.enabled && in.ob_on_heat == input_.ob_on_heat)
+    return;
+  input_ = in;
+  if (!event_pending_) {
+    event_pending_ = true;
+    event_ms_ = host_now_() + event_latency_ms_;
+  }
+}
+
+void CoreDriver::evaluate_(uint32_t now, bool periodic) {
+  const CoreOutput out = core_->evaluate(input_, now, periodic);
+  core_->events().drain(EventLog::CAPACITY);  // the adapter spreads this over loop()
+  evaluations_++;
+  last_was_poll_ = periodic;
+  if (on_evaluate_) on_evaluate_(now, out);
+}
+
+void CoreDriver::run_until(uint32_t t) {
+  for (;;) {
+    const uint32_t now = host_now_();
+    if (static_cast<int32_t>(t - now) < 0) return;
+
+    // Earliest of: poll, pending input event, core deadline, t
+    uint32_t next = t;
+    auto earlier = [&](uint32_t at) {
+      if (static_cast<int32_t>(at - now) >= 0 && static_cast<int32_t>(at - next) < 0) next = at;
+    };
+    earlier(next_poll_ms_);
+    if (event_pending_) earlier(event_ms_);
+    uint32_t deadline = 0;
+    const bool timed = core_->next_deadline(now, &deadline);
+    if (timed) earlier(deadline);
+
+    elapsed_ms_ += next - now;
+    host::set_now(next);
+    const bool poll = time_reached(next, next_poll_ms_);
+    const bool event = event_pending_ && time_reached(next, event_ms_);
+    const bool due = timed && time_reached(next, deadline);
+    if (poll) next_poll_ms_ = next + poll_ms_;
+    if (event) event_pending_ = false;
+    // One run covers everything due at this instant
+    if (poll || event || due) evaluate_(next, poll);
+    if (next == t) return;
+  }
+}
+
+}  // namespace open_zoning
+}  // namespace esphome
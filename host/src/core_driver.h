@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include "control_core.h"
+
+namespace esphome {
+namespace open_zoning {
+
+/// Drives a ControlCore on the host virtual clock the way
+/// OpenZoningController does on the device: a periodic run every poll
+/// interval (counts error inputs), a run event_latency after an input
+/// change and a run at the core's next timer deadline.
+class CoreDriver {
+ public:
+  using EvalCallback = std::function<void(uint32_t now_ms, const CoreOutput &out)>;
+
+  explicit CoreDriver(ControlCore *core) : core_(core) {}
+
+  void set_poll_interval(uint32_t ms) { poll_ms_ = ms; }
+  void set_event_latency(uint32_t ms) { event_latency_ms_ = ms; }
+  /// Called after every evaluation
+  void set_on_evaluate(EvalCallback cb) { on_evaluate_ = std::move(cb); }
+
+  /// Start at the current virtual time: first poll immediately.
+  void start();
+  /// New inputs from now on; an evaluation follows after the event latency.
+  void set_input(const CoreInput &in);
+  const CoreInput &input() const { return input_; }
+
+  /// Advance the virtual clock to t, running every evaluation due on the way
+  /// in time order.
+  void run_until(uint32_t t);
+  void run_for(uint32_t ms) { run_until(host_now_() + ms); }
+
+  uint32_t get_evaluations() const { return evaluations_; }
+  /// Whether the latest evaluation was a periodic poll (count_errors)
+  bool last_was_poll() const { return last_was_poll_; }
+  /// Virtual time since start(), without the 32-bit wrap
+  uint64_t get_elapsed_ms() const { return elapsed_ms_; }
+
+ protected:
+  static uint32_t host_now_();
+  void evaluate_(uint32_t now, bool periodic);
+
+  ControlCore *core_;
+  CoreInput input_{};
+  EvalCallback on_evaluate_;
+  uint32_t poll_ms_{10000};
+  uint32_t event_latency_ms_{100};
+  uint32_t next_poll_ms_{0};
+  bool event_pending_{false};
+  uint32_t event_ms_{0};
+  uint32_t evaluations_{0};
+  bool last_was_poll_{false};
+  uint64_t elapsed_ms_{0};
+};
+
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+
+#include "esphome/components/i2c/i2c.h"
+
+namespace esphome {
+namespace host {
+
+/// I2C bus with eight MCP23017 register files at 0x20–0x27. A write sets the
+/// register pointer (first byte) and stores the rest sequentially; a read
+/// returns registers from the pointer. set_dead() makes an address NACK.
+class FakeBus : public i2c::I2CBus {
+ public:
+  static constexpr uint8_t FIRST_ADDRESS = 0x20;
+  static constexpr uint8_t NUM_ADDRESSES = 8;
+  static constexpr uint8_t NUM_REGISTERS = 0x16;
+
+  using i2c::I2CBus::read;
+  using i2c::I2CBus::write;
+
+  i2c::ErrorCode readv(uint8_t address, i2c::ReadBuffer *buffers, size_t cnt) override {
+    Device *dev = this->device_(address);
+    if (dev == nullptr || dev->dead) return i2c::ERROR_NOT_ACKNOWLEDGED;
+    dev->reads++;
+    size_t k = 0;
+    for (size_t b = 0; b < cnt; b++) {
+      for (size_t i = 0; i < buffers[b].len; i++, k++) buffers[b].data[i] = dev->regs[(dev->pointer + k) % NUM_REGISTERS];
+    }
+    return i2c::ERROR_OK;
+  }
+
+  i2c::ErrorCode writev(uint8_t address, i2c::WriteBuffer *buffers, size_t cnt, bool stop) override {
+    Device *dev = this->device_(address);
+    if (dev == nullptr || dev->dead) return i2c::ERROR_NOT_ACKNOWLEDGED;
+    dev->writes++;
+    // First byte: register pointer, then sequential register data
+    size_t k = 0;
+    for (size_t b = 0; b < cnt; b++) {
+      for (size_t i = 0; i < buffers[b].len; i++, k++) {
+        if (k == 0) {
+          dev->pointer = buffers[b].data[i] % NUM_REGISTERS;
+        } else {
+          dev->regs[(dev->pointer + k - 1) % NUM_REGISTERS] = buffers[b].data[i];
+        }
+      }
+    }
+    return i2c::ERROR_OK;
+  }
+
+  void set_dead(uint8_t address, bool dead) {
+    if (Device *dev = this->device_(address)) dev->dead = dead;
+  }
+  /// GPIOA/GPIOB as one 16-bit port (bit 8 = GPB0)
+  void set_gpio(uint8_t address, uint16_t value) {
+    if (Device *dev = this->device_(address)) {
+      dev->regs[0x12] = value & 0xFF;
+      dev->regs[0x13] = value >> 8;
+    }
+  }
+  uint8_t get_register(uint8_t address, uint8_t reg) {
+    Device *dev = this->device_(address);
+    return dev ? dev->regs[reg % NUM_REGISTERS] : 0;
+  }
+  uint32_t get_transactions(uint8_t address) {
+    Device *dev = this->device_(address);
+    return dev ? dev->reads + dev->writes : 0;
+  }
+
+ protected:
+  struct Device {
+    uint8_t regs[NUM_REGISTERS]{};
+    uint8_t pointer{0};
+    bool dead{false};
+    uint32_t reads{0};
+    uint32_t writes{0};
+  };
+
+  Device *device_(uint8_t address) {
+    return address >= FIRST_ADDRESS && address < FIRST_ADDRESS + NUM_ADDRESSES ? &devices_[address - FIRST_ADDRESS]
+                                                                                : nullptr;
+  }
+
+  Device devices_[NUM_ADDRESSES];
+};
+
+}  // namespace host
+}  // namespace esphome
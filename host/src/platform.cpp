@@ -0,0 +1,200 @@
+#include "platform.h"
+
+#include <cstdarg>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "esphome/components/select/select.h"
+#include "esphome/core/application.h"
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+
+namespace esphome {
+
+namespace host {
+
+struct Timer {
+  const Component *owner;
+  std::string name;  // empty: anonymous, never replaced
+  uint32_t at;
+  uint32_t interval;  // 0 = one-shot
+  std::function<void()> f;
+};
+
+static uint32_t now_ms = 0;
+static std::vector<Timer> timers;
+static std::vector<std::function<void()>> deferred;
+static uint32_t reboots = 0;
+static int log_level = ESPHOME_LOG_LEVEL_WARN;
+static FILE *log_sink = stderr;
+static uint32_t logged = 0;
+static uint32_t log_epoch = 0;
+uint32_t preference_writes = 0;
+
+uint32_t now() { return now_ms; }
+void set_now(uint32_t ms) { now_ms = ms; }
+void advance(uint32_t ms) { now_ms += ms; }
+
+std::map<uint32_t, std::vector<uint8_t>> &preference_store() {
+  static std::map<uint32_t, std::vector<uint8_t>> store;
+  return store;
+}
+
+std::set<uint32_t> &rtc_preferences() {
+  static std::set<uint32_t> keys;
+  return keys;
+}
+
+void power_loss() {
+  for (uint32_t key : rtc_preferences()) preference_store().erase(key);
+  rtc_preferences().clear();
+}
+
+static void add_timer(const Component *owner, const std::string &name, uint32_t delay, uint32_t interval,
+                      std::function<void()> &&f) {
+  if (!name.empty()) {
+    for (auto it = timers.begin(); it != timers.end(); ++it) {
+      if (it->owner == owner && it->name == name) {
+        timers.erase(it);
+        break;
+      }
+    }
+  }
+  timers.push_back({owner, name, now_ms + delay, interval, std::move(f)});
+}
+
+static bool cancel_timer(const Component *owner, const std::string &name) {
+  for (auto it = timers.begin(); it != timers.end(); ++it) {
+    if (it->owner == owner && it->name == name) {
+      timers.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+void run_scheduler() {
+  // One due timer at a time: a callback may add or cancel timers
+  for (bool ran = true; ran;) {
+    ran = false;
+    for (size_t k = 0; k < timers.size(); k++) {
+      if (static_cast<int32_t>(now_ms - timers[k].at) < 0)
+        continue;
+      std::function<void()> f;
+      if (timers[k].interval > 0) {
+        timers[k].at += timers[k].interval;
+        f = timers[k].f;
+      } else {
+        f = std::move(timers[k].f);
+        timers.erase(timers.begin() + k);
+      }
+      f();
+      ran = true;
+      break;
+    }
+  }
+  std::vector<std::function<void()>> calls;
+  calls.swap(deferred);
+  for (auto &f : calls)
+    f();
+}
+
+void reset() {
+  now_ms = 0;
+  timers.clear();
+  deferred.clear();
+  preference_store().clear();
+  rtc_preferences().clear();
+  preference_writes = 0;
+  reboots = 0;
+  log_level = ESPHOME_LOG_LEVEL_WARN;
+  log_sink = stderr;
+  logged = 0;
+  log_epoch = 0;
+}
+
+uint32_t reboot_requests() { return reboots; }
+void set_log_level(int level) { log_level = level; }
+void set_log_sink(FILE *sink) { log_sink = sink; }
+void set_log_epoch(uint32_t ms) { log_epoch = ms; }
+uint32_t log_lines() { return logged; }
+
+void format_time(uint32_t ms, char *buf, size_t size) {
+  snprintf(buf, size, "%u:%02u:%02u.%03u", static_cast<unsigned>(ms / 3600000u),
+           static_cast<unsigned>(ms / 60000u % 60u), static_cast<unsigned>(ms / 1000u % 60u),
+           static_cast<unsigned>(ms % 1000u));
+}
+
+}  // namespace host
+
+// --- esphome/core ---
+
+uint32_t millis() { return host::now_ms; }
+uint32_t micros() { return host::now_ms * 1000u; }
+void delay(uint32_t ms) { host::now_ms += ms; }
+void yield() {}
+
+namespace setup_priority {
+const float DATA = 600.0f;
+const float HARDWARE = 800.0f;
+const float IO = 900.0f;
+}  // namespace setup_priority
+
+void Component::set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f) {
+  host::add_timer(this, name, timeout, 0, std::move(f));
+}
+void Component::set_timeout(uint32_t timeout, std::function<void()> &&f) {
+  host::add_timer(this, "", timeout, 0, std::move(f));
+}
+bool Component::cancel_timeout(const std::string &name) { return host::cancel_timer(this, name); }
+void Component::set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f) {
+  host::add_timer(this, name, interval, interval, std::move(f));
+}
+bool Component::cancel_interval(const std::string &name) { return host::cancel_timer(this, name); }
+void Component::defer(std::function<void()> &&f) { host::deferred.push_back(std::move(f)); }
+void Component::defer(const std::string &name, std::function<void()> &&f) { host::deferred.push_back(std::move(f)); }
+
+void Application::safe_reboot() { host::reboots++; }
+Application App;  // NOLINT
+
+static ESPPreferences host_preferences;
+ESPPreferences *global_preferences = &host_preferences;  // NOLINT
+
+uint32_t fnv1_hash(const std::string &str) {
+  uint32_t hash = 2166136261UL;
+  for (char c : str) {
+    hash *= 16777619UL;
+    hash ^= static_cast<uint8_t>(c);
+  }
+  return hash;
+}
+
+void esp_log_printf_(int level, const char *tag, int line, const char *format, ...) {
+  if (level > host::log_level)
+    return;
+  host::logged++;
+  if (host::log_sink == nullptr)
+    return;
+  static const char LETTERS[] = "NEWICDVV";
+  char at[24];
+  host::format_time(host::now_ms - host::log_epoch, at, sizeof(at));
+  std::fprintf(host::log_sink, "[%s][%c][%s:%d]: ", at, LETTERS[level & 7], tag, line);
+  va_list args;
+  va_start(args, format);
+  std::vfprintf(host::log_sink, format, args);
+  va_end(args);
+  std::fputc('\n', host::log_sink);
+}
+
+// Options of packages/select.yml, in index order
+select::Select::Select()
+    : options_{"Arrêt",           "Fan1",           "Clim Stage 1",    "Clim Stage 2",
+               "Chauffage Stage 1", "Chauffage Stage 2", "Purge Chauffage", "Purge Clim"} {}
+
+}  // namespace esphome
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace esphome {
+namespace host {
+
+// Virtual clock and scheduler of the host build. millis() returns now();
+// nothing moves unless the driver advances it, so a purge of 300 s takes
+// no wall time and every run is reproducible.
+
+uint32_t now();
+void set_now(uint32_t ms);
+void advance(uint32_t ms);
+
+/// Run the set_timeout() / set_interval() callbacks due at now() and the
+/// deferred calls, like one pass of the ESPHome scheduler.
+void run_scheduler();
+
+/// Clear clock, scheduler, preferences, reboot counter and log settings.
+void reset();
+
+/// App.safe_reboot() calls since reset()
+uint32_t reboot_requests();
+
+/// ESP_LOGx lines at or below level go to sink (nullptr: discarded).
+/// Defaults: ESPHOME_LOG_LEVEL_WARN to stderr.
+void set_log_level(int level);
+void set_log_sink(FILE *sink);
+/// Log timestamps are h:mm:ss.mmm since this instant (default 0)
+void set_log_epoch(uint32_t ms);
+/// Lines logged at or below the log level since reset()
+uint32_t log_lines();
+
+/// "h:mm:ss.mmm" of a duration
+void format_time(uint32_t ms, char *buf, size_t size);
+
+}  // namespace host
+}  // namespace esphome
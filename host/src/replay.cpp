@@ -0,0 +1,318 @@
+#include "replay.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include "controller_driver.h"
+#include "esphome/core/log.h"
+#include "platform.h"
+
+namespace esphome {
+namespace open_zoning {
+
+namespace {
+
+struct StateName {
+  const char *name;
+  ZoneState state;
+};
+const StateName STATE_NAMES[] = {
+    {"OFF", ZoneState::OFF},
+    {"FAN_ONLY", ZoneState::FAN_ONLY},
+    {"COOLING_STAGE1", ZoneState::COOLING_STAGE1},
+    {"COOLING_STAGE2", ZoneState::COOLING_STAGE2},
+    {"HEATING_STAGE1", ZoneState::HEATING_STAGE1},
+    {"HEATING_STAGE2", ZoneState::HEATING_STAGE2},
+    {"PURGE", ZoneState::PURGE},
+    {"WAIT", ZoneState::WAIT},
+    {"ERROR", ZoneState::ERROR},
+};
+
+// Settings whose value is a duration; the others are plain numbers or words
+const char *const DURATION_KEYS[] = {"min_cycle_time", "purge_duration", "stage2_escalation_delay",
+                                     "min_demand_override_delay", "damper_min_dwell", "damper_close_lookahead"};
+
+bool is_duration_key(const std::string &key) {
+  for (const char *k : DURATION_KEYS)
+    if (key == k) return true;
+  return false;
+}
+
+bool parse_index(const std::string &text, uint8_t limit, uint8_t *index) {
+  char *end = nullptr;
+  const long v = std::strtol(text.c_str(), &end, 10);
+  if (end == text.c_str() || *end != '\0' || v < 1 || v > limit) return false;
+  *index = static_cast<uint8_t>(v - 1);
+  return true;
+}
+
+std::string format_time(uint32_t ms) {
+  char buf[24];
+  host::format_time(ms, buf, sizeof(buf));
+  return buf;
+}
+
+}  // namespace
+
+bool ReplayScript::parse_duration(const std::string &text, uint32_t *ms) {
+  // One or more <number><unit> segments: "90s", "1h30min", "10min100ms"
+  const char *p = text.c_str();
+  double total = 0;
+  do {
+    char *end = nullptr;
+    const double v = std::strtod(p, &end);
+    if (end == p || v < 0) return false;
+    size_t len = 0;
+    while (end[len] != '\0' && (end[len] < '0' || end[len] > '9') && end[len] != '.') len++;
+    const std::string unit(end, len);
+    double scale;
+    if (unit.empty() || unit == "ms") scale = 1;
+    else if (unit == "s") scale = 1000;
+    else if (unit == "min") scale = 60000;
+    else if (unit == "h") scale = 3600000;
+    else if (unit == "d") scale = 86400000;
+    else return false;
+    total += v * scale;
+    p = end + len;
+  } while (*p != '\0');
+  if (total > 4294967295.0) return false;
+  *ms = static_cast<uint32_t>(total + 0.5);
+  return true;
+}
+
+bool ReplayScript::parse_setting_(const std::vector<std::string> &words, Step *step, std::string *why) const {
+  if (words.size() != 3) {
+    *why = "expected: set <key> <value>";
+    return false;
+  }
+  step->kind = Kind::SET;
+  step->key = words[1];
+  const std::string &v = words[2];
+  bool ok;
+  if (is_duration_key(step->key)) {
+    ok = parse_duration(v, &step->value);
+  } else if (step->key == "auto_mode" || step->key == "damper_idle_hold") {
+    ok = v == "on" || v == "off";
+    step->value = v == "on";
+  } else if (step->key == "min_active_zones") {
+    char *end = nullptr;
+    const long n = std::strtol(v.c_str(), &end, 10);
+    ok = end != v.c_str() && *end == '\0' && n >= 1 && n <= MAX_ZONES;
+    step->value = static_cast<uint32_t>(n);
+  } else {
+    *why = "unknown setting '" + step->key + "'";
+    return false;
+  }
+  if (!ok) *why = "bad value '" + v + "' for " + step->key;
+  return ok;
+}
+
+bool ReplayScript::parse(std::istream &in, std::string *error) {
+  std::string text;
+  int line = 0;
+  uint32_t last_at = 0;
+  bool timed = false;
+  while (std::getline(in, text)) {
+    line++;
+    const size_t hash = text.find('#');
+    if (hash != std::string::npos) text.resize(hash);
+    std::istringstream ss(text);
+    std::vector<std::string> words;
+    for (std::string w; ss >> w;) words.push_back(w);
+    if (words.empty()) continue;
+
+    std::string why;
+    auto fail = [&](const std::string &reason) {
+      *error = "line " + std::to_string(line) + ": " + reason;
+      return false;
+    };
+
+    Step step{0, line, Kind::END, 0, 0, {}};
+    if (words[0][0] == '@') {
+      const bool relative = words[0].size() > 1 && words[0][1] == '+';
+      uint32_t t;
+      if (!parse_duration(words[0].substr(relative ? 2 : 1), &t)) return fail("bad time '" + words[0] + "'");
+      step.at_ms = relative ? last_at + t : t;
+      if (step.at_ms < last_at) return fail("time goes backwards");
+      last_at = step.at_ms;
+      timed = true;
+      words.erase(words.begin());
+      if (words.empty()) return fail("missing command");
+    } else if (timed) {
+      return fail("header command after the first @ line");
+    }
+    step.at_ms = last_at;
+    const std::string &cmd = words[0];
+
+    if (!timed) {
+      if (cmd == "zones" && words.size() == 2) {
+        uint8_t n;
+        if (!parse_index(words[1], MAX_ZONES, &n)) return fail("zones must be 1.." + std::to_string(MAX_ZONES));
+        num_zones_ = n + 1;
+      } else if (cmd == "clock" && words.size() == 2) {
+        char *end = nullptr;
+        clock_start_ = static_cast<uint32_t>(std::strtoul(words[1].c_str(), &end, 10));
+        if (*end != '\0') return fail("bad clock '" + words[1] + "'");
+      } else if (cmd == "ob_heat" && words.size() == 2) {
+        uint8_t zone;
+        if (!parse_index(words[1], MAX_ZONES, &zone)) return fail("bad zone '" + words[1] + "'");
+        ob_on_heat_ |= static_cast<uint16_t>(1u << zone);
+      } else if (cmd == "set" && words.size() == 3 && words[1] == "update_interval") {
+        if (!parse_duration(words[2], &poll_ms_) || poll_ms_ == 0) return fail("bad update_interval");
+      } else if (cmd == "set" && words.size() == 3 && words[1] == "event_latency") {
+        if (!parse_duration(words[2], &event_latency_ms_)) return fail("bad event_latency");
+      } else if (cmd == "set") {
+        if (!parse_setting_(words, &step, &why)) return fail(why);
+        header_.push_back(step);
+      } else {
+        return fail("unknown header command '" + cmd + "'");
+      }
+      continue;
+    }
+
+    if (cmd == "zone" && words.size() >= 3) {
+      step.kind = Kind::ZONE;
+      if (!parse_index(words[1], num_zones_, &step.index)) return fail("bad zone '" + words[1] + "'");
+      for (size_t k = 2; k < words.size(); k++) {
+        const std::string &b = words[k];
+        if (b == "Y1") step.value |= ControlCore::IN_Y1;
+        else if (b == "Y2") step.value |= ControlCore::IN_Y2;
+        else if (b == "G") step.value |= ControlCore::IN_G;
+        else if (b == "OB") step.value |= ControlCore::IN_OB;
+        else if (b != "-") return fail("bad input '" + b + "' (Y1 Y2 G OB or -)");
+      }
+    } else if ((cmd == "enable" || cmd == "disable") && words.size() == 2) {
+      step.kind = cmd == "enable" ? Kind::ENABLE : Kind::DISABLE;
+      if (!parse_index(words[1], num_zones_, &step.index)) return fail("bad zone '" + words[1] + "'");
+    } else if (cmd == "set") {
+      if (!parse_setting_(words, &step, &why)) return fail(why);
+    } else if (cmd == "expect" && words.size() == 3 && words[1] == "mode") {
+      step.kind = Kind::EXPECT_MODE;
+      char *end = nullptr;
+      step.value = static_cast<uint32_t>(std::strtoul(words[2].c_str(), &end, 10));
+      if (*end != '\0' || step.value >= ControlCore::NUM_MODES) return fail("bad mode '" + words[2] + "'");
+    } else if (cmd == "expect" && words.size() == 4 && words[1] == "zone") {
+      step.kind = Kind::EXPECT_ZONE;
+      if (!parse_index(words[2], num_zones_, &step.index)) return fail("bad zone '" + words[2] + "'");
+      bool found = false;
+      for (const StateName &s : STATE_NAMES) {
+        if (words[3] == s.name) {
+          step.value = static_cast<uint32_t>(s.state);
+          found = true;
+        }
+      }
+      if (!found) return fail("bad zone state '" + words[3] + "'");
+    } else if (cmd == "expect" && words.size() == 4 && words[1] == "damper") {
+      step.kind = Kind::EXPECT_DAMPER;
+      if (!parse_index(words[2], num_zones_, &step.index)) return fail("bad zone '" + words[2] + "'");
+      if (words[3] != "open" && words[3] != "closed") return fail("expected open or closed");
+      step.value = words[3] == "open";
+    } else if (cmd == "end" && words.size() == 1) {
+      step.kind = Kind::END;
+    } else {
+      return fail("unknown command '" + cmd + "'");
+    }
+    steps_.push_back(step);
+  }
+  return true;
+}
+
+void ReplayScript::configure(ControlCore *core) const {
+  core->reset(num_zones_);
+  for (const Step &s : header_) apply_setting(core, s.key, s.value);
+}
+
+void ReplayScript::configure(OpenZoningController *ctrl) const {
+  ctrl->set_num_zones(num_zones_);
+  for (uint8_t i = 0; i < num_zones_; i++) ctrl->set_zone_ob_on_heat(i, (ob_on_heat_ >> i) & 1u);
+  ctrl->set_update_interval(poll_ms_);
+  ctrl->set_event_latency(event_latency_ms_);
+  for (const Step &s : header_) apply_setting(ctrl, s.key, s.value);
+}
+
+int run_replay(const ReplayScript &script, FILE *out, bool verbose) {
+  static OpenZoningController ctrl;  // kept off the stack like the component
+  static ControllerDriver driver(&ctrl);
+  driver.wire(script.num_zones());
+  script.configure(&ctrl);
+
+  host::set_now(script.clock_start());
+  host::set_log_epoch(script.clock_start());
+  host::set_log_sink(out);
+  FILE *report = out != nullptr ? out : stderr;
+  host::set_log_level(verbose ? ESPHOME_LOG_LEVEL_DEBUG : ESPHOME_LOG_LEVEL_INFO);
+
+  // Damper positions once every motor sequence has finished
+  uint16_t dampers = 0;
+  bool dampers_known = false;
+  driver.set_on_loop([&](uint32_t now) {
+    if (out == nullptr || !ctrl.get_damper_scheduler().idle()) return;
+    const uint16_t open_mask = driver.dampers_open();
+    if (dampers_known && open_mask == dampers) return;
+    char open[3 * MAX_ZONES + 1] = "";
+    for (uint8_t i = 0; i < script.num_zones(); i++) {
+      char z[4];
+      snprintf(z, sizeof(z), (open_mask >> i) & 1u ? "%u" : "-", i + 1);
+      strncat(open, z, sizeof(open) - strlen(open) - 1);
+    }
+    fprintf(out, "[%s] dampers open: %s\n", format_time(now - script.clock_start()).c_str(), open);
+    dampers = open_mask;
+    dampers_known = true;
+  });
+  driver.start();
+
+  int failures = 0;
+  for (const ReplayScript::Step &s : script.steps()) {
+    driver.run_until(script.clock_start() + s.at_ms);
+    const uint16_t bit = static_cast<uint16_t>(1u << s.index);
+    const std::string at = format_time(s.at_ms);
+    switch (s.kind) {
+      case ReplayScript::Kind::ZONE:
+        driver.set_zone_input(s.index, static_cast<uint8_t>(s.value));
+        break;
+      case ReplayScript::Kind::ENABLE:
+      case ReplayScript::Kind::DISABLE:
+        ctrl.set_zone_enabled(s.index, s.kind == ReplayScript::Kind::ENABLE);  // seen at the next update
+        break;
+      case ReplayScript::Kind::SET:
+        ReplayScript::apply_setting(&ctrl, s.key, s.value);
+        break;
+      case ReplayScript::Kind::EXPECT_MODE:
+        if (driver.mode() != s.value) {
+          const uint8_t mode = static_cast<uint8_t>(driver.mode());
+          fprintf(report, "[%s] FAIL line %d: mode %u (%s), expected %u (%s)\n", at.c_str(), s.line, mode,
+                  ControlCore::mode_to_string(mode), s.value,
+                  ControlCore::mode_to_string(static_cast<uint8_t>(s.value)));
+          failures++;
+        }
+        break;
+      case ReplayScript::Kind::EXPECT_ZONE: {
+        const char *expected = state_to_string(static_cast<ZoneState>(s.value));
+        if (driver.zone_state(s.index) != expected) {
+          fprintf(report, "[%s] FAIL line %d: zone %u is %s, expected %s\n", at.c_str(), s.line, s.index + 1,
+                  driver.zone_state(s.index).c_str(), expected);
+          failures++;
+        }
+        break;
+      }
+      case ReplayScript::Kind::EXPECT_DAMPER:
+        if (((driver.dampers_open() & bit) != 0) != (s.value != 0)) {
+          fprintf(report, "[%s] FAIL line %d: damper %u is %s\n", at.c_str(), s.line, s.index + 1,
+                  s.value ? "closed" : "open");
+          failures++;
+        }
+        break;
+      case ReplayScript::Kind::END:
+        break;
+    }
+  }
+  if (out != nullptr)
+    fprintf(out, "[%s] end: %u evaluations, %u mode changes, %d failed expectation(s)\n",
+            format_time(static_cast<uint32_t>(driver.get_elapsed_ms())).c_str(), driver.get_evaluations(),
+            ctrl.get_unit_core(0).get_mode_change_count(), failures);
+  return failures;
+}
+
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <istream>
+#include <string>
+#include <vector>
+#include "control_core.h"
+
+namespace esphome {
+namespace open_zoning {
+
+class OpenZoningController;
+
+/// Timestamped input script for ControlCore and OpenZoningController
+/// (host/scripts/*.oz).
+///
+///   # comment                      header (before the first @ line):
+///   zones 3                        zone count (<= MAX_ZONES)
+///   clock 4294900000               virtual millis() at time 0
+///   ob_heat 2                      zone 2: O/B active means heating
+///   set purge_duration 5min        any ControlCore setting, YAML key names
+///
+///   @0      zone 1 Y1 G            inputs of zone 1 from now on (- = none)
+///   @+8min  zone 1 -               time relative to the previous line
+///   @9min   disable 2 | enable 2
+///   @9min   set min_active_zones 2
+///   @10min  expect mode 6          mode index (select option order)
+///   @10min  expect zone 1 PURGE    ZoneState name
+///   @10min  expect damper 1 open   open | closed
+///   @2h     end                    run until then (default: last line)
+///
+/// Durations take ms, s, min, h or d, combined as in 1h30min (bare numbers
+/// are ms).
+class ReplayScript {
+ public:
+  enum class Kind : uint8_t { ZONE, ENABLE, DISABLE, SET, EXPECT_MODE, EXPECT_ZONE, EXPECT_DAMPER, END };
+
+  struct Step {
+    uint32_t at_ms;  // from the start of the script
+    int line;
+    Kind kind;
+    uint8_t index;   // zone, 0-based
+    uint32_t value;  // input bits, mode, ZoneState, damper open, setting value
+    std::string key; // SET
+  };
+
+  /// Parse a whole script. On error, returns false with "line N: reason".
+  bool parse(std::istream &in, std::string *error);
+
+  uint8_t num_zones() const { return num_zones_; }
+  uint32_t clock_start() const { return clock_start_; }
+  const std::vector<Step> &steps() const { return steps_; }
+
+  /// Configure a core for the script: reset(), header settings.
+  void configure(ControlCore *core) const;
+  /// Configure a controller for the script: zone count, O/B polarity,
+  /// update interval, event latency, header settings.
+  void configure(OpenZoningController *ctrl) const;
+  /// Initial O/B polarity of the zones (CoreInput::ob_on_heat)
+  uint16_t ob_on_heat() const { return ob_on_heat_; }
+  uint32_t poll_ms() const { return poll_ms_; }
+  uint32_t event_latency_ms() const { return event_latency_ms_; }
+
+  /// Apply a SET step to a ControlCore or an OpenZoningController (same
+  /// setter names): false for an unknown key
+  template<typename T> static bool apply_setting(T *target, const std::string &key, uint32_t value);
+
+  /// "250ms", "10s", "8min", "1h30min", "2d" or bare ms
+  static bool parse_duration(const std::string &text, uint32_t *ms);
+
+ protected:
+  bool parse_setting_(const std::vector<std::string> &words, Step *step, std::string *why) const;
+
+  uint8_t num_zones_{MAX_ZONES};
+  uint32_t clock_start_{0};
+  uint16_t ob_on_heat_{0};
+  uint32_t poll_ms_{10000};
+  uint32_t event_latency_ms_{100};
+  std::vector<Step> header_;  // SET steps before the first @ line
+  std::vector<Step> steps_;
+};
+
+template<typename T> bool ReplayScript::apply_setting(T *target, const std::string &key, uint32_t value) {
+  if (key == "min_cycle_time") target->set_min_cycle_time(value);
+  else if (key == "purge_duration") target->set_purge_duration(value);
+  else if (key == "stage2_escalation_delay") target->set_stage2_escalation_delay(value);
+  else if (key == "min_demand_override_delay") target->set_min_demand_override_delay(value);
+  else if (key == "min_active_zones") target->set_min_active_zones(static_cast<uint8_t>(value));
+  else if (key == "auto_mode") target->set_auto_mode(value != 0);
+  else if (key == "damper_min_dwell") target->set_damper_min_dwell(value);
+  else if (key == "damper_idle_hold") target->set_damper_idle_hold(value != 0);
+  else if (key == "damper_close_lookahead") target->set_damper_close_lookahead(value);
+  else return false;
+  return true;
+}
+
+/// Runs a ReplayScript through the whole controller (ControllerDriver:
+/// binary sensor edges, event and deadline runs, damper motor switches,
+/// mode select) and prints its log with the damper changes to out
+/// (nullptr: failed expectations only, to stderr). Returns the number of
+/// failed expectations.
+int run_replay(const ReplayScript &script, FILE *out, bool verbose);
+
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,168 @@
+#include "thermal_plant.h"
+
+#include <cmath>
+
+#include "deadline.h"
+#include "platform.h"
+
+namespace esphome {
+namespace open_zoning {
+
+namespace {
+constexpr double DAY_MS = 86400000.0;
+constexpr double TWO_PI = 6.283185307179586;
+}  // namespace
+
+void ThermalPlant::set_num_zones(uint8_t n) {
+  num_zones_ = n > MAX_ZONES ? MAX_ZONES : n;
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    PlantZone z;
+    z.capacity_kj_per_k = 8000.0f - 1500.0f * (i % 3);
+    z.loss_kw_per_k = 0.05f + 0.01f * (i % 3);
+    if (i % 3 == 1) z.solar_kw = 2.5f;
+    z.heat_setpoint = 20.5f + 0.5f * (i % 2);
+    zones_[i] = z;
+  }
+}
+
+float ThermalPlant::outdoor_c(uint64_t t_ms) const {
+  const double day = std::fmod(static_cast<double>(t_ms), DAY_MS) / DAY_MS;
+  return outdoor_mean_c_ + outdoor_amplitude_c_ * static_cast<float>(std::cos(TWO_PI * (day - 15.0 / 24.0)));
+}
+
+float ThermalPlant::sun(uint64_t t_ms) {
+  const double hour = std::fmod(static_cast<double>(t_ms), DAY_MS) / 3600000.0;
+  if (hour < 6.0 || hour > 18.0) return 0.0f;
+  return static_cast<float>(std::sin(TWO_PI * (hour - 6.0) / 24.0));
+}
+
+// Heat delivered by the unit in a mode (kW, negative when cooling)
+float ThermalPlant::delivered_kw_(uint8_t mode) const {
+  const uint8_t unit = ControlCore::mode_unit_bits(mode);
+  if (!(unit & ControlCore::UNIT_G)) return 0.0f;
+  const float sign = unit & ControlCore::UNIT_OB ? -1.0f : 1.0f;
+  if (!(unit & ControlCore::UNIT_Y1)) return sign * unit_.stage1_kw * unit_.purge_fraction;
+  return sign * (unit & ControlCore::UNIT_Y2 ? unit_.stage2_kw : unit_.stage1_kw);
+}
+
+void ThermalPlant::step(uint64_t t_ms, uint32_t dt_ms, uint8_t mode, uint16_t dampers) {
+  if (dt_ms == 0) return;
+  const float outdoor = outdoor_c(t_ms);
+  const float sun_factor = sun(t_ms);
+  uint8_t open = 0;
+  for (uint8_t i = 0; i < num_zones_; i++) open += (dampers >> i) & 1u;
+  const float supply = open ? delivered_kw_(mode) / open : 0.0f;
+  const float dt_s = dt_ms / 1000.0f;
+
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    PlantZone &z = zones_[i];
+    float gain = z.internal_kw + z.solar_kw * sun_factor + z.loss_kw_per_k * (outdoor - z.temperature);
+    if ((dampers >> i) & 1u) gain += supply;
+    z.temperature += gain * dt_s / z.capacity_kj_per_k;
+  }
+}
+
+InputWord ThermalPlant::thermostats() {
+  InputWord word = 0;
+  for (uint8_t i = 0; i < num_zones_; i++) {
+    PlantZone &z = zones_[i];
+    const float t = z.temperature;
+    // Calls start past the differential and end at the setpoint; a new
+    // call starts without stage 2
+    const bool was_heating = z.heating, was_cooling = z.cooling;
+    z.heating = was_heating ? t < z.heat_setpoint : !was_cooling && t < z.heat_setpoint - z.differential;
+    z.cooling = was_cooling ? t > z.cool_setpoint : !was_heating && t > z.cool_setpoint + z.differential;
+    if (!(z.heating && was_heating) && !(z.cooling && was_cooling)) z.stage2 = false;
+    if (z.heating) z.stage2 = t < z.heat_setpoint - (z.stage2 ? z.differential : z.stage2_offset);
+    else if (z.cooling) z.stage2 = t > z.cool_setpoint + (z.stage2 ? z.differential : z.stage2_offset);
+    else z.stage2 = false;
+
+    uint8_t bits = 0;
+    if (z.heating || z.cooling) bits = ControlCore::IN_Y1 | ControlCore::IN_G;
+    if (z.stage2) bits |= ControlCore::IN_Y2;
+    if (z.cooling) bits |= ControlCore::IN_OB;
+    word |= static_cast<InputWord>(bits) << (4 * i);
+  }
+  return word;
+}
+
+// ============================================================================
+// Closed loop
+// ============================================================================
+
+PlantLoop::PlantLoop(ControlCore *core, ThermalPlant *plant, uint32_t sample_ms)
+    : core_(core), plant_(plant), driver_(core), sample_ms_(sample_ms) {
+  driver_.set_on_evaluate([this](uint32_t now, const CoreOutput &out) { this->on_evaluate_(now, out); });
+}
+
+void PlantLoop::start() {
+  metrics_ = PlantMetrics{};
+  input_ = CoreInput{};
+  input_.enabled = static_cast<uint16_t>((1u << plant_->get_num_zones()) - 1);
+  applied_ = core_->get_output();
+  applied_.dampers = input_.enabled;  // at rest every damper is open
+  last_ms_ = host::now();
+  driver_.set_input(input_);
+  driver_.start();
+}
+
+// Integrate the plant and the equipment counters up to now with the
+// outputs in force since the last evaluation
+void PlantLoop::advance_to_(uint32_t now) {
+  const uint32_t dt = now - last_ms_;
+  if (dt == 0) return;
+  plant_->step(metrics_.elapsed_ms, dt, applied_.mode, applied_.dampers);
+
+  if (applied_.unit & ControlCore::UNIT_Y1) metrics_.compressor_ms += dt;
+  if (applied_.unit & ControlCore::UNIT_Y2) metrics_.stage2_ms += dt;
+  if (applied_.unit & ControlCore::UNIT_G) {
+    metrics_.fan_ms += dt;
+    if (!(applied_.unit & ControlCore::UNIT_Y1)) metrics_.purge_fan_ms += dt;
+  }
+  for (uint8_t i = 0; i < plant_->get_num_zones(); i++) {
+    const PlantZone &z = plant_->zone(i);
+    if (z.temperature < z.heat_setpoint - 1.0f || z.temperature > z.cool_setpoint + 1.0f)
+      metrics_.zones[i].unmet_ms += dt;
+  }
+  metrics_.elapsed_ms += dt;
+  last_ms_ = now;
+}
+
+void PlantLoop::on_evaluate_(uint32_t now, const CoreOutput &out) {
+  advance_to_(now);
+  if ((out.unit & ControlCore::UNIT_Y1) && !(applied_.unit & ControlCore::UNIT_Y1)) metrics_.compressor_starts++;
+  const uint16_t moved = out.dampers ^ applied_.dampers;
+  for (uint8_t i = 0; i < plant_->get_num_zones(); i++) metrics_.zones[i].damper_moves += (moved >> i) & 1u;
+  applied_ = out;
+}
+
+void PlantLoop::run_for(uint64_t ms) {
+  const uint64_t end = metrics_.elapsed_ms + ms;
+  while (metrics_.elapsed_ms < end) {
+    // Thermostats: call edges start and stop the time-to-setpoint clock
+    const InputWord before = input_.thermostats;
+    input_.thermostats = plant_->thermostats();
+    for (uint8_t i = 0; i < plant_->get_num_zones(); i++) {
+      const bool was = (before >> (4 * i)) & ControlCore::IN_Y1;
+      const bool is = (input_.thermostats >> (4 * i)) & ControlCore::IN_Y1;
+      PlantMetrics::ZoneMetrics &m = metrics_.zones[i];
+      if (is && !was) {
+        m.calls++;
+        call_start_ms_[i] = host::now();
+      } else if (was && !is) {
+        const uint64_t took = host::now() - call_start_ms_[i];
+        m.satisfied++;
+        m.to_setpoint_ms += took;
+        if (took > m.max_to_setpoint_ms) m.max_to_setpoint_ms = took;
+      }
+    }
+    driver_.set_input(input_);
+
+    const uint64_t left = end - metrics_.elapsed_ms;
+    driver_.run_for(static_cast<uint32_t>(left < sample_ms_ ? left : sample_ms_));
+    advance_to_(host::now());
+  }
+}
+
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include "control_core.h"
+#include "core_driver.h"
+
+namespace esphome {
+namespace open_zoning {
+
+/// One zone of the simulated building: a single RC node (air and
+/// structure lumped) losing heat to the outdoor air, with internal and
+/// solar gains, and its two-stage thermostat.
+struct PlantZone {
+  float capacity_kj_per_k{8000};  // C
+  float loss_kw_per_k{0.06f};     // UA = 1/R
+  float internal_kw{0.2f};
+  float solar_kw{0.3f};  // peak at solar noon, none at night
+  float heat_setpoint{20.5f};
+  float cool_setpoint{24.0f};
+  float temperature{21.0f};
+
+  // Thermostat: a call starts `differential` past the setpoint and ends at
+  // the setpoint; stage 2 (Y2) joins `stage2_offset` past it.
+  float differential{0.3f};
+  float stage2_offset{1.5f};
+  bool heating{false};
+  bool cooling{false};
+  bool stage2{false};
+};
+
+/// Building and central unit driven by the controller outputs. Temperatures
+/// in °C, capacities in kW; the air of the running unit is shared evenly by
+/// the open dampers. O/B active means cooling at every thermostat.
+class ThermalPlant {
+ public:
+  struct Unit {
+    float stage1_kw{6.0f};
+    float stage2_kw{9.0f};
+    float purge_fraction{0.2f};  // of stage 1, delivered by the fan while the coil drains
+  };
+
+  /// Zones with varied defaults: every third zone gets the sun (cooling
+  /// calls on a mild afternoon while the others still heat)
+  void set_num_zones(uint8_t n);
+  uint8_t get_num_zones() const { return num_zones_; }
+  PlantZone &zone(uint8_t i) { return zones_[i]; }
+  const PlantZone &zone(uint8_t i) const { return zones_[i]; }
+  Unit &unit() { return unit_; }
+
+  /// Outdoor air: daily sine around `mean_c`, warmest at 15 h, coldest at 3 h
+  void set_weather(float mean_c, float amplitude_c) {
+    outdoor_mean_c_ = mean_c;
+    outdoor_amplitude_c_ = amplitude_c;
+  }
+  float outdoor_c(uint64_t t_ms) const;
+  /// Solar gain factor 0..1 (sine between 6 h and 18 h)
+  static float sun(uint64_t t_ms);
+
+  /// Advance every zone by dt with the mode and the damper mask held
+  /// constant. t_ms: time since midnight of the first day.
+  void step(uint64_t t_ms, uint32_t dt_ms, uint8_t mode, uint16_t dampers);
+
+  /// Thermostat calls after their hysteresis (CoreInput::thermostats)
+  InputWord thermostats();
+
+ protected:
+  float delivered_kw_(uint8_t mode) const;
+
+  PlantZone zones_[MAX_ZONES];
+  uint8_t num_zones_{0};
+  Unit unit_;
+  float outdoor_mean_c_{8.0f};
+  float outdoor_amplitude_c_{7.0f};
+};
+
+/// Equipment use over a closed-loop run
+struct PlantMetrics {
+  struct ZoneMetrics {
+    uint32_t calls{0};          // thermostat calls started
+    uint32_t satisfied{0};      // calls that reached the setpoint
+    uint64_t to_setpoint_ms{0};  // sum over the satisfied calls
+    uint64_t max_to_setpoint_ms{0};
+    uint32_t damper_moves{0};
+    uint64_t unmet_ms{0};  // more than 1 °C outside the setpoints
+  };
+
+  uint64_t elapsed_ms{0};
+  uint32_t compressor_starts{0};
+  uint64_t compressor_ms{0};
+  uint64_t stage2_ms{0};
+  uint64_t fan_ms{0};
+  uint64_t purge_fan_ms{0};
+  ZoneMetrics zones[MAX_ZONES];
+
+  double hours(uint64_t ms) const { return ms / 3600000.0; }
+  double starts_per_hour() const { return elapsed_ms ? compressor_starts / hours(elapsed_ms) : 0; }
+};
+
+/// Closes the loop: the plant's thermostats feed a ControlCore through a
+/// CoreDriver (polls, input events and deadlines as on the device), and
+/// the core's mode and dampers heat or cool the plant between evaluations.
+class PlantLoop {
+ public:
+  /// Thermostats are sampled every sample_ms of virtual time
+  PlantLoop(ControlCore *core, ThermalPlant *plant, uint32_t sample_ms = 10000);
+
+  void start();
+  void run_for(uint64_t ms);
+  const PlantMetrics &metrics() const { return metrics_; }
+  CoreDriver &driver() { return driver_; }
+
+ protected:
+  void advance_to_(uint32_t now);
+  void on_evaluate_(uint32_t now, const CoreOutput &out);
+
+  ControlCore *core_;
+  ThermalPlant *plant_;
+  CoreDriver driver_;
+  uint32_t sample_ms_;
+  CoreInput input_{};
+  CoreOutput applied_{};  // outputs in force since last_ms_
+  uint32_t last_ms_{0};
+  uint32_t call_start_ms_[MAX_ZONES]{};
+  PlantMetrics metrics_;
+};
+
+}  // namespace open_zoning
+}  // namespace esphome
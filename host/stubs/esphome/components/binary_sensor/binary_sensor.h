@@ -0,0 +1,40 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <utility>
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+namespace binary_sensor {
+
+/// Host stand-in: a named boolean with state callbacks (thermostat inputs,
+/// diagnostics).
+class BinarySensor {
+ public:
+  BinarySensor() = default;
+  explicit BinarySensor(std::string name) : name_(std::move(name)) {}
+
+  void publish_state(bool state) {
+    const bool changed = !this->has_state_ || state != this->state;
+    this->state = state;
+    this->has_state_ = true;
+    this->publish_count++;
+    if (changed)
+      this->state_callback_.call(state);
+  }
+  bool has_state() const { return this->has_state_; }
+  const std::string &get_name() const { return this->name_; }
+  void add_on_state_callback(std::function<void(bool)> &&callback) { this->state_callback_.add(std::move(callback)); }
+
+  bool state{false};
+  uint32_t publish_count{0};
+
+ protected:
+  std::string name_;
+  bool has_state_{false};
+  CallbackManager<void(bool)> state_callback_;
+};
+
+}  // namespace binary_sensor
+}  // namespace esphome
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace esphome {
+namespace select {
+
+class Select;
+
+class SelectCall {
+ public:
+  explicit SelectCall(Select *parent) : parent_(parent) {}
+  SelectCall &set_index(size_t index) {
+    this->index_ = index;
+    return *this;
+  }
+  void perform();
+
+ protected:
+  Select *parent_;
+  size_t index_{0};
+};
+
+/// Host stand-in: the options of select.yml, perform() publishes the option
+/// (the on_value lambda of the YAML is not modelled).
+class Select {
+ public:
+  Select();
+  explicit Select(std::string name) : Select() { this->name_ = std::move(name); }
+
+  SelectCall make_call() { return SelectCall(this); }
+  bool has_index(size_t index) const { return index < this->options_.size(); }
+  void publish_state(const std::string &state) { this->state = state; }
+  const std::string &get_name() const { return this->name_; }
+
+  std::string state;
+  size_t active_index{0};
+  uint32_t perform_count{0};
+
+ protected:
+  friend class SelectCall;
+  std::string name_;
+  std::vector<std::string> options_;
+};
+
+inline void SelectCall::perform() {
+  if (!this->parent_->has_index(this->index_))
+    return;
+  this->parent_->active_index = this->index_;
+  this->parent_->perform_count++;
+  this->parent_->publish_state(this->parent_->options_[this->index_]);
+}
+
+}  // namespace select
+}  // namespace esphome
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace esphome {
+namespace sensor {
+
+class Sensor {
+ public:
+  Sensor() = default;
+  explicit Sensor(std::string name) : name_(std::move(name)) {}
+
+  void publish_state(float state) {
+    this->state = state;
+    this->has_state_ = true;
+    this->publish_count++;
+  }
+  bool has_state() const { return this->has_state_; }
+  const std::string &get_name() const { return this->name_; }
+
+  float state{NAN};
+  uint32_t publish_count{0};
+
+ protected:
+  std::string name_;
+  bool has_state_{false};
+};
+
+}  // namespace sensor
+}  // namespace esphome
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <utility>
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+namespace switch_ {
+
+/// Host stand-in: turn_on()/turn_off() are GPIO writes (counted), then publish.
+class Switch {
+ public:
+  Switch() = default;
+  explicit Switch(std::string name) : name_(std::move(name)) {}
+
+  void turn_on() { this->write_state_(true); }
+  void turn_off() { this->write_state_(false); }
+  void publish_state(bool state) {
+    this->state = state;
+    this->publish_count++;
+    this->state_callback_.call(state);
+  }
+  const std::string &get_name() const { return this->name_; }
+  void add_on_state_callback(std::function<void(bool)> &&callback) { this->state_callback_.add(std::move(callback)); }
+
+  bool state{false};
+  uint32_t write_count{0};
+  uint32_t publish_count{0};
+
+ protected:
+  void write_state_(bool state) {
+    this->write_count++;
+    this->publish_state(state);
+  }
+
+  std::string name_;
+  CallbackManager<void(bool)> state_callback_;
+};
+
+}  // namespace switch_
+}  // namespace esphome
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace esphome {
+namespace text_sensor {
+
+class TextSensor {
+ public:
+  TextSensor() = default;
+  explicit TextSensor(std::string name) : name_(std::move(name)) {}
+
+  void publish_state(const std::string &state) {
+    this->state = state;
+    this->publish_count++;
+  }
+  const std::string &get_name() const { return this->name_; }
+
+  std::string state;
+  uint32_t publish_count{0};
+
+ protected:
+  std::string name_;
+};
+
+}  // namespace text_sensor
+}  // namespace esphome
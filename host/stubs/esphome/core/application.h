@@ -0,0 +1,16 @@
+#pragma once
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+
+/// Host stand-in: reboots are counted (host::reboot_requests()), not performed.
+class Application {
+ public:
+  void safe_reboot();
+  void feed_wdt() {}
+};
+
+extern Application App;  // NOLINT
+
+}  // namespace esphome
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+
+namespace setup_priority {
+extern const float DATA;
+extern const float HARDWARE;
+extern const float IO;
+}  // namespace setup_priority
+
+/// Host stand-in of esphome::Component. Timeouts and deferred calls go to the
+/// host scheduler, run by host::run_scheduler() against the virtual clock.
+class Component {
+ public:
+  virtual ~Component() = default;
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const { return 0.0f; }
+  virtual void on_shutdown() {}
+  virtual void on_safe_shutdown() {}
+  void enable_loop() {}
+  void disable_loop() {}
+  bool is_failed() const { return this->failed_; }
+
+ protected:
+  void set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f);
+  void set_timeout(uint32_t timeout, std::function<void()> &&f);
+  bool cancel_timeout(const std::string &name);
+  void set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f);
+  bool cancel_interval(const std::string &name);
+  void defer(std::function<void()> &&f);
+  void defer(const std::string &name, std::function<void()> &&f);
+  void mark_failed() { this->failed_ = true; }
+  void status_set_warning() {}
+  void status_clear_warning() {}
+
+  bool failed_{false};
+};
+
+class PollingComponent : public Component {
+ public:
+  PollingComponent() = default;
+  explicit PollingComponent(uint32_t update_interval) : update_interval_(update_interval) {}
+  virtual void update() = 0;
+  virtual void set_update_interval(uint32_t update_interval) { this->update_interval_ = update_interval; }
+  uint32_t get_update_interval() const { return this->update_interval_; }
+  void start_poller() {}
+  void stop_poller() {}
+
+ protected:
+  uint32_t update_interval_{10000};
+};
+
+}  // namespace esphome
@@ -0,0 +1,3 @@
+#pragma once
+// Host build: the USE_* / OPEN_ZONING_* defines emitted by the ESPHome
+// codegen come from the compiler command line (host/CMakeLists.txt).
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+
+// Virtual clock of the host build (host/platform.h sets and advances it)
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void yield();
+
+}  // namespace esphome
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace esphome {
+
+namespace host {
+/// RAM flash of the host build: survives a controller rebuilt in the same
+/// process (reboot tests), cleared by host::reset().
+std::map<uint32_t, std::vector<uint8_t>> &preference_store();
+extern uint32_t preference_writes;
+/// Keys saved without in_flash: RTC memory on an ESP8266 without
+/// restore_from_flash
+std::set<uint32_t> &rtc_preferences();
+/// Power loss: the RTC-memory preferences are gone, the flash ones stay
+void power_loss();
+}  // namespace host
+
+class ESPPreferenceObject {
+ public:
+  ESPPreferenceObject() = default;
+  ESPPreferenceObject(uint32_t key, bool in_flash) : key_(key), in_flash_(in_flash) {}
+
+  template<typename T> bool save(const T *src) {
+    const auto *bytes = reinterpret_cast<const uint8_t *>(src);
+    host::preference_store()[this->key_].assign(bytes, bytes + sizeof(T));
+    if (!this->in_flash_) host::rtc_preferences().insert(this->key_);
+    host::preference_writes++;
+    return true;
+  }
+  template<typename T> bool load(T *dest) {
+    auto it = host::preference_store().find(this->key_);
+    if (it == host::preference_store().end() || it->second.size() != sizeof(T))
+      return false;
+    std::memcpy(dest, it->second.data(), sizeof(T));
+    return true;
+  }
+
+ protected:
+  uint32_t key_{0};
+  bool in_flash_{false};
+};
+
+class ESPPreferences {
+ public:
+  template<typename T> ESPPreferenceObject make_preference(uint32_t type, bool in_flash = false) {
+    return ESPPreferenceObject(type, in_flash);
+  }
+  bool sync() { return true; }
+};
+
+extern ESPPreferences *global_preferences;  // NOLINT
+
+}  // namespace esphome
@@ -0,0 +1,578 @@
+// ControlCore::evaluate(): each pass and the edges of its timers.
+
+#include <random>
+
+#include "core_fixture.h"
+
+namespace esphome {
+namespace open_zoning {
+namespace testing {
+
+// ---------------------------------------------------------------------------
+// PASS 1: zone states
+// ---------------------------------------------------------------------------
+
+TEST_F(CoreTest, DecodesEachThermostatCall) {
+  const struct {
+    uint8_t bits;
+    ZoneState state;
+  } cases[] = {
+      {OFF, ZoneState::OFF},
+      {FAN, ZoneState::FAN_ONLY},
+      {HEAT1, ZoneState::HEATING_STAGE1},
+      {HEAT2, ZoneState::HEATING_STAGE2},
+      {COOL1, ZoneState::COOLING_STAGE1},
+      {COOL2, ZoneState::COOLING_STAGE2},
+  };
+  for (const auto &c : cases) {
+    SetUp();
+    call(0, c.bits);
+    run(1000);
+    EXPECT_EQ(state(0), c.state) << "input bits " << int(c.bits);
+  }
+}
+
+TEST_F(CoreTest, DecodeTableCoversEveryInputAndPolarity) {
+  for (uint8_t i = 0; i < 32; i++) {
+    // Lone zone from reset: no hold, no purge, the decoded state is committed
+    ControlCore core;
+    core.reset(1);
+    core.evaluate(CoreInput{static_cast<uint32_t>(i & 0x0F), 1, static_cast<uint16_t>(i >> 4)}, 1000);
+    const uint8_t ref = decode_reference(i & ControlCore::IN_Y1, i & ControlCore::IN_Y2, i & ControlCore::IN_G,
+                                         i & ControlCore::IN_OB, i >> 4);
+    EXPECT_EQ(static_cast<uint8_t>(core.zone_state(0)), ref & DECODE_STATE_MASK) << "index " << int(i);
+    EXPECT_EQ(core.zone(0).error_count, (ref & DECODE_NO_FAN) ? 1 : 0) << "index " << int(i);
+  }
+}
+
+TEST_F(CoreTest, ObOnHeatInvertsPolarity) {
+  in_.ob_on_heat = 1u << 0;
+  call(0, COOL1);  // O/B active
+  run(1000);
+  EXPECT_EQ(state(0), ZoneState::HEATING_STAGE1);
+
+  SetUp();
+  in_.ob_on_heat = 1u << 0;
+  call(0, HEAT1);  // O/B released
+  run(1000);
+  EXPECT_EQ(state(0), ZoneState::COOLING_STAGE1);
+}
+
+TEST(ZoneCountTest, EveryZoneOfTheBuildHasItsOwnNibble) {
+  // Every zone the build is sized for (OZ_MAX_ZONES; beyond 8 the input
+  // word is 64 bits): fan on the even zones, heating on the last one
+  const uint8_t last = MAX_ZONES - 1;
+  ControlCore core;
+  core.reset(MAX_ZONES);
+  CoreInput in;
+  in.enabled = static_cast<uint16_t>((1u << MAX_ZONES) - 1);
+  for (uint8_t i = 0; i < last; i += 2) in.thermostats |= static_cast<InputWord>(FAN) << (4 * i);
+  in.thermostats |= static_cast<InputWord>(HEAT1) << (4 * last);
+  const CoreOutput out = core.evaluate(in, 1000);
+
+  for (uint8_t i = 0; i < last; i++) {
+    EXPECT_EQ(core.zone_state(i), i % 2 ? ZoneState::OFF : ZoneState::WAIT) << "zone " << int(i);
+  }
+  EXPECT_EQ(core.zone_state(last), ZoneState::HEATING_STAGE1);
+  EXPECT_EQ(out.dampers, 1u << last);
+  EXPECT_EQ(out.mode, CHAUFFAGE1);
+}
+
+TEST_F(CoreTest, ErrorConfirmedOnSecondCountedRun) {
+  call(1, HEAT1);
+  run(1000);
+  ASSERT_EQ(mode(), CHAUFFAGE1);
+
+  call(0, NO_FAN);
+  run(2000);
+  EXPECT_NE(state(0), ZoneState::ERROR);
+  EXPECT_EQ(mode(), CHAUFFAGE1);
+  run(2100, false);  // event-driven runs do not count
+  EXPECT_NE(state(0), ZoneState::ERROR);
+
+  const CoreOutput out = run(12000);
+  EXPECT_EQ(state(0), ZoneState::ERROR);
+  EXPECT_TRUE(core_.has_zone_error());
+  EXPECT_EQ(mode(), ARRET);  // a zone error stops the unit
+  EXPECT_TRUE(out.leds & ControlCore::LED_ERROR);
+  EXPECT_FALSE(damper_open(0));
+
+  call(0, OFF);
+  run(22000);
+  EXPECT_NE(state(0), ZoneState::ERROR);
+  EXPECT_FALSE(core_.has_zone_error());
+  EXPECT_FALSE(core_.get_output().leds & ControlCore::LED_ERROR);
+}
+
+TEST_F(CoreTest, DisabledZoneIsOffAndClosed) {
+  enable(0, false);
+  call(0, HEAT1);
+  run(1000);
+  EXPECT_EQ(state(0), ZoneState::OFF);
+  EXPECT_EQ(mode(), ARRET);
+  EXPECT_FALSE(damper_open(0));
+  EXPECT_TRUE(damper_open(1));
+  EXPECT_TRUE(damper_open(2));
+}
+
+// ---------------------------------------------------------------------------
+// PASS 1.5: minimum cycle
+// ---------------------------------------------------------------------------
+
+TEST_F(CoreTest, MinCycleHoldsCallUntilItsEnd) {
+  call(0, HEAT1);
+  run(1000);
+  call(0, OFF);
+  run(2 * MIN);
+  EXPECT_EQ(state(0), ZoneState::HEATING_STAGE1);
+  EXPECT_TRUE(core_.zone(0).short_cycle_protection);
+
+  run(1000 + 8 * MIN - 1);
+  EXPECT_EQ(state(0), ZoneState::HEATING_STAGE1);
+  run(1000 + 8 * MIN);
+  EXPECT_EQ(state(0), ZoneState::PURGE);
+}
+
+TEST_F(CoreTest, ZoneMasksFollowTheCommittedStates) {
+  call(0, HEAT1);
+  call(1, COOL1);
+  call(2, FAN);
+  run(1000);
+  // Heating wins: the cooling zone waits
+  EXPECT_EQ(core_.get_heating_zones(), 0b001);
+  EXPECT_EQ(core_.get_cooling_zones(), 0);
+  EXPECT_EQ(core_.get_running_zones(), 0b001);
+  EXPECT_EQ(core_.get_short_cycle_zones(), 0b011);  // both compressor calls start their minimum cycle
+
+  call(0, OFF);
+  run_until(1000 + 8 * MIN);
+  EXPECT_EQ(state(0), ZoneState::PURGE);
+  EXPECT_EQ(core_.get_heating_zones(), 0);
+  EXPECT_EQ(core_.get_running_zones(), 0b001);
+  EXPECT_EQ(core_.get_short_cycle_zones(), 0);  // both minimum cycles are over
+}
+
+TEST_F(CoreTest, CallLongerThanMinCycleStopsAtOnce) {
+  call(0, HEAT1);
+  run(1000);
+  run_until(1000 + 8 * MIN);
+  call(0, OFF);
+  run(1000 + 8 * MIN + 1);
+  EXPECT_EQ(state(0), ZoneState::PURGE);
+}
+
+// ---------------------------------------------------------------------------
+// PASS 2: purge
+// ---------------------------------------------------------------------------
+
+TEST_F(CoreTest, LastZonePurgesForExactlyPurgeDuration) {
+  core_.set_purge_duration(5 * MIN);
+  call(0, HEAT1);
+  run(1000);
+  run_until(10 * MIN);
+  call(0, OFF);
+  run(10 * MIN + 100);
+  EXPECT_EQ(state(0), ZoneState::PURGE);
+  EXPECT_EQ(mode(), PURGE_CHAUFFAGE);
+  EXPECT_EQ(core_.get_output().unit, ControlCore::UNIT_G);  // fan only, O/B released
+
+  run(15 * MIN + 99);
+  EXPECT_EQ(state(0), ZoneState::PURGE);
+  run(15 * MIN + 100);
+  EXPECT_EQ(state(0), ZoneState::OFF);
+  EXPECT_EQ(mode(), ARRET);
+}
+
+TEST_F(CoreTest, PurgeAfterCoolingKeepsObEnergized) {
+  call(0, COOL1);
+  run(1000);
+  run_until(10 * MIN);
+  call(0, OFF);
+  run(10 * MIN + 100);
+  EXPECT_EQ(mode(), PURGE_CLIM);
+  EXPECT_EQ(core_.get_output().unit, ControlCore::UNIT_G | ControlCore::UNIT_OB);
+}
+
+TEST_F(CoreTest, NoPurgeWhileAnotherZoneStillHeats) {
+  call(0, HEAT1);
+  call(1, HEAT1);
+  run(1000);
+  run_until(10 * MIN);
+  call(0, OFF);
+  run(10 * MIN + 100);
+  EXPECT_EQ(state(0), ZoneState::OFF);
+  EXPECT_EQ(state(1), ZoneState::HEATING_STAGE1);
+  EXPECT_EQ(mode(), CHAUFFAGE1);
+  EXPECT_FALSE(damper_open(0));
+}
+
+TEST_F(CoreTest, PurgeOutranksANewCall) {
+  call(0, HEAT1);
+  run(1000);
+  run_until(10 * MIN);
+  call(0, OFF);
+  run(10 * MIN + 100);
+  ASSERT_EQ(state(0), ZoneState::PURGE);
+
+  call(1, HEAT1);
+  run(11 * MIN);
+  EXPECT_EQ(state(1), ZoneState::WAIT);
+  EXPECT_EQ(mode(), PURGE_CHAUFFAGE);
+  EXPECT_FALSE(damper_open(1));
+
+  run(15 * MIN + 100);  // purge over
+  EXPECT_EQ(state(0), ZoneState::OFF);
+  EXPECT_EQ(state(1), ZoneState::HEATING_STAGE1);
+  EXPECT_EQ(mode(), CHAUFFAGE1);
+}
+
+// ---------------------------------------------------------------------------
+// PASS 2.5: minimum demand
+// ---------------------------------------------------------------------------
+
+TEST_F(CoreTest, MinDemandHoldsSingleCallUntilOverride) {
+  core_.set_min_active_zones(2);
+  core_.set_min_demand_override_delay(10 * MIN);
+  call(0, HEAT1);
+  run(1000);
+  EXPECT_EQ(state(0), ZoneState::WAIT);
+  EXPECT_EQ(mode(), ARRET);
+  EXPECT_FALSE(damper_open(0));
+
+  run_until(1000 + 10 * MIN - 1);
+  EXPECT_EQ(state(0), ZoneState::WAIT);
+  run(1000 + 10 * MIN);
+  EXPECT_EQ(state(0), ZoneState::HEATING_STAGE1);
+  EXPECT_EQ(mode(), CHAUFFAGE1);
+}
+
+TEST_F(CoreTest, MinDemandMetStartsAtOnce) {
+  core_.set_min_active_zones(2);
+  call(0, HEAT1);
+  call(1, HEAT1);
+  run(1000);
+  EXPECT_EQ(state(0), ZoneState::HEATING_STAGE1);
+  EXPECT_EQ(state(1), ZoneState::HEATING_STAGE1);
+  EXPECT_EQ(mode(), CHAUFFAGE1);
+}
+
+TEST_F(CoreTest, MinDemandDoesNotInterruptARunningUnit) {
+  core_.set_min_active_zones(2);
+  call(0, HEAT1);
+  call(1, HEAT1);
+  run(1000);
+  run_until(10 * MIN);
+  call(0, OFF);
+  run(10 * MIN + 100);
+  EXPECT_EQ(state(1), ZoneState::HEATING_STAGE1);
+  EXPECT_EQ(mode(), CHAUFFAGE1);
+}
+
+TEST_F(CoreTest, MinDemandWithoutOverrideWaitsForever) {
+  core_.set_min_active_zones(2);
+  core_.set_min_demand_override_delay(0);
+  call(0, HEAT1);
+  run(1000);
+  run_until(5 * 60 * MIN);
+  EXPECT_EQ(state(0), ZoneState::WAIT);
+  EXPECT_EQ(mode(), ARRET);
+}
+
+// ---------------------------------------------------------------------------
+// PASS 3: priority and WAIT
+// ---------------------------------------------------------------------------
+
+TEST_F(CoreTest, HeatingOutranksCooling) {
+  call(0, HEAT1);
+  call(1, COOL1);
+  run(1000);
+  EXPECT_EQ(state(0), ZoneState::HEATING_STAGE1);
+  EXPECT_EQ(state(1), ZoneState::WAIT);
+  EXPECT_EQ(mode(), CHAUFFAGE1);
+  EXPECT_TRUE(damper_open(0));
+  EXPECT_FALSE(damper_open(1));
+}
+
+TEST_F(CoreTest, CoolingOutranksFan) {
+  call(0, COOL1);
+  call(1, FAN);
+  run(1000);
+  EXPECT_EQ(state(1), ZoneState::WAIT);
+  EXPECT_EQ(mode(), CLIM1);
+}
+
+TEST_F(CoreTest, WaitingZoneStartsAfterTheHigherCallAndItsPurge) {
+  call(0, HEAT1);
+  call(1, COOL1);
+  run(1000);
+  run_until(10 * MIN);
+  call(0, OFF);
+  run(10 * MIN + 100);
+  EXPECT_EQ(state(0), ZoneState::PURGE);
+  EXPECT_EQ(state(1), ZoneState::WAIT);
+
+  run(15 * MIN + 100);
+  EXPECT_EQ(state(1), ZoneState::COOLING_STAGE1);
+  EXPECT_EQ(mode(), CLIM1);
+  EXPECT_TRUE(damper_open(1));
+}
+
+// ---------------------------------------------------------------------------
+// PASS 4: dampers (default policy; see damper_policy_test.cpp)
+// ---------------------------------------------------------------------------
+
+TEST_F(CoreTest, IdleUnitOpensEveryDamper) {
+  const CoreOutput out = run(1000);
+  EXPECT_EQ(out.dampers, 0b111);
+}
+
+TEST_F(CoreTest, ActiveZonesOpenOthersClose) {
+  call(2, FAN);
+  const CoreOutput out = run(1000);
+  EXPECT_EQ(out.dampers, 0b100);
+  EXPECT_EQ(mode(), MODE_FAN);
+}
+
+// ---------------------------------------------------------------------------
+// PASS 5: unit mode and Stage 2
+// ---------------------------------------------------------------------------
+
+TEST_F(CoreTest, Stage2EscalatesExactlyAtTheDelay) {
+  core_.set_stage2_escalation_delay(30 * MIN);
+  call(0, HEAT1);
+  run(1000);
+  ASSERT_EQ(mode(), CHAUFFAGE1);
+  EXPECT_EQ(core_.get_stage1_start_ms(), 1000u);
+
+  run_until(1000 + 30 * MIN - 1);
+  EXPECT_EQ(mode(), CHAUFFAGE1);
+  run(1000 + 30 * MIN);
+  EXPECT_EQ(mode(), CHAUFFAGE2);
+  EXPECT_TRUE(core_.get_output().unit & ControlCore::UNIT_Y2);
+
+  run_until(1000 + 45 * MIN);
+  EXPECT_EQ(mode(), CHAUFFAGE2);  // held while the Stage 1 demand lasts
+  EXPECT_EQ(core_.get_mode_change_count(), 2u);
+}
+
+TEST_F(CoreTest, Stage1SwitchBetweenCoolingAndHeatingRestartsTheEscalation) {
+  core_.set_stage2_escalation_delay(30 * MIN);
+  call(0, COOL1);
+  run(1000);
+  ASSERT_EQ(mode(), CLIM1);
+
+  call(1, HEAT1);  // heating outranks cooling: Stage 1 to Stage 1
+  run(20 * MIN);
+  ASSERT_EQ(mode(), CHAUFFAGE1);
+  EXPECT_EQ(core_.get_stage1_start_ms(), 20u * MIN);
+
+  run_until(1000 + 30 * MIN);  // the cooling start no longer counts
+  EXPECT_EQ(mode(), CHAUFFAGE1);
+  run(50 * MIN);
+  EXPECT_EQ(mode(), CHAUFFAGE2);
+}
+
+TEST_F(CoreTest, Stage2EscalationDisabledByZeroDelay) {
+  core_.set_stage2_escalation_delay(0);
+  call(0, COOL1);
+  run(1000);
+  run_until(10 * 60 * MIN);
+  EXPECT_EQ(mode(), CLIM1);
+}
+
+TEST_F(CoreTest, Y2CallGoesStraightToStage2) {
+  call(0, COOL2);
+  run(1000);
+  EXPECT_EQ(mode(), CLIM2);
+  SetUp();
+  call(0, HEAT2);
+  run(1000);
+  EXPECT_EQ(mode(), CHAUFFAGE2);
+}
+
+TEST_F(CoreTest, OutputsFollowTheModeTable) {
+  call(0, HEAT1);
+  const CoreOutput out = run(1000);
+  EXPECT_EQ(out.mode, CHAUFFAGE1);
+  EXPECT_EQ(out.unit, ControlCore::UNIT_Y1 | ControlCore::UNIT_G);
+  EXPECT_EQ(out.leds, ControlCore::LED_HEAT | ControlCore::LED_FAN);
+  EXPECT_EQ(core_.get_last_active_mode(), 1);
+}
+
+TEST_F(CoreTest, ManualModeLeavesOutputsAlone) {
+  core_.set_auto_mode(false);
+  call(0, HEAT1);
+  const CoreOutput out = run(1000);
+  EXPECT_EQ(out.unit, 0);
+  EXPECT_EQ(mode(), ARRET);
+  EXPECT_EQ(state(0), ZoneState::HEATING_STAGE1);  // zones still tracked
+}
+
+// ---------------------------------------------------------------------------
+// Timers: wrap-safe deadlines
+// ---------------------------------------------------------------------------
+
+TEST(DeadlineSetTest, NextIsOrderedAcrossTheWrap) {
+  const uint32_t now = 0xFFFFFF00u;
+  DeadlineSet<3> timers;
+  timers.set(0, 0x100);       // 512 ms ahead, past the wrap
+  timers.set(1, now + 0x80);  // 128 ms ahead
+  timers.set(2, now - 1);     // reached
+  uint32_t at = 0;
+  ASSERT_TRUE(timers.next(now, &at));
+  EXPECT_EQ(at, now + 0x80);
+  EXPECT_TRUE(timers.any_reached(now));
+
+  timers.clear(1);
+  timers.clear(2);
+  ASSERT_TRUE(timers.next(now, &at));
+  EXPECT_EQ(at, 0x100u);
+  EXPECT_EQ(time_until(now, at), 0x200u);
+  EXPECT_FALSE(timers.any_reached(now));
+}
+
+TEST_F(CoreTest, PurgeAcrossTheMillisWrapLastsItsFullDuration) {
+  const uint32_t t0 = 0xFFFFFFFFu - 10 * MIN;  // the purge starts 1 min before the wrap
+  call(0, HEAT1);
+  run(t0);
+  run_until(t0 + 9 * MIN);
+  call(0, OFF);
+  run(t0 + 9 * MIN);
+  ASSERT_EQ(state(0), ZoneState::PURGE);
+
+  run(t0 + 11 * MIN);  // millis() has wrapped, the purge end has not passed
+  EXPECT_EQ(state(0), ZoneState::PURGE);
+  run(t0 + 14 * MIN - 1);
+  EXPECT_EQ(state(0), ZoneState::PURGE);
+  run(t0 + 14 * MIN);
+  EXPECT_EQ(state(0), ZoneState::OFF);
+}
+
+TEST_F(CoreTest, CycleStartedAtMillisZeroIsStillProtected) {
+  call(0, HEAT1);
+  run(0);  // 0 is a timestamp like any other, not "no cycle"
+  call(0, OFF);
+  run(MIN);
+  EXPECT_EQ(state(0), ZoneState::HEATING_STAGE1);
+  EXPECT_TRUE(core_.zone(0).in_cycle);
+  EXPECT_TRUE(core_.zone(0).short_cycle_protection);
+}
+
+TEST_F(CoreTest, NextDeadlineIsTheEarliestArmedTimer) {
+  uint32_t at = 0;
+  call(0, HEAT1);
+  run(1000);
+  ASSERT_TRUE(core_.next_deadline(1000, &at));
+  EXPECT_EQ(at, 1000 + 8 * MIN);  // minimum cycle, before stage 2 (1 h)
+
+  run_until(1000 + 8 * MIN);
+  ASSERT_TRUE(core_.next_deadline(1000 + 8 * MIN, &at));
+  EXPECT_EQ(at, 1000 + 60 * MIN);  // stage 2 escalation
+
+  call(0, OFF);
+  run(1000 + 9 * MIN);
+  ASSERT_TRUE(core_.next_deadline(1000 + 9 * MIN, &at));
+  EXPECT_EQ(at, 1000 + 14 * MIN);  // purge end
+
+  run(1000 + 14 * MIN);
+  EXPECT_FALSE(core_.next_deadline(1000 + 14 * MIN, &at));
+}
+
+// ---------------------------------------------------------------------------
+// Incremental evaluation
+// ---------------------------------------------------------------------------
+
+TEST_F(CoreTest, SettledCoreSkipsUntilTheNextDeadline) {
+  call(0, HEAT1);
+  run(1000);
+  run(2000);  // settles: nothing changed
+  const uint32_t skipped = core_.get_skipped_evaluations();
+  run_until(1000 + 8 * MIN - 1, 1000);
+  EXPECT_EQ(mode(), CHAUFFAGE1);
+  EXPECT_GT(core_.get_skipped_evaluations() - skipped, 400u);
+
+  // Released during the minimum cycle: held, then purged right at its end
+  call(0, OFF);
+  run(1000 + 8 * MIN - 1);
+  EXPECT_EQ(state(0), ZoneState::HEATING_STAGE1);
+  run(1000 + 8 * MIN);
+  EXPECT_EQ(state(0), ZoneState::PURGE);
+}
+
+TEST_F(CoreTest, ConfigurationChangeRecomputesASettledCore) {
+  call(0, FAN);
+  run(1000);
+  run(2000);
+  core_.set_auto_mode(false);
+  core_.set_auto_mode(true);
+  const uint32_t skipped = core_.get_skipped_evaluations();
+  run(3000);
+  EXPECT_EQ(core_.get_skipped_evaluations(), skipped);
+}
+
+/// Random input / time sequences: the incremental core must end every
+/// evaluation in the same state as a core recomputing every zone.
+TEST(IncrementalEvaluationTest, MatchesFullEvaluation) {
+  struct Config {
+    uint8_t min_active_zones;
+    uint32_t escalation_ms;
+  };
+  const Config configs[] = {{1, 30 * MIN}, {2, 20 * MIN}, {3, 0}};
+  const uint8_t calls[] = {OFF, FAN, HEAT1, HEAT2, COOL1, COOL2, NO_FAN};
+
+  for (const Config &cfg : configs) {
+    std::mt19937 rng(1234 + cfg.min_active_zones);
+    ControlCore inc, ref;
+    for (ControlCore *c : {&inc, &ref}) {
+      c->reset(MAX_ZONES);
+      c->set_min_cycle_time(8 * MIN);
+      c->set_purge_duration(5 * MIN);
+      c->set_stage2_escalation_delay(cfg.escalation_ms);
+      c->set_min_active_zones(cfg.min_active_zones);
+      c->set_min_demand_override_delay(15 * MIN);
+    }
+    ref.set_incremental(false);
+
+    CoreInput in{};
+    in.enabled = 0x3F;
+    in.ob_on_heat = 0x3F;
+    uint32_t t = 1000;
+    for (int step = 0; step < 20000; step++) {
+      const uint32_t r = rng();
+      if (r % 8 == 0) {
+        const uint8_t zone = (r >> 3) % MAX_ZONES;
+        const uint8_t bits = calls[(r >> 8) % sizeof(calls)];
+        in.thermostats = (in.thermostats & ~(0xFu << (4 * zone))) | static_cast<uint32_t>(bits) << (4 * zone);
+      } else if (r % 97 == 1) {
+        in.enabled ^= static_cast<uint16_t>(1u << ((r >> 3) % MAX_ZONES));
+      } else if (r % 211 == 2) {
+        in.ob_on_heat ^= static_cast<uint16_t>(1u << ((r >> 3) % MAX_ZONES));
+      }
+      t += 1 + (r >> 12) % 40000;
+      const bool periodic = (r >> 20) % 3 != 0;
+
+      const CoreOutput a = inc.evaluate(in, t, periodic);
+      const CoreOutput b = ref.evaluate(in, t, periodic);
+      ASSERT_EQ(a.dampers, b.dampers) << "step " << step;
+      ASSERT_EQ(a.unit, b.unit) << "step " << step;
+      ASSERT_EQ(a.leds, b.leds) << "step " << step;
+      ASSERT_EQ(a.mode, b.mode) << "step " << step;
+      ASSERT_EQ(inc.get_global_max_priority(), ref.get_global_max_priority()) << "step " << step;
+      ASSERT_EQ(inc.get_stage1_start_ms(), ref.get_stage1_start_ms()) << "step " << step;
+      for (uint8_t i = 0; i < MAX_ZONES; i++) {
+        const Zone &x = inc.zone(i), &y = ref.zone(i);
+        ASSERT_EQ(x.state, y.state) << "step " << step << " zone " << int(i);
+        ASSERT_EQ(x.error_count, y.error_count) << "step " << step << " zone " << int(i);
+        ASSERT_EQ(x.purge_end_ms, y.purge_end_ms) << "step " << step << " zone " << int(i);
+        ASSERT_EQ(x.active_start_ms, y.active_start_ms) << "step " << step << " zone " << int(i);
+        ASSERT_EQ(x.short_cycle_protection, y.short_cycle_protection) << "step " << step << " zone " << int(i);
+      }
+    }
+    EXPECT_GT(inc.get_skipped_evaluations(), 1000u);
+    EXPECT_EQ(ref.get_skipped_evaluations(), 0u);
+  }
+}
+
+}  // namespace testing
+}  // namespace open_zoning
+}  // namespace esphome
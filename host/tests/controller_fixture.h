@@ -0,0 +1,115 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "core_fixture.h"
+#include "fake_bus.h"
+#include "open_zoning.h"
+#include "platform.h"
+
+namespace esphome {
+namespace open_zoning {
+namespace testing {
+
+/// OpenZoningController (the ESPHome adapter) wired to stand-in entities:
+/// three zones with binary sensor inputs, damper switches and state text
+/// sensors, the seven unit outputs, the four LEDs, the mode select and the
+/// diagnostic sensors, on the virtual clock and a fake I2C bus. O/B active
+/// means cooling. step() runs loop() every 16 ms and update() every update
+/// interval, the first one at start().
+class ControllerTest : public ::testing::Test {
+ protected:
+  static constexpr uint8_t ZONES = 3;
+  static constexpr uint32_t LOOP_MS = 16;
+
+  void SetUp() override {
+    host::reset();
+    host::set_log_sink(nullptr);
+    host::set_now(1000);
+    ctrl_.set_num_zones(ZONES);
+    ctrl_.set_time_source(&host::now);
+    ctrl_.set_i2c_bus(&bus_);
+    for (uint8_t i = 0; i < ZONES; i++) {
+      ctrl_.set_zone_sensors(i, &y1_[i], &y2_[i], &g_[i], &ob_[i]);
+      ctrl_.set_zone_dampers(i, &open_[i], &close_[i]);
+      ctrl_.set_zone_state_sensor(i, &state_[i]);
+      ctrl_.set_zone_ob_on_heat(i, false);
+    }
+    ctrl_.set_out_y1(&out_[0]);
+    ctrl_.set_out_y2(&out_[1]);
+    ctrl_.set_out_g(&out_[2]);
+    ctrl_.set_out_ob(&out_[3]);
+    ctrl_.set_out_w1e(&out_[4]);
+    ctrl_.set_out_w2(&out_[5]);
+    ctrl_.set_out_w3(&out_[6]);
+    ctrl_.set_led_heat(&led_[0]);
+    ctrl_.set_led_cool(&led_[1]);
+    ctrl_.set_led_fan(&led_[2]);
+    ctrl_.set_led_error(&led_[3]);
+    ctrl_.set_mode_select(&select_);
+    ctrl_.set_active_zones_sensor(&active_zones_);
+    ctrl_.set_stage1_elapsed_sensor(&stage1_elapsed_);
+    ctrl_.set_mode_changes_sensor(&mode_changes_);
+    ctrl_.set_short_cycle_sensor(&short_cycle_);
+  }
+
+  void start() {
+    ctrl_.setup();
+    next_update_ = host::now();
+  }
+
+  void call(uint8_t zone, uint8_t bits) {
+    y1_[zone].publish_state(bits & ControlCore::IN_Y1);
+    y2_[zone].publish_state(bits & ControlCore::IN_Y2);
+    g_[zone].publish_state(bits & ControlCore::IN_G);
+    ob_[zone].publish_state(bits & ControlCore::IN_OB);
+  }
+
+  void step(uint32_t ms) {
+    const uint32_t end = host::now() + ms;
+    while (static_cast<int32_t>(host::now() - end) < 0) {
+      if (static_cast<int32_t>(host::now() - next_update_) >= 0) {
+        next_update_ += ctrl_.get_update_interval();
+        ctrl_.update();
+      }
+      host::run_scheduler();
+      ctrl_.loop();
+      host::advance(LOOP_MS);
+    }
+  }
+
+  /// Switch writes (turn_on/turn_off) of the unit outputs and LEDs
+  uint32_t output_writes() const {
+    uint32_t n = 0;
+    for (const auto &sw : out_) n += sw.write_count;
+    for (const auto &sw : led_) n += sw.write_count;
+    return n;
+  }
+  uint32_t output_publishes() const {
+    uint32_t n = 0;
+    for (const auto &sw : out_) n += sw.publish_count;
+    for (const auto &sw : led_) n += sw.publish_count;
+    return n;
+  }
+
+  std::string state(uint8_t zone) const { return state_[zone].state; }
+  size_t mode() const { return select_.active_index; }
+
+  host::FakeBus bus_;
+  OpenZoningController ctrl_;
+  binary_sensor::BinarySensor y1_[ZONES], y2_[ZONES], g_[ZONES], ob_[ZONES];
+  switch_::Switch open_[ZONES], close_[ZONES];
+  text_sensor::TextSensor state_[ZONES];
+  switch_::Switch out_[7];  // Y1 Y2 G OB W1e W2 W3
+  switch_::Switch led_[4];  // heat cool fan error
+  select::Select select_;
+  sensor::Sensor active_zones_, stage1_elapsed_, mode_changes_;
+  binary_sensor::BinarySensor short_cycle_;
+  uint32_t next_update_{0};
+};
+
+}  // namespace testing
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,379 @@
+// OpenZoningController: what the adapter writes to the entities and the bus.
+
+#include <memory>
+
+#include "controller_fixture.h"
+
+namespace esphome {
+namespace open_zoning {
+namespace testing {
+
+// ---------------------------------------------------------------------------
+// Unit outputs and LEDs
+// ---------------------------------------------------------------------------
+
+TEST_F(ControllerTest, FirstCycleDrivesEveryOutputOnce) {
+  start();
+  step(1000);
+  EXPECT_EQ(output_writes(), 11u);
+  step(60000);  // idle polls: nothing left to write
+  EXPECT_EQ(output_writes(), 11u);
+}
+
+TEST_F(ControllerTest, ModeChangeWritesOnlyTheOutputsThatMove) {
+  start();
+  call(0, FAN);
+  step(1000);
+  ASSERT_EQ(mode(), MODE_FAN);
+
+  const uint32_t writes = output_writes();
+  const uint32_t publishes = output_publishes();
+  call(0, HEAT1);
+  step(1000);
+  ASSERT_EQ(mode(), CHAUFFAGE1);
+  EXPECT_EQ(output_writes() - writes, 2u);  // Y1 and the heat LED
+  EXPECT_EQ(output_publishes() - publishes, 2u);
+  EXPECT_TRUE(out_[0].state);
+  EXPECT_TRUE(out_[2].state);
+  EXPECT_TRUE(led_[0].state);
+  EXPECT_TRUE(led_[2].state);
+}
+
+TEST_F(ControllerTest, ReapplyModeRedrivesEveryOutput) {
+  start();
+  call(0, HEAT1);
+  step(1000);
+  out_[0].turn_off();  // changed behind the component's back
+  const uint32_t writes = output_writes();
+  ctrl_.reapply_mode();
+  EXPECT_EQ(output_writes() - writes, 11u);
+  EXPECT_TRUE(out_[0].state);
+}
+
+TEST_F(ControllerTest, OutputPortWritesAModeChangeAsOneLatchWrite) {
+  ctrl_.set_output_port(0x21, true);
+  ctrl_.set_output_pins(1, 6, 4, 5, 7, 3, 2);  // board wiring of packages/switches.yml
+  const uint8_t released[3] = {0x14, 0xFF, 0xFF};  // latch as left by the gpio switches at boot
+  bus_.write(0x21, released, sizeof(released));
+  start();
+  call(0, FAN);
+  step(1000);
+  ASSERT_EQ(mode(), MODE_FAN);
+  EXPECT_EQ(bus_.get_register(0x21, 0x14), static_cast<uint8_t>(~(1u << 4)));  // G on, active low
+
+  const uint32_t transactions = bus_.get_transactions(0x21);
+  call(0, HEAT1);
+  step(1000);
+  ASSERT_EQ(mode(), CHAUFFAGE1);
+  EXPECT_EQ(bus_.get_transactions(0x21) - transactions, 1u);
+  EXPECT_EQ(bus_.get_register(0x21, 0x14), static_cast<uint8_t>(~(1u << 4 | 1u << 1)));
+  EXPECT_TRUE(out_[0].state);  // mirror
+  EXPECT_EQ(out_[0].write_count, 0u);
+}
+
+// ---------------------------------------------------------------------------
+// Mode select
+// ---------------------------------------------------------------------------
+
+TEST_F(ControllerTest, SelectFollowsTheOutputsAtTheNextLoop) {
+  start();
+  step(1000);
+  const uint32_t performs = select_.perform_count;
+  call(0, HEAT1);
+  ctrl_.update();  // pipeline run, no loop() yet
+  EXPECT_TRUE(out_[0].state);
+  EXPECT_EQ(select_.perform_count, performs);
+  ctrl_.loop();
+  EXPECT_EQ(select_.perform_count, performs + 1);
+  EXPECT_EQ(mode(), CHAUFFAGE1);
+}
+
+TEST_F(ControllerTest, ModesAppliedBetweenLoopsCoalesce) {
+  start();
+  step(1000);
+  const uint32_t syncs = ctrl_.get_select_syncs();
+  call(0, HEAT1);
+  ctrl_.update();
+  ASSERT_EQ(ctrl_.get_unit_mode(0), CHAUFFAGE1);
+  call(0, HEAT2);
+  ctrl_.update();
+  ASSERT_EQ(ctrl_.get_unit_mode(0), CHAUFFAGE2);
+  ctrl_.loop();
+  EXPECT_EQ(ctrl_.get_select_syncs() - syncs, 1u);  // the final mode only
+  EXPECT_EQ(mode(), CHAUFFAGE2);
+
+  call(0, HEAT1);  // there and back before the next loop: nothing to send
+  ctrl_.update();
+  ASSERT_EQ(ctrl_.get_unit_mode(0), CHAUFFAGE1);
+  call(0, HEAT2);
+  ctrl_.update();
+  ctrl_.loop();
+  EXPECT_EQ(ctrl_.get_select_syncs() - syncs, 1u);
+  EXPECT_EQ(mode(), CHAUFFAGE2);
+}
+
+TEST_F(ControllerTest, ReapplyModeSetsTheSelectBackAtTheNextLoop) {
+  start();
+  call(0, HEAT1);
+  step(1000);
+  select_.make_call().set_index(ARRET).perform();  // manual change from HA
+  ctrl_.reapply_mode();  // from the select's on_value
+  EXPECT_EQ(mode(), ARRET);
+  ctrl_.loop();
+  EXPECT_EQ(mode(), CHAUFFAGE1);
+}
+
+// ---------------------------------------------------------------------------
+// Diagnostic sensors
+// ---------------------------------------------------------------------------
+
+TEST_F(ControllerTest, SteadyStateDiagnosticsPublishOnlyTheHeartbeat) {
+  start();
+  step(1000);
+  EXPECT_EQ(active_zones_.publish_count, 1u);
+  EXPECT_EQ(short_cycle_.publish_count, 1u);
+  step(14 * 60000);  // 84 idle updates
+  EXPECT_EQ(active_zones_.publish_count, 1u);
+  EXPECT_EQ(stage1_elapsed_.publish_count, 1u);
+  EXPECT_EQ(mode_changes_.publish_count, 1u);
+  EXPECT_EQ(short_cycle_.publish_count, 1u);
+  step(60000);  // past the 15 min max interval
+  EXPECT_EQ(active_zones_.publish_count, 2u);
+  EXPECT_EQ(mode_changes_.publish_count, 2u);
+}
+
+TEST_F(ControllerTest, ChangeIsPublishedOnceTheMinIntervalHasPassed) {
+  start();
+  step(1000);
+  call(0, FAN);  // event run 100 ms later, inside the 10 s min interval
+  step(1000);
+  EXPECT_EQ(active_zones_.publish_count, 1u);
+  step(10000);  // next periodic update
+  EXPECT_EQ(active_zones_.publish_count, 2u);
+  EXPECT_EQ(active_zones_.state, 1.0f);
+}
+
+TEST_F(ControllerTest, StageOneElapsedMovesByTheDeadband) {
+  ctrl_.set_diagnostic_policy(OpenZoningController::DIAG_STAGE1_ELAPSED, 0, 0, 60.0f);
+  start();
+  call(0, HEAT1);
+  step(1000);
+  ASSERT_EQ(mode(), CHAUFFAGE1);
+  const uint32_t entered = stage1_elapsed_.publish_count;
+  step(5 * 60000);  // 30 updates, the elapsed time moves 10 s each
+  EXPECT_EQ(stage1_elapsed_.publish_count - entered, 5u);
+  EXPECT_GE(stage1_elapsed_.state, 240.0f);
+
+  call(0, 0);  // leaving Stage 1 (after the min cycle time) resets to 0 at once
+  while (mode() == CHAUFFAGE1) step(1000);
+  EXPECT_EQ(stage1_elapsed_.state, 0.0f);
+}
+
+// ---------------------------------------------------------------------------
+// Event-driven evaluation
+// ---------------------------------------------------------------------------
+
+TEST_F(ControllerTest, InputEdgeRunsThePassesWithinEventLatency) {
+  ctrl_.set_update_interval(60000);
+  start();
+  step(1000);
+  call(0, HEAT1);
+  step(80);
+  EXPECT_EQ(state(0), "Off");
+  EXPECT_EQ(ctrl_.get_event_runs(), 0u);
+  step(48);  // 100 ms event latency, on the 16 ms loop
+  EXPECT_EQ(state(0), "Heating Stage 1");
+  EXPECT_EQ(mode(), CHAUFFAGE1);
+  EXPECT_EQ(ctrl_.get_event_runs(), 1u);
+}
+
+TEST_F(ControllerTest, EdgesWithinTheEventLatencyCoalesceIntoOneRun) {
+  ctrl_.set_update_interval(60000);
+  start();
+  step(1000);
+  call(0, HEAT1);  // Y1 and G: two edges
+  step(32);
+  call(1, HEAT1);
+  step(32);
+  call(2, HEAT1);
+  step(64);  // 100 ms after the first edge, not after the last one
+  EXPECT_EQ(ctrl_.get_event_runs(), 1u);
+  for (uint8_t i = 0; i < ZONES; i++) EXPECT_EQ(state(i), "Heating Stage 1");
+
+  step(1000);
+  EXPECT_EQ(ctrl_.get_event_runs(), 1u);
+  call(0, HEAT2);  // a later edge opens a new window
+  step(128);
+  EXPECT_EQ(ctrl_.get_event_runs(), 2u);
+}
+
+// ---------------------------------------------------------------------------
+// Deadline scheduling
+// ---------------------------------------------------------------------------
+
+TEST_F(ControllerTest, PurgeEndsAtItsDeadlineNotAtTheNextPoll) {
+  const uint32_t purge = 5 * 60000 + 3000;  // ends between two polls
+  ctrl_.set_purge_duration(purge);
+  start();
+  call(0, HEAT1);
+  step(9 * 60000);
+  call(0, 0);
+  while (state(0) != "Purge") step(LOOP_MS);
+  const uint32_t started = host::now();
+  while (state(0) == "Purge") step(LOOP_MS);
+
+  EXPECT_LE(host::now() - started, purge + 2 * LOOP_MS);
+  EXPECT_GE(host::now() - started, purge);
+  EXPECT_EQ(mode(), ARRET);
+  EXPECT_GE(ctrl_.get_deadline_runs(), 1u);
+}
+
+TEST_F(ControllerTest, NoTimerNoDeadlineRun) {
+  start();
+  call(0, FAN);  // fan only: no minimum cycle, no purge, no stage 2
+  step(5 * 60000);
+  EXPECT_EQ(ctrl_.get_deadline_runs(), 0u);
+}
+
+#ifdef OPEN_ZONING_ALLOC_MONITOR
+// ---------------------------------------------------------------------------
+// Allocation monitor
+// ---------------------------------------------------------------------------
+
+namespace {
+uint32_t fake_free_heap = 0;
+uint32_t read_fake_free_heap() { return fake_free_heap; }
+}  // namespace
+
+TEST_F(ControllerTest, SteadyStateUpdateAndLoopDoNotAllocate) {
+  // One journal slot: its preference entry exists after the first commit
+  // (the transition to heating), the later ones overwrite it in place
+  ctrl_.set_persist_slots(1);
+  start();
+  call(0, HEAT1);
+  step(60000);
+  ASSERT_EQ(mode(), CHAUFFAGE1);
+  AllocMonitor::reset();
+  step(10 * 60000);  // heating: stage 2 escalation timer armed, 60 updates
+  EXPECT_EQ(AllocMonitor::allocations(), 0u);
+
+  call(0, 0);
+  step(10 * 60000);  // minimum cycle end, purge, back to rest
+  ASSERT_EQ(mode(), ARRET);
+  AllocMonitor::reset();
+  step(30 * 60000);
+  EXPECT_EQ(AllocMonitor::allocations(), 0u);
+}
+
+TEST_F(ControllerTest, AllocationMonitorCountsOnlyInsideItsScopes) {
+  AllocMonitor::reset();
+  AllocMonitor::set_free_heap_source(&read_fake_free_heap);
+  fake_free_heap = 40000;
+  auto outside = std::make_unique<int>(0);
+  EXPECT_EQ(AllocMonitor::allocations(), 0u);
+  EXPECT_EQ(AllocMonitor::min_free_heap(), UINT32_MAX);
+  {
+    OZ_ALLOC_SCOPE();
+    fake_free_heap = 30000;
+    auto inside = std::make_unique<std::string>(64, 'x');  // the string and its buffer
+    fake_free_heap = 35000;
+  }
+  EXPECT_EQ(AllocMonitor::allocations(), 2u);
+  EXPECT_EQ(AllocMonitor::min_free_heap(), 30000u);
+  AllocMonitor::set_free_heap_source(nullptr);
+}
+
+TEST_F(ControllerTest, AllocationSensorsPublishAtTheirInterval) {
+  AllocMonitor::reset();
+  sensor::Sensor allocations, min_free;
+  ctrl_.set_allocations_sensor(&allocations);
+  ctrl_.set_min_free_heap_sensor(&min_free);
+  ctrl_.set_alloc_publish_interval(60000);
+  start();
+  step(1000);
+  EXPECT_EQ(allocations.publish_count, 1u);
+  EXPECT_EQ(min_free.publish_count, 0u);  // no free heap source on the host
+  step(50000);
+  EXPECT_EQ(allocations.publish_count, 1u);
+  step(20000);
+  EXPECT_EQ(allocations.publish_count, 2u);
+}
+
+#endif
+// ---------------------------------------------------------------------------
+// Central units
+// ---------------------------------------------------------------------------
+
+/// Zone 3 on a second central unit, with its own seven outputs
+class TwoUnitTest : public ControllerTest {
+ protected:
+  void SetUp() override {
+    ControllerTest::SetUp();
+    if (MAX_UNITS < 2) GTEST_SKIP() << "built for one central unit";
+    ctrl_.set_num_units(2);
+    ctrl_.set_zone_unit(2, 1);
+    ctrl_.set_unit_outputs(1, &out2_[0], &out2_[1], &out2_[2], &out2_[3], &out2_[4], &out2_[5], &out2_[6]);
+  }
+
+  switch_::Switch out2_[7];  // Y1 Y2 G OB W1e W2 W3
+};
+
+TEST_F(TwoUnitTest, EachUnitServesItsOwnZones) {
+  start();
+  call(0, HEAT1);
+  call(2, COOL1);  // one unit: held in WAIT behind the heating call
+  step(2000);
+
+  EXPECT_EQ(mode(), CHAUFFAGE1);  // the select follows the first unit
+  EXPECT_EQ(ctrl_.get_unit_mode(1), CLIM1);
+  EXPECT_EQ(state(0), "Heating Stage 1");
+  EXPECT_EQ(state(2), "Cooling Stage 1");
+  EXPECT_TRUE(out2_[0].state && out2_[2].state && out2_[3].state);
+  EXPECT_FALSE(out_[3].state);  // O/B of the first unit: heating
+  EXPECT_TRUE(led_[0].state && led_[1].state);
+  EXPECT_TRUE(open_[0].state);
+  EXPECT_TRUE(close_[1].state);  // zone 2 off while its unit runs
+  EXPECT_TRUE(open_[2].state);
+}
+
+TEST_F(TwoUnitTest, PurgeAndEscalationArePerUnit) {
+  ctrl_.set_stage2_escalation_delay(20 * 60000);
+  start();
+  call(0, HEAT1);
+  call(2, COOL1);
+  step(10 * 60000);
+  call(2, OFF);
+  step(60000);
+  EXPECT_EQ(ctrl_.get_unit_mode(1), PURGE_CLIM);
+  EXPECT_EQ(state(2), "Purge");
+  EXPECT_EQ(mode(), CHAUFFAGE1);  // the first unit keeps heating
+
+  step(10 * 60000);  // 21 min of Stage 1 on the first unit, purge of the second over at 15 min
+  EXPECT_EQ(mode(), CHAUFFAGE2);
+  EXPECT_EQ(ctrl_.get_unit_mode(1), ARRET);
+  EXPECT_EQ(ctrl_.get_state_journal().get_state().last_active_mode, 1 | 2 << 2);  // 2 bits per unit
+}
+
+TEST_F(TwoUnitTest, BothUnitsShareOneOutputPortWrite) {
+  ctrl_.set_output_port(0x21, true);
+  ctrl_.set_output_pins(1, 6, 4, 5, 7, 3, 2);
+  ctrl_.set_unit_output_pins(1, 9, 14, 12, 13, 15, 11, 10);  // second bank
+  const uint8_t released[3] = {0x14, 0xFF, 0xFF};
+  bus_.write(0x21, released, sizeof(released));
+  start();
+  step(1000);
+
+  const uint32_t transactions = bus_.get_transactions(0x21);
+  call(0, HEAT1);
+  call(2, COOL1);
+  step(1000);
+  ASSERT_EQ(ctrl_.get_unit_mode(1), CLIM1);
+  EXPECT_EQ(bus_.get_transactions(0x21) - transactions, 1u);  // both mode changes
+  EXPECT_EQ(bus_.get_register(0x21, 0x15), static_cast<uint8_t>(~(1u << 1 | 1u << 4 | 1u << 5)));  // Y1 G OB
+  EXPECT_TRUE(out2_[3].state);  // mirror
+  EXPECT_EQ(out2_[3].write_count, 0u);
+}
+
+}  // namespace testing
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "control_core.h"
+
+namespace esphome {
+namespace open_zoning {
+namespace testing {
+
+// Thermostat calls of one zone (ControlCore::IN_* nibbles)
+constexpr uint8_t OFF = 0;
+constexpr uint8_t FAN = ControlCore::IN_G;
+constexpr uint8_t HEAT1 = ControlCore::IN_Y1 | ControlCore::IN_G;
+constexpr uint8_t HEAT2 = ControlCore::IN_Y1 | ControlCore::IN_Y2 | ControlCore::IN_G;
+constexpr uint8_t COOL1 = ControlCore::IN_Y1 | ControlCore::IN_G | ControlCore::IN_OB;
+constexpr uint8_t COOL2 = ControlCore::IN_Y1 | ControlCore::IN_Y2 | ControlCore::IN_G | ControlCore::IN_OB;
+constexpr uint8_t NO_FAN = ControlCore::IN_Y1;  // compressor call without G: error
+
+// Mode indices (select option order)
+constexpr uint8_t ARRET = 0, MODE_FAN = 1, CLIM1 = 2, CLIM2 = 3, CHAUFFAGE1 = 4, CHAUFFAGE2 = 5,
+                  PURGE_CHAUFFAGE = 6, PURGE_CLIM = 7;
+
+constexpr uint32_t MIN = 60000;
+
+/// A ControlCore with three enabled zones and its input word. Times are
+/// absolute millis() values; run(t) evaluates at t like a periodic poll.
+class CoreTest : public ::testing::Test {
+ protected:
+  static constexpr uint8_t ZONES = 3;
+
+  void SetUp() override {
+    core_.reset(ZONES);
+    in_.enabled = (1u << ZONES) - 1;
+  }
+
+  void call(uint8_t zone, uint8_t bits) {
+    const uint8_t shift = 4 * zone;
+    in_.thermostats = (in_.thermostats & ~(static_cast<InputWord>(0xF) << shift)) |
+                      (static_cast<InputWord>(bits) << shift);
+  }
+  void enable(uint8_t zone, bool on) {
+    in_.enabled = on ? (in_.enabled | (1u << zone)) : (in_.enabled & ~(1u << zone));
+  }
+
+  CoreOutput run(uint32_t t, bool count_errors = true) {
+    now_ = t;
+    return core_.evaluate(in_, t, count_errors);
+  }
+  /// Periodic polls every step ms from the last run time up to t included
+  CoreOutput run_until(uint32_t t, uint32_t step = 10000) {
+    CoreOutput out = core_.get_output();
+    while (static_cast<int32_t>(t - now_) > 0) {
+      const uint32_t next = static_cast<int32_t>(t - now_) > static_cast<int32_t>(step) ? now_ + step : t;
+      out = run(next);
+    }
+    return out;
+  }
+
+  ZoneState state(uint8_t zone) const { return core_.zone_state(zone); }
+  uint8_t mode() const { return core_.get_current_mode(); }
+  bool damper_open(uint8_t zone) const { return (core_.get_output().dampers >> zone) & 1u; }
+
+  ControlCore core_;
+  CoreInput in_{};
+  uint32_t now_{0};
+};
+
+}  // namespace testing
+}  // namespace open_zoning
+}  // namespace esphome
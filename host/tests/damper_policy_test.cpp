@@ -0,0 +1,119 @@
+// PASS 4 damper policy: minimum dwell, idle hold and close lookahead act on
+// the free dampers (OFF zones) only; the default policy is covered by
+// control_core_test.cpp.
+
+#include <gtest/gtest.h>
+
+#include "core_fixture.h"
+
+namespace esphome {
+namespace open_zoning {
+namespace testing {
+namespace {
+
+class DamperPolicyTest : public CoreTest {
+ protected:
+  // Zone 0 calls for heat from the poll at `start` to the one after `end`,
+  // then purges for 5 min (default minimum cycle 8 min); polls every 10 s
+  void heat_cycle(uint32_t start, uint32_t end) {
+    run_until(start - 10000);
+    call(0, HEAT1);
+    run_until(end);
+    call(0, OFF);
+  }
+};
+
+TEST_F(DamperPolicyTest, IdleHoldLeavesFreeDampersWhereTheyAre) {
+  core_.set_damper_idle_hold(true);
+  run(1000);
+  EXPECT_EQ(core_.get_output().dampers, 0b111);  // at rest every damper is open
+
+  heat_cycle(20000, 10 * MIN);
+  EXPECT_EQ(core_.get_output().dampers, 0b001);
+  run_until(20 * MIN);
+  ASSERT_EQ(mode(), ARRET);
+  EXPECT_EQ(core_.get_output().dampers, 0b001);  // left as the purge had them
+
+  call(1, HEAT1);  // a call opens its damper, the free ones close
+  run_until(21 * MIN);
+  EXPECT_EQ(core_.get_output().dampers, 0b010);
+
+  call(1, OFF);
+  run_until(40 * MIN);
+  ASSERT_EQ(mode(), ARRET);
+  EXPECT_EQ(core_.get_output().dampers, 0b010);
+  core_.set_auto_mode(false);  // manual mode: the unit may blow into any zone
+  run_until(41 * MIN);
+  EXPECT_EQ(core_.get_output().dampers, 0b111);
+}
+
+TEST_F(DamperPolicyTest, MinDwellKeepsAFreeDamperUntilItEnds) {
+  core_.set_damper_min_dwell(30 * MIN);
+  heat_cycle(10000, 5 * MIN);
+  EXPECT_EQ(core_.get_output().dampers, 0b001);
+  run_until(20 * MIN);
+  ASSERT_EQ(mode(), ARRET);
+  EXPECT_EQ(core_.get_output().dampers, 0b001);  // closed at 10 s, free again 30 min later
+
+  uint32_t at = 0;
+  ASSERT_TRUE(core_.next_deadline(now_, &at));
+  EXPECT_EQ(at, 10000 + 30 * MIN);
+  run(10000 + 30 * MIN - 1);
+  EXPECT_EQ(core_.get_output().dampers, 0b001);
+  run(10000 + 30 * MIN);
+  EXPECT_EQ(core_.get_output().dampers, 0b111);
+
+  // Required positions ignore the dwell: zones 1 and 2 just opened, yet
+  // the WAIT closes; zone 0 has not moved since the start and closes too
+  call(1, COOL1);
+  call(2, HEAT1);
+  run(10000 + 31 * MIN);
+  EXPECT_EQ(state(1), ZoneState::WAIT);
+  EXPECT_EQ(core_.get_output().dampers, 0b100);
+}
+
+TEST_F(DamperPolicyTest, SettledCoreWakesAtTheDwellEnd) {
+  core_.set_damper_min_dwell(30 * MIN);
+  heat_cycle(10000, 5 * MIN);
+  run_until(20 * MIN);
+  const uint32_t skipped = core_.get_skipped_evaluations();
+  run_until(10000 + 30 * MIN);
+  EXPECT_GT(core_.get_skipped_evaluations(), skipped);  // settled while the dwell runs
+  EXPECT_EQ(core_.get_output().dampers, 0b111);
+}
+
+TEST_F(DamperPolicyTest, CloseLookaheadSkipsTheCloseBeforeTheLastPurge) {
+  // Zones 1 and 2 reopen at the end of the first cycle and dwell 10 min:
+  // still open when zone 0 calls again, free while its purge runs
+  core_.set_damper_min_dwell(10 * MIN);
+  heat_cycle(10000, 2 * MIN);
+  run_until(15 * MIN);
+  ASSERT_EQ(core_.get_output().dampers, 0b111);
+  heat_cycle(15 * MIN, 16 * MIN);
+  EXPECT_EQ(core_.get_output().dampers, 0b111);
+
+  // Second cycle: minimum cycle to ~23 min, purge to ~28 min, dwell ends
+  // at ~24 min with the purge ending within the lookahead
+  core_.set_damper_close_lookahead(10 * MIN);
+  run_until(26 * MIN);
+  ASSERT_EQ(state(0), ZoneState::PURGE);
+  EXPECT_EQ(core_.get_output().dampers, 0b111);
+  run_until(30 * MIN);
+  ASSERT_EQ(mode(), ARRET);
+  EXPECT_EQ(core_.get_output().dampers, 0b111);
+}
+
+TEST_F(DamperPolicyTest, WithoutLookaheadTheFreeDampersCloseForThePurge) {
+  core_.set_damper_min_dwell(10 * MIN);
+  heat_cycle(10000, 2 * MIN);
+  run_until(15 * MIN);
+  heat_cycle(15 * MIN, 16 * MIN);
+  run_until(26 * MIN);
+  ASSERT_EQ(state(0), ZoneState::PURGE);
+  EXPECT_EQ(core_.get_output().dampers, 0b001);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,152 @@
+// DamperScheduler: per-motor phases, concurrent timing, motion cap and plan
+// merging; then the adapter driving it through switches and the latch.
+
+#include <gtest/gtest.h>
+
+#include "controller_fixture.h"
+#include "damper_scheduler.h"
+
+namespace esphome {
+namespace open_zoning {
+namespace testing {
+namespace {
+
+// ---------------------------------------------------------------------------
+// DamperScheduler
+// ---------------------------------------------------------------------------
+
+TEST(DamperSchedulerTest, EveryMotorStopsAndReleasesConcurrently) {
+  DamperScheduler s;
+  for (uint8_t i = 0; i < 6; i++) s.plan(i, i % 2 == 0, 1000);
+  ASSERT_EQ(s.due(DamperScheduler::STOP_OPPOSITE, 1000), 0x3F);
+  s.advance(0x3F, 1000);
+
+  EXPECT_EQ(s.due(DamperScheduler::STOP_SAME, 1049), 0);
+  ASSERT_EQ(s.due(DamperScheduler::STOP_SAME, 1050), 0x3F);
+  s.advance(0x3F, 1050);
+
+  EXPECT_EQ(s.due(DamperScheduler::RELEASE, 1299), 0);
+  ASSERT_EQ(s.due(DamperScheduler::RELEASE, 1300), 0x3F);
+  s.advance(0x3F, 1300);
+  EXPECT_EQ(s.in_flight(), 0);
+  EXPECT_FALSE(s.idle());  // inrush window
+  s.expire(1550);
+  EXPECT_TRUE(s.idle());
+}
+
+TEST(DamperSchedulerTest, CapLimitsMotorsEngagedPerInrushWindow) {
+  DamperScheduler s;
+  s.set_max_moving(2);
+  s.set_inrush_window(400);
+  for (uint8_t i = 0; i < 4; i++) s.plan(i, true, 0);
+  s.released(0x0F, 0);
+
+  ASSERT_EQ(s.due(DamperScheduler::RELEASE, 250), 0b0011);  // lowest zones first
+  s.advance(0b0011, 250);
+  EXPECT_EQ(s.due(DamperScheduler::RELEASE, 649), 0);
+  EXPECT_EQ(s.due(DamperScheduler::RELEASE, 650), 0b1100);
+}
+
+TEST(DamperSchedulerTest, LatchReleaseSkipsTheSecondStop) {
+  DamperScheduler s;
+  s.plan(2, false, 0);
+  s.released(0b100, 10);
+  EXPECT_EQ(s.phase(2), DamperScheduler::RELEASE);
+  EXPECT_EQ(s.due(DamperScheduler::RELEASE, 259), 0);
+  EXPECT_EQ(s.due(DamperScheduler::RELEASE, 260), 0b100);
+}
+
+TEST(DamperSchedulerTest, NewTargetMergesIntoThePlanInFlight) {
+  DamperScheduler s;
+  for (uint8_t i = 0; i < 3; i++) s.plan(i, true, 0);
+  s.advance(0b111, 0);  // all in STOP_SAME
+  s.advance(0b001, 50);  // zone 1: RELEASE, both coils off
+
+  // Both coils off: keeps its release deadline
+  s.plan(0, false, 100);
+  EXPECT_EQ(s.phase(0), DamperScheduler::RELEASE);
+  EXPECT_EQ(s.due(DamperScheduler::RELEASE, 300), 0b001);
+  EXPECT_FALSE(s.target_open(0));
+
+  // Only the new target coil was released: the other one must be stopped too
+  s.plan(1, false, 100);
+  EXPECT_EQ(s.phase(1), DamperScheduler::STOP_OPPOSITE);
+
+  // Same target: untouched
+  s.plan(2, true, 100);
+  EXPECT_EQ(s.phase(2), DamperScheduler::STOP_SAME);
+}
+
+TEST(DamperSchedulerTest, EngagedMotorRestartsOnANewTarget) {
+  DamperScheduler s;
+  s.plan(0, true, 0);
+  s.released(0b1, 0);
+  s.advance(0b1, 250);
+  ASSERT_EQ(s.phase(0), DamperScheduler::SETTLE);
+  s.plan(0, false, 300);
+  EXPECT_EQ(s.phase(0), DamperScheduler::STOP_OPPOSITE);
+  EXPECT_EQ(s.due(DamperScheduler::STOP_OPPOSITE, 300), 0b1);
+}
+
+// ---------------------------------------------------------------------------
+// Adapter
+// ---------------------------------------------------------------------------
+
+class DamperMotionTest : public ControllerTest {
+ protected:
+  /// Virtual time of the last write of each switch to `state`
+  void track(switch_::Switch &sw, bool state, uint32_t *at) {
+    sw.add_on_state_callback([state, at](bool s) {
+      if (s == state) *at = host::now();
+    });
+  }
+
+  bool seen(const EventLog &log, Event id) const {
+    for (uint8_t i = 0; i < log.size(); i++) {
+      if (log.at(i).id == id) return true;
+    }
+    return false;
+  }
+};
+
+TEST_F(DamperMotionTest, SwitchesRepositionEveryZoneInAboutOneMotorCycle) {
+  uint32_t released[ZONES]{}, engaged[ZONES]{};
+  for (uint8_t i = 0; i < ZONES; i++) {
+    track(open_[i], false, &released[i]);
+    track(open_[i], true, &engaged[i]);
+  }
+  const uint32_t t0 = host::now();
+  start();
+  step(1000);  // idle unit: every damper opens
+
+  for (uint8_t i = 0; i < ZONES; i++) {
+    ASSERT_TRUE(open_[i].state) << "zone " << i + 1;
+    EXPECT_FALSE(close_[i].state);
+    EXPECT_GE(engaged[i] - released[i], DamperScheduler::RELEASE_MS);  // per-motor safety kept
+    EXPECT_LT(engaged[i] - t0, 500u);  // serial queue: ~1.2s for three zones
+  }
+  EXPECT_TRUE(ctrl_.get_damper_scheduler().idle());
+}
+
+TEST_F(DamperMotionTest, PortPlanMergesTheNewTargets) {
+  ctrl_.set_damper_port(0x22, false);
+  for (uint8_t i = 0; i < ZONES; i++) ctrl_.set_zone_damper_pins(i, 2 * i, 2 * i + 1);
+  ctrl_.set_event_log_live(false);
+  start();
+  step(50);  // stop write done, every motor in its release window
+  ASSERT_EQ(ctrl_.get_damper_scheduler().in_flight(), 0b111);
+
+  call(0, ControlCore::IN_Y1 | ControlCore::IN_G);  // only zone 1 stays open
+  step(1000);
+
+  EXPECT_TRUE(seen(ctrl_.get_event_log(), Event::DAMPER_MERGED));
+  EXPECT_EQ(bus_.get_register(0x22, 0x14), 0b101001);  // open 1, close 2, close 3
+  EXPECT_TRUE(open_[0].state);
+  EXPECT_TRUE(close_[1].state);
+  EXPECT_TRUE(close_[2].state);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,112 @@
+// EventLog: records pushed without formatting, formatted on drain / dump.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+
+#include "controller_fixture.h"
+#include "event_log.h"
+#include "platform.h"
+
+namespace esphome {
+namespace open_zoning {
+namespace testing {
+
+class EventLogTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host::reset();
+    host::set_log_level(ESPHOME_LOG_LEVEL_DEBUG);
+    host::set_log_sink(nullptr);
+  }
+
+  EventLog log_;
+};
+
+TEST_F(EventLogTest, PushFormatsNothingUntilDrained) {
+  log_.push(1000, Event::ZONE_PURGE_DONE, 1);
+  log_.push(1000, Event::MODE_CHANGE, EventLog::NO_ZONE, 6 << 8 | 0, 0);
+  EXPECT_EQ(host::log_lines(), 0u);
+  EXPECT_EQ(log_.pending(), 2);
+
+  EXPECT_EQ(log_.drain(1), 1);
+  EXPECT_EQ(host::log_lines(), 1u);
+  EXPECT_EQ(log_.drain(8), 1);
+  EXPECT_EQ(host::log_lines(), 2u);
+  EXPECT_EQ(log_.pending(), 0);
+  EXPECT_EQ(log_.size(), 2);  // still retained for dump()
+}
+
+TEST_F(EventLogTest, PeriodicCycleSummaryIsOnlyDumped) {
+  log_.push(1000, Event::CYCLE_DONE, EventLog::NO_ZONE, 0, 2);  // update() poll
+  log_.push(1100, Event::CYCLE_DONE, EventLog::NO_ZONE, 4, 0);  // event-driven run
+  EXPECT_EQ(log_.drain(8), 2);
+  EXPECT_EQ(host::log_lines(), 1u);
+
+  log_.dump();
+  EXPECT_EQ(host::log_lines(), 1u + 1 + 2);  // header + both records
+}
+
+TEST_F(EventLogTest, FormatKeepsTheOriginalLogLines) {
+  char line[112];
+  EventLog::format({0, Event::ZONE_STATE, 2, static_cast<int32_t>(ZoneState::OFF),
+                    static_cast<int32_t>(ZoneState::HEATING_STAGE1)},
+                   line, sizeof(line));
+  EXPECT_STREQ(line, "Zone 3: Off -> Heating Stage 1");
+  EventLog::format({0, Event::ZONE_HELD, 0, 1 << 8 | 2, 0}, line, sizeof(line));
+  EXPECT_STREQ(line, "PASS2.5: Zone 1 held (WAIT) — waiting for 1/2 zones");
+  EventLog::format({0, Event::MODE_CHANGE, EventLog::NO_ZONE, 0 << 8 | 4, 4}, line, sizeof(line));
+  EXPECT_STREQ(line, "Mode change: 0 -> 4 (priority: 4)");
+}
+
+TEST_F(EventLogTest, WrapKeepsTheNewestAndCountsUndrainedLosses) {
+  for (int i = 0; i < EventLog::CAPACITY + 5; i++) log_.push(i, Event::CYCLE_DONE, EventLog::NO_ZONE, i);
+  EXPECT_EQ(log_.size(), EventLog::CAPACITY);
+  EXPECT_EQ(log_.get_dropped(), 5u);
+  EXPECT_EQ(log_.at(0).a, 5);  // oldest retained
+  EXPECT_EQ(log_.at(EventLog::CAPACITY - 1).a, EventLog::CAPACITY + 4);
+}
+
+// The adapter: nothing is formatted inside the pipeline run
+TEST_F(ControllerTest, PipelineRecordsEventsAndLoopFormatsThem) {
+  host::set_log_level(ESPHOME_LOG_LEVEL_DEBUG);
+  start();
+  call(0, HEAT1);
+  const uint32_t lines = host::log_lines();
+  ctrl_.update();
+  EXPECT_EQ(host::log_lines(), lines);
+  EXPECT_GT(ctrl_.get_event_log().pending(), 0);
+
+  step(1000);
+  EXPECT_EQ(ctrl_.get_event_log().pending(), 0);
+  EXPECT_GT(host::log_lines(), lines);
+}
+
+TEST_F(ControllerTest, IdlePollsFormatNothingLive) {
+  host::set_log_level(ESPHOME_LOG_LEVEL_DEBUG);
+  start();
+  step(1000);
+  const uint32_t lines = host::log_lines();
+  step(60000);
+  EXPECT_EQ(host::log_lines(), lines);
+  EXPECT_GT(ctrl_.get_event_log().size(), 6);  // the polls are in the ring
+}
+
+TEST_F(ControllerTest, EventsStayInTheRingWhenNotLive) {
+  host::set_log_level(ESPHOME_LOG_LEVEL_DEBUG);
+  ctrl_.set_event_log_live(false);
+  start();
+  call(0, HEAT1);
+  step(1000);
+  const uint32_t lines = host::log_lines();
+  step(60000);
+  EXPECT_EQ(host::log_lines(), lines);  // idle cycles: recorded, never formatted
+
+  ctrl_.dump_event_log();
+  EXPECT_EQ(host::log_lines(), lines + 1 + ctrl_.get_event_log().size());  // header + one line per record
+}
+
+}  // namespace testing
+}  // namespace open_zoning
+}  // namespace esphome
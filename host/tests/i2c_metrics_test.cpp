@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include "controller_fixture.h"
+#include "i2c_metrics.h"
+
+namespace esphome {
+namespace open_zoning {
+namespace testing {
+namespace {
+
+constexpr uint8_t HEAT1 = ControlCore::IN_Y1 | ControlCore::IN_G;
+
+// ---------------------------------------------------------------------------
+// MeteredBus
+// ---------------------------------------------------------------------------
+
+class MeteredBusTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host::reset();
+    host::set_now(1000);
+    meter_.set_parent(&bus_);
+  }
+
+  host::FakeBus bus_;
+  MeteredBus meter_;
+};
+
+TEST_F(MeteredBusTest, CountsTransactionsPerAddress) {
+  const uint8_t latch[3] = {0x14, 0xAA, 0x55};
+  uint8_t gpio[2];
+  ASSERT_EQ(meter_.write(0x21, latch, sizeof(latch)), i2c::ERROR_OK);
+  ASSERT_EQ(meter_.read(0x21, gpio, sizeof(gpio)), i2c::ERROR_OK);
+  EXPECT_EQ(bus_.get_register(0x21, 0x14), 0xAA);  // forwarded unchanged
+
+  const I2cAddressMetrics *m = meter_.get(0x21);
+  ASSERT_NE(m, nullptr);
+  EXPECT_EQ(m->transactions, 2u);
+  EXPECT_EQ(m->nacks, 0u);
+  EXPECT_EQ(m->latency[0], 2u);
+  EXPECT_EQ(meter_.get(0x20)->transactions, 0u);
+  EXPECT_EQ(meter_.get(0x50), nullptr);
+}
+
+TEST_F(MeteredBusTest, CountsNacksAndTheRetryOfAFailedWrite) {
+  const uint8_t latch[3] = {0x14, 0x0F, 0xFF};
+  bus_.set_dead(0x22, true);
+  EXPECT_EQ(meter_.write(0x22, latch, sizeof(latch)), i2c::ERROR_NOT_ACKNOWLEDGED);
+  bus_.set_dead(0x22, false);
+  EXPECT_EQ(meter_.write(0x22, latch, sizeof(latch)), i2c::ERROR_OK);
+
+  const I2cAddressMetrics *m = meter_.get(0x22);
+  EXPECT_EQ(m->transactions, 2u);
+  EXPECT_EQ(m->nacks, 1u);
+  EXPECT_EQ(m->retries, 1u);
+  EXPECT_FALSE(m->last_failed);
+}
+
+TEST_F(MeteredBusTest, RecentlyOkExpiresAndClearsOnFailure) {
+  const uint8_t reg = 0x12;
+  meter_.write(0x20, &reg, 1);
+  EXPECT_TRUE(meter_.recently_ok(0x20, 10000));
+  host::advance(10000);
+  EXPECT_FALSE(meter_.recently_ok(0x20, 10000));
+
+  meter_.write(0x20, &reg, 1);
+  bus_.set_dead(0x20, true);
+  meter_.write(0x20, &reg, 1);
+  EXPECT_FALSE(meter_.recently_ok(0x20, 10000));
+}
+
+// ---------------------------------------------------------------------------
+// Watchdog (controller)
+// ---------------------------------------------------------------------------
+
+class I2cWatchdogTest : public ControllerTest {
+ protected:
+  void SetUp() override {
+    ControllerTest::SetUp();
+    ctrl_.set_i2c_health_sensor(&health_);
+  }
+
+  binary_sensor::BinarySensor health_;
+};
+
+TEST_F(I2cWatchdogTest, RecentInputReadsReplaceTheProbe) {
+  ctrl_.add_input_port(0x20, true);
+  bus_.set_gpio(0x20, 0xFFFF);
+  for (uint8_t i = 0; i < ZONES; i++) ctrl_.set_zone_input_pins(i, 0, 4 * i, 4 * i + 1, 4 * i + 2, 4 * i + 3);
+  start();
+  step(3 * ctrl_.get_update_interval());
+
+  // 0x20 is read every sample; 0x21 and 0x22 only see the probes
+  EXPECT_GE(ctrl_.get_i2c_probes_skipped(), 2u);
+  EXPECT_EQ(ctrl_.get_i2c_metrics().get(0x21)->transactions, 3u);
+  EXPECT_EQ(ctrl_.get_i2c_metrics().get(0x22)->transactions, 3u);
+  EXPECT_TRUE(health_.state);
+}
+
+TEST_F(I2cWatchdogTest, OneDeadExpanderClearsHealthWithoutReboot) {
+  start();
+  call(0, HEAT1);
+  bus_.set_dead(0x22, true);
+  step(5 * ctrl_.get_update_interval());
+
+  EXPECT_FALSE(health_.state);
+  EXPECT_EQ(host::reboot_requests(), 0u);
+  EXPECT_GE(ctrl_.get_i2c_metrics().get(0x22)->nacks, 3u);
+
+  bus_.set_dead(0x22, false);
+  step(ctrl_.get_update_interval());
+  EXPECT_TRUE(health_.state);
+}
+
+TEST_F(I2cWatchdogTest, StuckBusRebootsAtTheThreshold) {
+  ctrl_.set_i2c_error_threshold(3);
+  start();
+  for (uint8_t address = 0x20; address <= 0x22; address++) bus_.set_dead(address, true);
+  step(2 * ctrl_.get_update_interval());
+  EXPECT_EQ(host::reboot_requests(), 0u);
+  step(ctrl_.get_update_interval());
+  EXPECT_EQ(host::reboot_requests(), 1u);
+}
+
+TEST_F(I2cWatchdogTest, StuckInputExpanderAloneReboots) {
+  ctrl_.set_i2c_error_threshold(3);
+  start();
+  call(0, HEAT1);
+  bus_.set_dead(0x20, true);  // 0x21 and 0x22 still answer
+  step(2 * ctrl_.get_update_interval());
+  EXPECT_EQ(host::reboot_requests(), 0u);
+  step(ctrl_.get_update_interval());
+  EXPECT_EQ(host::reboot_requests(), 1u);
+  EXPECT_GE(ctrl_.get_i2c_metrics().get(0x21)->transactions, 3u);
+}
+
+TEST_F(I2cWatchdogTest, ExpanderOutOfTheRebootListOnlyClearsHealth) {
+  ctrl_.add_i2c_watch_address(0x20);
+  ctrl_.add_i2c_watch_address(0x21, true);
+  start();
+  bus_.set_dead(0x20, true);
+  step(5 * ctrl_.get_update_interval());
+  EXPECT_FALSE(health_.state);
+  EXPECT_EQ(host::reboot_requests(), 0u);
+
+  bus_.set_dead(0x20, false);
+  bus_.set_dead(0x21, true);
+  step(3 * ctrl_.get_update_interval());
+  EXPECT_EQ(host::reboot_requests(), 1u);
+}
+
+TEST_F(I2cWatchdogTest, WatchListReplacesTheDefaults) {
+  ctrl_.add_i2c_watch_address(0x24);
+  start();
+  bus_.set_dead(0x20, true);
+  step(3 * ctrl_.get_update_interval());
+  EXPECT_TRUE(health_.state);
+  EXPECT_EQ(ctrl_.get_i2c_metrics().get(0x20)->transactions, 0u);
+  EXPECT_EQ(ctrl_.get_i2c_metrics().get(0x24)->transactions, 3u);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace open_zoning
+}  // namespace esphome
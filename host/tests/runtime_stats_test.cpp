@@ -0,0 +1,96 @@
+// RuntimeStats: time and entries per zone state and per unit mode, kept by
+// the core at each commit; then the adapter's runtime sensors.
+
+#include <gtest/gtest.h>
+
+#include "controller_fixture.h"
+#include "core_fixture.h"
+
+namespace esphome {
+namespace open_zoning {
+namespace testing {
+namespace {
+
+constexpr uint32_t T0 = 1000;
+
+// ---------------------------------------------------------------------------
+// Core
+// ---------------------------------------------------------------------------
+
+TEST_F(CoreTest, RuntimeFollowsACompleteHeatingCycle) {
+  call(0, HEAT1);
+  run(T0);
+  run_until(T0 + 10 * MIN - 10000);
+  call(0, OFF);
+  run(T0 + 10 * MIN);
+  run_until(T0 + 20 * MIN);  // purge 10–15 min, then off
+
+  const RuntimeStats &rt = core_.get_runtime();
+  const uint32_t now = T0 + 20 * MIN;
+  EXPECT_EQ(rt.zone_ms(0, ZoneState::HEATING_STAGE1, now), 10 * MIN);
+  EXPECT_EQ(rt.zone_entries(0, ZoneState::HEATING_STAGE1), 1u);
+  EXPECT_EQ(rt.zone_ms(0, ZoneState::PURGE, now), 5 * MIN);
+  EXPECT_EQ(rt.zone_ms(0, ZoneState::OFF, now), 5 * MIN);
+  EXPECT_EQ(rt.zone_entries(0, ZoneState::OFF), 1u);
+  EXPECT_EQ(rt.zone_ms(1, ZoneState::OFF, now), 20 * MIN);  // never left it
+  EXPECT_EQ(rt.zone_entries(1, ZoneState::OFF), 0u);
+
+  EXPECT_EQ(rt.mode_ms(CHAUFFAGE1, now), 10 * MIN);
+  EXPECT_EQ(rt.mode_entries(CHAUFFAGE1), 1u);
+  EXPECT_EQ(rt.mode_ms(PURGE_CHAUFFAGE, now), 5 * MIN);
+  EXPECT_EQ(rt.mode_ms(ARRET, now), 5 * MIN);
+}
+
+TEST_F(CoreTest, RuntimeOfTheStateInProgressNeedsNoEvaluation) {
+  call(0, COOL1);
+  run(T0);
+  run_until(T0 + 9 * MIN);
+  ASSERT_GT(core_.get_skipped_evaluations(), 0u);  // settled: no commit since T0
+
+  const RuntimeStats &rt = core_.get_runtime();
+  EXPECT_EQ(rt.zone_ms(0, ZoneState::COOLING_STAGE1, T0 + 9 * MIN), 9 * MIN);
+  EXPECT_EQ(rt.mode_ms(CLIM1, T0 + 9 * MIN + 30000), 9 * MIN + 30000);
+}
+
+TEST_F(CoreTest, ErrorStateHasItsOwnCounters) {
+  call(0, NO_FAN);
+  run(T0);
+  run(T0 + 10000);  // confirmed on the second poll
+  run(T0 + 70000);
+  EXPECT_EQ(core_.get_runtime().zone_entries(0, ZoneState::ERROR), 1u);
+  EXPECT_EQ(core_.get_runtime().zone_ms(0, ZoneState::ERROR, T0 + 70000), 60000u);
+}
+
+// ---------------------------------------------------------------------------
+// Adapter
+// ---------------------------------------------------------------------------
+
+class RuntimeSensorTest : public ControllerTest {
+ protected:
+  void SetUp() override {
+    ControllerTest::SetUp();
+    ctrl_.set_runtime_publish_interval(15 * 60000);
+    ctrl_.add_runtime_sensor(&heat_hours_, OpenZoningController::RUNTIME_UNIT, CHAUFFAGE1, false);
+    ctrl_.add_runtime_sensor(&heat_starts_, OpenZoningController::RUNTIME_UNIT, CHAUFFAGE1, true);
+    ctrl_.add_runtime_sensor(&zone_heat_, 0, static_cast<uint8_t>(ZoneState::HEATING_STAGE1), false);
+  }
+
+  sensor::Sensor heat_hours_, heat_starts_, zone_heat_;
+};
+
+TEST_F(RuntimeSensorTest, PublishesOnItsOwnSlowCadence) {
+  start();
+  call(0, HEAT1);
+  step(30 * 60000 + 1000);
+
+  // At start, then every 15 min — not once per update
+  EXPECT_EQ(heat_hours_.publish_count, 3u);
+  EXPECT_NEAR(heat_hours_.state, 0.5f, 0.01f);
+  EXPECT_EQ(heat_starts_.state, 1.0f);
+  EXPECT_NEAR(zone_heat_.state, 0.5f, 0.01f);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,93 @@
+// StageTimings: per-stage statistics and the stages the controller times.
+
+#include <gtest/gtest.h>
+
+#include "controller_fixture.h"
+#include "stage_timing.h"
+
+#ifdef OPEN_ZONING_STAGE_TIMING
+
+namespace esphome {
+namespace open_zoning {
+namespace testing {
+
+TEST(StageStatsTest, HistogramBucketsGrowByFour) {
+  EXPECT_EQ(StageStats::bucket(0), 0);
+  EXPECT_EQ(StageStats::bucket(15), 0);
+  EXPECT_EQ(StageStats::bucket(16), 1);
+  EXPECT_EQ(StageStats::bucket(63), 1);
+  EXPECT_EQ(StageStats::bucket(64), 2);
+  EXPECT_EQ(StageStats::bucket(1023), 3);
+  EXPECT_EQ(StageStats::bucket(1024), 4);
+  EXPECT_EQ(StageStats::bucket(65535), 6);
+  EXPECT_EQ(StageStats::bucket(65536), 7);
+  EXPECT_EQ(StageStats::bucket(UINT32_MAX), 7);
+}
+
+TEST(StageStatsTest, KeepsMinMaxMeanAndAWindow) {
+  StageStats s;
+  s.add(10);
+  s.add(30);
+  s.add(5000);
+  EXPECT_EQ(s.count, 3u);
+  EXPECT_EQ(s.min_us, 10u);
+  EXPECT_EQ(s.max_us, 5000u);
+  EXPECT_EQ(s.mean_us(), 1680u);
+  EXPECT_EQ(s.histogram[0], 1u);
+  EXPECT_EQ(s.histogram[1], 1u);
+  EXPECT_EQ(s.histogram[5], 1u);
+
+  s.reset_window();
+  s.add(20);
+  EXPECT_EQ(s.window_max_us, 20u);
+  EXPECT_EQ(s.window_mean_us(), 20u);
+  EXPECT_EQ(s.max_us, 5000u);  // the since-boot stats are kept
+}
+
+// Microsecond clock that moves 10 µs at every read
+static uint32_t ticking_us = 0;
+static uint32_t ticking_clock() { return ticking_us += 10; }
+
+TEST_F(ControllerTest, EveryPassAndAdapterStageIsTimed) {
+  ctrl_.get_stage_timings().set_clock(&ticking_clock);
+  start();
+  step(1000);  // first poll
+  call(0, HEAT1);
+  step(1000);  // event run
+
+  const StageTimings &t = ctrl_.get_stage_timings();
+  const uint32_t runs = t.get(Stage::PIPELINE).count;
+  EXPECT_EQ(runs, 2u);
+  for (Stage s : {Stage::PASS1, Stage::PASS1_5, Stage::PASS2, Stage::PASS2_5, Stage::PASS3, Stage::PASS4,
+                  Stage::PASS5, Stage::COMMIT, Stage::APPLY_DAMPERS, Stage::APPLY_OUTPUTS, Stage::PUBLISH}) {
+    EXPECT_EQ(t.get(s).count, runs) << StageTimings::stage_name(s);
+    EXPECT_GE(t.get(s).min_us, 10u) << StageTimings::stage_name(s);
+  }
+  EXPECT_EQ(t.get(Stage::APPLY_MODE).count, 1u);  // the mode change
+  EXPECT_GT(t.get(Stage::DAMPER_OP).count, 0u);   // the switch queue ops, from loop()
+  EXPECT_GT(t.get(Stage::PIPELINE).max_us, t.get(Stage::PASS1).max_us);
+}
+
+TEST_F(ControllerTest, StageSensorsPublishTheWindowEveryInterval) {
+  sensor::Sensor pipeline_max, pass1_mean;
+  ctrl_.get_stage_timings().set_clock(&ticking_clock);
+  ctrl_.set_stage_timing_publish_interval(60000);
+  ctrl_.set_stage_sensors(static_cast<uint8_t>(Stage::PIPELINE), &pipeline_max, nullptr);
+  ctrl_.set_stage_sensors(static_cast<uint8_t>(Stage::PASS1), nullptr, &pass1_mean);
+  start();
+  step(1000);
+  EXPECT_EQ(pipeline_max.publish_count, 1u);
+  EXPECT_GT(pipeline_max.state, 0.0f);
+  EXPECT_EQ(pass1_mean.state, 10.0f);
+
+  step(50000);
+  EXPECT_EQ(pipeline_max.publish_count, 1u);
+  step(10000);
+  EXPECT_EQ(pipeline_max.publish_count, 2u);
+}
+
+}  // namespace testing
+}  // namespace open_zoning
+}  // namespace esphome
+
+#endif  // OPEN_ZONING_STAGE_TIMING
@@ -0,0 +1,178 @@
+// StateJournal: cadence, slot rotation, recovery from a corrupt record; then
+// the adapter persisting through it.
+
+#include <gtest/gtest.h>
+
+#include "controller_fixture.h"
+#include "state_journal.h"
+
+namespace esphome {
+namespace open_zoning {
+namespace testing {
+namespace {
+
+constexpr uint8_t HEAT1 = ControlCore::IN_Y1 | ControlCore::IN_G;
+constexpr uint32_t INTERVAL = 600000;
+
+std::vector<uint8_t> &slot_bytes(uint8_t slot) {
+  return host::preference_store()[fnv1_hash("open_zoning_journal") + slot];
+}
+
+// ---------------------------------------------------------------------------
+// StateJournal
+// ---------------------------------------------------------------------------
+
+class StateJournalTest : public ::testing::Test {
+ protected:
+  void SetUp() override { host::reset(); }
+
+  /// A journal as after a reboot: fresh object, loaded from the store
+  PersistedState reload(bool *found = nullptr) {
+    StateJournal j;
+    PersistedState s;
+    const bool ok = j.load(&s);
+    if (found) *found = ok;
+    return s;
+  }
+};
+
+TEST_F(StateJournalTest, ChangesAreWrittenOncePerInterval) {
+  StateJournal j;
+  PersistedState s;
+  ASSERT_FALSE(j.load(&s));
+
+  for (uint32_t n = 1; n <= 50; n++) {
+    s.mode_changes = n;
+    j.update(s, n * 10000);
+    j.loop(n * 10000);
+  }
+  EXPECT_EQ(host::preference_writes, 0u);  // 500 s < 10 min
+  EXPECT_TRUE(j.is_dirty());
+
+  EXPECT_TRUE(j.loop(INTERVAL));
+  EXPECT_EQ(host::preference_writes, 1u);
+  EXPECT_FALSE(j.loop(2 * INTERVAL));  // nothing new
+  EXPECT_EQ(reload().mode_changes, 50u);
+}
+
+TEST_F(StateJournalTest, UrgentUpdateAndFlushWriteAtOnce) {
+  StateJournal j;
+  PersistedState s;
+  j.load(&s);
+  s.last_active_mode = 2;
+  EXPECT_TRUE(j.update(s, 1000, true));
+  s.mode_changes = 7;
+  EXPECT_FALSE(j.update(s, 2000));
+  EXPECT_TRUE(j.flush(3000));
+  EXPECT_FALSE(j.flush(4000));
+  EXPECT_EQ(host::preference_writes, 2u);
+  EXPECT_EQ(reload(), s);
+}
+
+TEST_F(StateJournalTest, RecordsRotateOverTheSlots) {
+  StateJournal j;
+  j.set_slots(3);
+  PersistedState s;
+  j.load(&s);
+  for (uint8_t n = 1; n <= 7; n++) {
+    s.mode_changes = n;
+    j.update(s, 0, true);
+  }
+  // Records 1..7 in slots 0 1 2 0 1 2 0
+  EXPECT_EQ(j.get_last_slot(), 0);
+  EXPECT_EQ(j.get_sequence(), 7u);
+  EXPECT_EQ(host::preference_store().size(), 3u);
+
+  StateJournal after;
+  after.set_slots(3);
+  PersistedState r;
+  ASSERT_TRUE(after.load(&r));
+  EXPECT_EQ(r.mode_changes, 7u);
+  r.mode_changes = 8;
+  after.update(r, 0, true);
+  EXPECT_EQ(after.get_last_slot(), 1);  // continues the rotation
+}
+
+TEST_F(StateJournalTest, CorruptRecordFallsBackToThePreviousOne) {
+  StateJournal j;
+  PersistedState s;
+  j.load(&s);
+  s.mode_changes = 1;
+  j.update(s, 0, true);  // slot 0
+  s.mode_changes = 2;
+  j.update(s, 0, true);  // slot 1
+
+  slot_bytes(1)[8] ^= 0x01;  // torn write: mode_changes no longer matches the checksum
+  bool found = false;
+  EXPECT_EQ(reload(&found).mode_changes, 1u);
+  EXPECT_TRUE(found);
+
+  slot_bytes(0)[0] = StateJournal::VERSION + 1;  // unknown layout
+  reload(&found);
+  EXPECT_FALSE(found);
+}
+
+// ---------------------------------------------------------------------------
+// Adapter
+// ---------------------------------------------------------------------------
+
+class PersistenceTest : public ControllerTest {};
+
+TEST_F(PersistenceTest, PurgeDirectionIsWrittenAtOnceCountersOnTheCadence) {
+  ctrl_.set_persist_interval(15 * 60000);
+  start();
+  call(0, HEAT1);
+  step(ctrl_.get_update_interval());
+  const StateJournal &j = ctrl_.get_state_journal();
+  EXPECT_EQ(j.get_commits(), 1u);  // heating: new purge direction
+  EXPECT_EQ(j.get_state().last_active_mode, 1);
+
+  call(0, 0);
+  step(20 * 60000);  // heating → purge at 8 min, purge → off at 13 min
+  EXPECT_EQ(j.get_state().mode_changes, 3u);
+  EXPECT_EQ(j.get_commits(), 2u);  // both counter changes in one record
+  EXPECT_FALSE(j.is_dirty());
+}
+
+TEST_F(PersistenceTest, ShutdownFlushesThePendingState) {
+  start();
+  call(0, ControlCore::IN_G);
+  step(ctrl_.get_update_interval());
+  ASSERT_TRUE(ctrl_.get_state_journal().is_dirty());  // fan: mode change count only
+
+  ctrl_.on_shutdown();
+  StateJournal after;
+  PersistedState s;
+  ASSERT_TRUE(after.load(&s));
+  EXPECT_EQ(s.mode_changes, 1u);
+}
+
+TEST_F(PersistenceTest, JournalSurvivesAPowerLoss) {
+  start();
+  call(0, HEAT1);
+  step(ctrl_.get_update_interval());
+  ASSERT_EQ(ctrl_.get_state_journal().get_commits(), 1u);
+
+  host::power_loss();  // the records are in flash, not in RTC memory
+  StateJournal after;
+  PersistedState s;
+  ASSERT_TRUE(after.load(&s));
+  EXPECT_EQ(s.last_active_mode, 1);
+}
+
+TEST_F(PersistenceTest, LegacyPurgeDirectionIsMigrated) {
+  uint8_t cooling = 2;
+  global_preferences->make_preference<uint8_t>(fnv1_hash("open_zoning_last_active_mode")).save(&cooling);
+  start();
+  step(INTERVAL + ctrl_.get_update_interval());
+
+  StateJournal after;
+  PersistedState s;
+  ASSERT_TRUE(after.load(&s));
+  EXPECT_EQ(s.last_active_mode, 2);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace open_zoning
+}  // namespace esphome
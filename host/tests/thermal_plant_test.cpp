@@ -0,0 +1,123 @@
+// ThermalPlant: RC zones, thermostat hysteresis, air through the open
+// dampers; then PlantLoop closing the loop through ControlCore.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "core_fixture.h"
+#include "platform.h"
+#include "thermal_plant.h"
+
+namespace esphome {
+namespace open_zoning {
+namespace testing {
+namespace {
+
+constexpr uint32_t STEP = 10000;
+constexpr uint32_t HOUR = 3600000;
+
+class ThermalPlantTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    plant_.set_num_zones(3);
+    plant_.set_weather(0.0f, 0.0f);
+    for (uint8_t i = 0; i < 3; i++) {
+      PlantZone &z = plant_.zone(i);
+      z.internal_kw = 0.0f;
+      z.solar_kw = 0.0f;
+      z.capacity_kj_per_k = 8000.0f;
+      z.loss_kw_per_k = 0.05f;
+      z.heat_setpoint = 20.5f;
+      z.temperature = 20.0f;
+    }
+  }
+
+  void run(uint32_t ms, uint8_t mode, uint16_t dampers) {
+    for (uint32_t t = 0; t < ms; t += STEP) plant_.step(t, STEP, mode, dampers);
+  }
+  uint8_t calls(uint8_t zone) { return (plant_.thermostats() >> (4 * zone)) & 0xF; }
+
+  ThermalPlant plant_;
+};
+
+TEST_F(ThermalPlantTest, FreeFloatingZoneRelaxesTowardOutdoor) {
+  const uint32_t tau_ms = static_cast<uint32_t>(8000.0f / 0.05f * 1000.0f);  // C / UA
+  run(tau_ms, ARRET, 0b111);
+  EXPECT_NEAR(plant_.zone(0).temperature, 20.0f * std::exp(-1.0f), 0.05f);
+}
+
+TEST_F(ThermalPlantTest, ThermostatCallsFollowTheirHysteresis) {
+  PlantZone &z = plant_.zone(0);  // heat 20.5, cool 24.0, differential 0.3, stage 2 at 1.5
+  z.temperature = 20.3f;
+  EXPECT_EQ(calls(0), OFF);
+  z.temperature = 20.1f;
+  EXPECT_EQ(calls(0), HEAT1);
+  z.temperature = 20.4f;
+  EXPECT_EQ(calls(0), HEAT1);  // until the setpoint
+  z.temperature = 20.5f;
+  EXPECT_EQ(calls(0), OFF);
+  z.temperature = 18.9f;
+  EXPECT_EQ(calls(0), HEAT2);
+  z.temperature = 24.4f;
+  EXPECT_EQ(calls(0), OFF);  // the heating call ends first
+  EXPECT_EQ(calls(0), COOL1);
+}
+
+TEST_F(ThermalPlantTest, UnitAirGoesOnlyThroughOpenDampers) {
+  plant_.set_weather(20.0f, 0.0f);
+  run(HOUR, CHAUFFAGE1, 0b001);
+  // 6 kW for 1 h into 8000 kJ/K, minus the loss as it warms
+  EXPECT_NEAR(plant_.zone(0).temperature, 22.6f, 0.1f);
+  EXPECT_FLOAT_EQ(plant_.zone(1).temperature, 20.0f);
+
+  run(HOUR, CLIM1, 0b110);  // split between two zones
+  EXPECT_NEAR(plant_.zone(1).temperature, 18.65f, 0.1f);
+  EXPECT_FLOAT_EQ(plant_.zone(1).temperature, plant_.zone(2).temperature);
+}
+
+// ---------------------------------------------------------------------------
+// Closed loop
+// ---------------------------------------------------------------------------
+
+class PlantLoopTest : public ThermalPlantTest {
+ protected:
+  void SetUp() override {
+    ThermalPlantTest::SetUp();
+    host::reset();
+    host::set_log_sink(nullptr);
+    core_.reset(3);
+    core_.set_min_cycle_time(5 * MIN);
+    core_.set_purge_duration(5 * MIN);
+    plant_.set_weather(20.0f, 0.0f);  // only the cold zone calls
+    for (uint8_t i = 0; i < 3; i++) plant_.zone(i).temperature = 20.6f;
+  }
+
+  ControlCore core_;
+};
+
+TEST_F(PlantLoopTest, OneCallIsCountedFromStartToPurge) {
+  plant_.zone(0).temperature = 18.5f;  // stage 2 call
+  PlantLoop loop(&core_, &plant_);
+  loop.start();
+  loop.run_for(3 * HOUR);
+
+  const PlantMetrics &m = loop.metrics();
+  EXPECT_EQ(m.elapsed_ms, 3ull * HOUR);
+  EXPECT_EQ(m.compressor_starts, 1u);
+  EXPECT_EQ(m.zones[0].calls, 1u);
+  EXPECT_EQ(m.zones[0].satisfied, 1u);
+  EXPECT_EQ(m.zones[0].to_setpoint_ms, m.zones[0].max_to_setpoint_ms);
+  EXPECT_NEAR(m.hours(m.compressor_ms), m.hours(m.zones[0].to_setpoint_ms), 0.01);  // beyond the minimum cycle
+  EXPECT_GT(m.stage2_ms, 0u);
+  EXPECT_NEAR(m.purge_fan_ms, 5 * MIN, 15000);  // purge from the poll after the call
+  EXPECT_EQ(m.zones[1].damper_moves, 2u);       // closed for the call, open after the purge
+  EXPECT_EQ(m.zones[0].damper_moves, 0u);
+  EXPECT_GT(m.zones[0].unmet_ms, 0u);  // from 18.5 °C to 19.5 °C
+  EXPECT_EQ(m.zones[1].unmet_ms, 0u);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace open_zoning
+}  // namespace esphome
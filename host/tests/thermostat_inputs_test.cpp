@@ -0,0 +1,251 @@
+// ThermostatInputs: bulk GPIO reads, pin map and software debounce; then
+// damper pre-positioning on the raw samples.
+
+#include <gtest/gtest.h>
+
+#include "control_core.h"
+#include "controller_fixture.h"
+#include "fake_bus.h"
+#include "thermostat_inputs.h"
+
+namespace esphome {
+namespace open_zoning {
+namespace testing {
+
+/// Panel wiring of zones 1 and 2 (port 0 = 0x20) and zone 3 on port 1 (0x21).
+/// Inputs are active low, like the pulled-up thermostat contacts.
+class InputsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    inputs_.add_port(0x20, true);
+    inputs_.add_port(0x21, true);
+    inputs_.set_zone_pins(0, 0, 14, 15, 13, 12);
+    inputs_.set_zone_pins(1, 0, 10, 11, 9, 8);
+    inputs_.set_zone_pins(2, 1, 14, 15, 13, 12);
+    inputs_.set_debounce(1000);
+    inputs_.set_bus(&bus_);
+    bus_.set_gpio(0x20, 0xFFFF);
+    bus_.set_gpio(0x21, 0xFFFF);
+    inputs_.setup();
+  }
+
+  /// Drive pins active (low) on an expander, the others released
+  void active(uint8_t address, uint16_t pins) { bus_.set_gpio(address, static_cast<uint16_t>(~pins)); }
+
+  host::FakeBus bus_;
+  ThermostatInputs inputs_;
+};
+
+TEST_F(InputsTest, SetupMakesMappedPinsPulledUpInputs) {
+  EXPECT_EQ(bus_.get_register(0x20, 0x0C) | bus_.get_register(0x20, 0x0D) << 8, 0xFF00);
+  EXPECT_EQ(bus_.get_register(0x21, 0x0C) | bus_.get_register(0x21, 0x0D) << 8, 0xF000);
+}
+
+TEST_F(InputsTest, OneReadPerPortMapsPinsToZoneNibbles) {
+  active(0x20, 1u << 14 | 1u << 13);            // zone 1: Y1 G
+  active(0x21, 1u << 14 | 1u << 13 | 1u << 12);  // zone 3: Y1 G OB
+  const uint32_t before20 = bus_.get_transactions(0x20);
+  const uint32_t before21 = bus_.get_transactions(0x21);
+  inputs_.sample(0);
+  EXPECT_EQ(bus_.get_transactions(0x20) - before20, 2u);  // register pointer + 2-byte read
+  EXPECT_EQ(bus_.get_transactions(0x21) - before21, 2u);
+
+  const uint32_t expected = (ControlCore::IN_Y1 | ControlCore::IN_G) |
+                            static_cast<InputWord>(ControlCore::IN_Y1 | ControlCore::IN_G | ControlCore::IN_OB) << 8;
+  EXPECT_EQ(inputs_.get_raw(), expected);
+  EXPECT_EQ(inputs_.get_state(), 0u);  // not debounced yet
+  EXPECT_TRUE(inputs_.sample(1000));
+  EXPECT_EQ(inputs_.get_state(), expected);
+}
+
+TEST_F(InputsTest, InputMustHoldForTheWholeDebounce) {
+  active(0x20, 1u << 13);  // zone 1: G
+  inputs_.sample(0);
+  active(0x20, 0);  // released before the debounce
+  EXPECT_FALSE(inputs_.sample(500));
+  active(0x20, 1u << 13);  // again: the hold time restarts
+  EXPECT_FALSE(inputs_.sample(600));
+  EXPECT_FALSE(inputs_.sample(1599));
+  EXPECT_TRUE(inputs_.sample(1600));
+  EXPECT_EQ(inputs_.get_state(), ControlCore::IN_G);
+
+  active(0x20, 0);  // release is debounced too
+  EXPECT_FALSE(inputs_.sample(5000));
+  EXPECT_EQ(inputs_.get_state(), ControlCore::IN_G);
+  EXPECT_TRUE(inputs_.sample(6000));
+  EXPECT_EQ(inputs_.get_state(), 0u);
+}
+
+TEST_F(InputsTest, DeadPortKeepsItsLastInputs) {
+  active(0x21, 1u << 13);  // zone 3: G
+  inputs_.sample(0);
+  inputs_.sample(1000);
+  ASSERT_EQ(inputs_.get_state(), static_cast<InputWord>(ControlCore::IN_G) << 8);
+
+  bus_.set_dead(0x21, true);
+  active(0x20, 1u << 9);  // zone 2: G, on the live port
+  inputs_.sample(2000);
+  inputs_.sample(3000);
+  EXPECT_EQ(inputs_.get_state(),
+            static_cast<InputWord>(ControlCore::IN_G) << 8 | static_cast<InputWord>(ControlCore::IN_G) << 4);
+  EXPECT_EQ(inputs_.get_read_errors(), 2u);
+}
+
+// ---------------------------------------------------------------------------
+// Damper pre-positioning
+// ---------------------------------------------------------------------------
+
+/// The controller on one input port (0x20, active low), zone i on pins
+/// 4i..4i+3 in ControlCore::IN_* order; event-driven, 1 s debounce.
+class PrepositionTest : public ControllerTest {
+ protected:
+  void SetUp() override {
+    ControllerTest::SetUp();
+    ctrl_.add_input_port(0x20, true);
+    for (uint8_t i = 0; i < ZONES; i++) ctrl_.set_zone_input_pins(i, 0, 4 * i, 4 * i + 1, 4 * i + 2, 4 * i + 3);
+    ctrl_.set_preposition_dampers(true);
+    raw(0, 0);
+  }
+
+  /// Raw level of one zone's contacts (the others unchanged)
+  void raw(uint8_t zone, uint8_t bits) {
+    word_ = static_cast<uint16_t>((word_ & ~(0x0Fu << (4 * zone))) | static_cast<uint16_t>(bits) << (4 * zone));
+    bus_.set_gpio(0x20, static_cast<uint16_t>(~word_));
+  }
+
+  uint16_t word_{0};
+};
+
+constexpr uint8_t HEAT = ControlCore::IN_Y1 | ControlCore::IN_G;
+constexpr uint8_t COOL = HEAT | ControlCore::IN_OB;
+
+TEST_F(PrepositionTest, RawEdgeOpensTheDamperBeforeTheDebounce) {
+  start();
+  raw(0, HEAT);
+  step(2000);
+  ASSERT_EQ(state(0), "Heating Stage 1");
+  ASSERT_FALSE(open_[1].state);  // zone 2 off while zone 1 heats
+
+  raw(1, HEAT);
+  step(500);  // stop phases 50 + 250 ms, debounce still running
+  EXPECT_EQ(state(1), "Off");
+  EXPECT_TRUE(open_[1].state);
+  EXPECT_EQ(ctrl_.get_prepositioned(), 0b010);
+
+  step(1000);  // debounced, evaluated: the core's own target now
+  EXPECT_EQ(state(1), "Heating Stage 1");
+  EXPECT_TRUE(open_[1].state);
+  EXPECT_EQ(ctrl_.get_prepositioned(), 0);
+  EXPECT_EQ(ctrl_.get_prepositions(), 1u);
+  EXPECT_EQ(ctrl_.get_preposition_rollbacks(), 0u);
+}
+
+TEST_F(PrepositionTest, UnconfirmedCallIsRolledBack) {
+  start();
+  raw(0, HEAT);
+  step(2000);
+
+  raw(1, HEAT);
+  step(400);
+  ASSERT_TRUE(open_[1].state);
+  raw(1, 0);  // released before the debounce
+  step(2000);
+  EXPECT_EQ(state(1), "Off");
+  EXPECT_FALSE(open_[1].state);
+  EXPECT_TRUE(close_[1].state);
+  EXPECT_EQ(ctrl_.get_preposition_rollbacks(), 1u);
+}
+
+TEST_F(PrepositionTest, LowerPriorityCallWaitsForTheCore) {
+  start();
+  raw(0, HEAT);
+  step(2000);
+
+  raw(1, COOL);  // would be held in WAIT behind heating
+  step(2000);
+  EXPECT_EQ(ctrl_.get_prepositions(), 0u);
+  EXPECT_FALSE(open_[1].state);
+}
+
+TEST_F(PrepositionTest, FirstCallFromIdleHoldIsPrepositioned) {
+  ctrl_.set_damper_idle_hold(true);
+  start();
+  raw(0, HEAT);
+  step(2000);
+  raw(0, 0);
+  step(15 * 60000);  // minimum cycle, purge, rest
+  ASSERT_EQ(mode(), ARRET);
+  ASSERT_FALSE(open_[1].state);  // left closed at rest
+  ASSERT_FALSE(open_[2].state);
+
+  raw(1, HEAT);
+  raw(2, COOL);  // the heating call wins from rest: zone 3 would wait
+  step(500);
+  EXPECT_EQ(state(1), "Off");
+  EXPECT_TRUE(open_[1].state);
+  EXPECT_FALSE(open_[2].state);
+  EXPECT_EQ(ctrl_.get_prepositioned(), 0b010);
+
+  step(1000);
+  EXPECT_EQ(state(1), "Heating Stage 1");
+  EXPECT_EQ(state(2), "Wait");
+  EXPECT_EQ(ctrl_.get_preposition_rollbacks(), 0u);
+}
+
+TEST_F(PrepositionTest, CallHeldByTheMinimumDemandIsNotPrepositioned) {
+  ctrl_.set_damper_idle_hold(true);
+  ctrl_.set_min_active_zones(2);
+  start();
+  raw(0, HEAT);
+  raw(1, HEAT);
+  step(2000);
+  raw(0, 0);
+  raw(1, 0);
+  step(15 * 60000);
+  ASSERT_EQ(mode(), ARRET);
+  ASSERT_FALSE(open_[2].state);
+
+  raw(2, HEAT);  // alone: PASS 2.5 holds it
+  step(500);
+  EXPECT_FALSE(open_[2].state);
+  EXPECT_EQ(ctrl_.get_prepositions(), 0u);
+}
+
+TEST_F(PrepositionTest, EventGoesToTheRingOfTheZonesUnit) {
+  if (MAX_UNITS < 2) GTEST_SKIP() << "built for one central unit";
+  switch_::Switch out2[7];
+  ctrl_.set_num_units(2);
+  ctrl_.set_zone_unit(1, 1);
+  ctrl_.set_zone_unit(2, 1);
+  ctrl_.set_unit_outputs(1, &out2[0], &out2[1], &out2[2], &out2[3], &out2[4], &out2[5], &out2[6]);
+  start();
+  raw(1, HEAT);
+  step(2000);
+  ASSERT_EQ(ctrl_.get_unit_mode(1), CHAUFFAGE1);
+
+  raw(2, HEAT);
+  step(500);
+  ASSERT_EQ(ctrl_.get_prepositions(), 1u);
+  const auto count = [](const EventLog &log) {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < log.size(); i++) n += log.at(i).id == Event::DAMPER_PREPOSITION;
+    return n;
+  };
+  EXPECT_EQ(count(ctrl_.get_unit_core(1).events()), 1);
+  EXPECT_EQ(count(ctrl_.get_unit_core(0).events()), 0);
+}
+
+TEST_F(PrepositionTest, DisabledByDefault) {
+  ctrl_.set_preposition_dampers(false);
+  start();
+  raw(0, HEAT);
+  step(2000);
+  raw(1, HEAT);
+  step(500);
+  EXPECT_FALSE(open_[1].state);
+  EXPECT_EQ(ctrl_.get_prepositions(), 0u);
+}
+
+}  // namespace testing
+}  // namespace open_zoning
+}  // namespace esphome
@@ -0,0 +1,650 @@
+// Times OpenZoningController::update() and each stage of its pipeline over
+// fixed thermostat scenarios, on the virtual clock, and compares the result
+// with a saved baseline.
+//
+//   oz_bench [-c cycles] [-r repeats] [-s scenario] [-t tolerance%]
+//            [--save file] [--compare file]
+//
+// Per scenario: ns per update() (fastest of the repeats, cycle by cycle), ns
+// per update() spent in each pass, the commit and the publish stage (stage
+// timing builds), instructions and branches per update() (Linux perf events,
+// when the kernel exposes them) and the deepest stack used below update().
+// Default tolerance of --compare: 15 %.
+// Exit status: 0; 1 when --compare finds a regression or a scenario never
+// reaches its target state; 2 on bad arguments or an unreadable baseline.
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+
+#include "open_zoning.h"
+#include "platform.h"
+
+namespace esphome {
+namespace open_zoning {
+namespace {
+
+constexpr uint8_t OFF = 0;
+constexpr uint8_t HEAT1 = ControlCore::IN_Y1 | ControlCore::IN_G;
+constexpr uint8_t COOL1 = ControlCore::IN_Y1 | ControlCore::IN_G | ControlCore::IN_OB;
+constexpr uint8_t NO_FAN = ControlCore::IN_Y1;  // compressor call without G: error
+
+// ---------------------------------------------------------------------------
+// Scenarios: thermostat bits of each zone at each cycle, and the state the
+// scenario exists to exercise (it must be seen at least once)
+// ---------------------------------------------------------------------------
+
+struct Scenario {
+  const char *name;
+  uint8_t (*call)(uint8_t zone, uint32_t cycle, uint8_t zones);
+  bool (*reached)(const ControlCore &core, uint8_t zones);
+};
+
+bool any_zone_in(const ControlCore &core, uint8_t zones, ZoneState s) {
+  for (uint8_t i = 0; i < zones; i++) {
+    if (core.zone_state(i) == s) return true;
+  }
+  return false;
+}
+
+const Scenario SCENARIOS[] = {
+    {"idle", [](uint8_t, uint32_t, uint8_t) { return OFF; },
+     [](const ControlCore &core, uint8_t) { return core.get_current_mode() == 0 && !core.has_zone_error(); }},
+    {"single_heat", [](uint8_t zone, uint32_t, uint8_t) { return zone == 0 ? HEAT1 : OFF; },
+     [](const ControlCore &core, uint8_t) { return core.zone_state(0) == ZoneState::HEATING_STAGE1; }},
+    // Even zones heat, odd zones cool; one zone at a time is satisfied for 16 cycles
+    {"contention",
+     [](uint8_t zone, uint32_t cycle, uint8_t zones) -> uint8_t {
+       if ((cycle / 16) % zones == zone) return OFF;
+       return zone % 2 == 0 ? HEAT1 : COOL1;
+     },
+     [](const ControlCore &core, uint8_t zones) { return any_zone_in(core, zones, ZoneState::WAIT); }},
+    // Every zone calls for 40 cycles of each 120, the starts spread over the
+    // first 40 whatever the zone count: calls start and end all along, and
+    // the last 40 cycles, every zone off, leave room for the purge
+    {"purge_storm",
+     [](uint8_t zone, uint32_t cycle, uint8_t zones) -> uint8_t {
+       const uint32_t start = 40u * zone / zones;
+       const uint32_t at = cycle % 120;
+       if (at < start || at >= start + 40) return OFF;
+       return zone % 2 == 0 ? HEAT1 : COOL1;
+     },
+     [](const ControlCore &core, uint8_t zones) { return any_zone_in(core, zones, ZoneState::PURGE); }},
+    {"all_error", [](uint8_t, uint32_t, uint8_t) { return NO_FAN; },
+     [](const ControlCore &core, uint8_t zones) {
+       for (uint8_t i = 0; i < zones; i++) {
+         if (core.zone_state(i) != ZoneState::ERROR) return false;
+       }
+       return true;
+     }},
+};
+
+// ---------------------------------------------------------------------------
+// The controller wired to stand-in entities (as in the host tests), every
+// zone configured. Event-driven runs are off: inputs are read by update().
+// ---------------------------------------------------------------------------
+
+struct Rig {
+  static constexpr uint8_t ZONES = MAX_ZONES;
+
+  Rig() {
+    host::reset();
+    host::set_log_sink(nullptr);
+    host::set_now(1000);
+    ctrl.set_num_zones(ZONES);
+    ctrl.set_time_source(&host::now);
+    ctrl.set_event_driven(false);
+    for (uint8_t i = 0; i < ZONES; i++) {
+      ctrl.set_zone_sensors(i, &y1[i], &y2[i], &g[i], &ob[i]);
+      ctrl.set_zone_dampers(i, &open[i], &close[i]);
+      ctrl.set_zone_state_sensor(i, &state[i]);
+      ctrl.set_zone_ob_on_heat(i, false);
+    }
+    ctrl.set_out_y1(&out[0]);
+    ctrl.set_out_y2(&out[1]);
+    ctrl.set_out_g(&out[2]);
+    ctrl.set_out_ob(&out[3]);
+    ctrl.set_out_w1e(&out[4]);
+    ctrl.set_out_w2(&out[5]);
+    ctrl.set_out_w3(&out[6]);
+    ctrl.set_led_heat(&led[0]);
+    ctrl.set_led_cool(&led[1]);
+    ctrl.set_led_fan(&led[2]);
+    ctrl.set_led_error(&led[3]);
+    ctrl.set_mode_select(&mode);
+    ctrl.set_active_zones_sensor(&active_zones);
+    ctrl.set_stage1_elapsed_sensor(&stage1_elapsed);
+    ctrl.set_mode_changes_sensor(&mode_changes);
+    ctrl.set_short_cycle_sensor(&short_cycle);
+    ctrl.setup();
+  }
+
+  /// Thermostat inputs of this cycle (outside the timed call)
+  void apply(const Scenario &s) {
+    for (uint8_t i = 0; i < ZONES; i++) {
+      const uint8_t bits = s.call(i, cycle, ZONES);
+      y1[i].publish_state(bits & ControlCore::IN_Y1);
+      y2[i].publish_state(bits & ControlCore::IN_Y2);
+      g[i].publish_state(bits & ControlCore::IN_G);
+      ob[i].publish_state(bits & ControlCore::IN_OB);
+    }
+  }
+  /// Damper motor steps and the clock up to the next update (untimed)
+  void finish(const Scenario &s) {
+    reached = reached || s.reached(ctrl.get_unit_core(0), ZONES);
+    ctrl.loop();
+    host::advance(ctrl.get_update_interval());
+    cycle++;
+  }
+
+  OpenZoningController ctrl;
+  binary_sensor::BinarySensor y1[ZONES], y2[ZONES], g[ZONES], ob[ZONES];
+  switch_::Switch open[ZONES], close[ZONES];
+  text_sensor::TextSensor state[ZONES];
+  switch_::Switch out[7];  // Y1 Y2 G OB W1e W2 W3
+  switch_::Switch led[4];  // heat cool fan error
+  select::Select mode;
+  sensor::Sensor active_zones, stage1_elapsed, mode_changes;
+  binary_sensor::BinarySensor short_cycle;
+  uint32_t cycle{0};
+  bool reached{false};
+};
+
+// ---------------------------------------------------------------------------
+// Clocks and counters
+// ---------------------------------------------------------------------------
+
+uint64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+#ifdef OPEN_ZONING_STAGE_TIMING
+// StageTimings clocks: nanoseconds (a wrap every 4.3 s does not matter for
+// differences), or nothing while update() itself is timed
+uint32_t ns_clock() { return static_cast<uint32_t>(now_ns()); }
+uint32_t zero_clock() { return 0; }
+#endif
+
+/// Smallest interval two back-to-back reads of a clock can measure
+template<typename F> uint64_t clock_overhead(F read) {
+  uint64_t best = UINT64_MAX;
+  for (int k = 0; k < 1000; k++) {
+    const uint64_t a = read();
+    const uint64_t b = read();
+    best = std::min<uint64_t>(best, b - a);
+  }
+  return best;
+}
+
+/// User-space instructions and branches of the enabled intervals (perf
+/// events group). available() is false when the kernel or the sandbox does
+/// not expose the hardware counters.
+class PerfCounters {
+ public:
+  PerfCounters() {
+#ifdef __linux__
+    leader_ = open_(PERF_COUNT_HW_INSTRUCTIONS, -1);
+    if (leader_ >= 0) branches_ = open_(PERF_COUNT_HW_BRANCH_INSTRUCTIONS, leader_);
+#endif
+  }
+  ~PerfCounters() {
+#ifdef __linux__
+    if (branches_ >= 0) close(branches_);
+    if (leader_ >= 0) close(leader_);
+#endif
+  }
+  bool available() const { return leader_ >= 0 && branches_ >= 0; }
+
+  void reset() {
+#ifdef __linux__
+    if (available()) ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+#endif
+  }
+  void start() {
+#ifdef __linux__
+    ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+  }
+  void stop() {
+#ifdef __linux__
+    ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+  }
+  bool read(uint64_t *instructions, uint64_t *branches) const {
+#ifdef __linux__
+    uint64_t values[3];  // PERF_FORMAT_GROUP: count, then one value per event
+    if (::read(leader_, values, sizeof(values)) != sizeof(values)) return false;
+    *instructions = values[1];
+    *branches = values[2];
+    return true;
+#else
+    return false;
+#endif
+  }
+
+ protected:
+#ifdef __linux__
+  static int open_(uint64_t config, int group) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+  }
+#endif
+  int leader_{-1};
+  int branches_{-1};
+};
+
+// ---------------------------------------------------------------------------
+// Stack depth: update() runs on a thread whose stack is painted below the
+// caller before each call; the deepest overwritten byte is the high-water mark
+// ---------------------------------------------------------------------------
+
+constexpr size_t STACK_SIZE = 256 * 1024;
+constexpr uint8_t PAINT = 0xA5;
+constexpr size_t RED_ZONE = 256;  // left unpainted below the caller (x86-64 red zone, call frame)
+
+__attribute__((noinline)) uintptr_t stack_pointer() { return reinterpret_cast<uintptr_t>(__builtin_frame_address(0)); }
+
+struct StackRun {
+  const Scenario *scenario;
+  uint32_t cycles;
+  uint8_t *base;
+  size_t deepest{0};
+};
+
+void *stack_thread(void *arg) {
+  StackRun &run = *static_cast<StackRun *>(arg);
+  std::unique_ptr<Rig> rig(new Rig());
+  for (uint32_t c = 0; c < run.cycles; c++) {
+    rig->apply(*run.scenario);
+    const uintptr_t sp = stack_pointer();
+    uint8_t *const limit = reinterpret_cast<uint8_t *>(sp - RED_ZONE);
+    std::memset(run.base, PAINT, limit - run.base);
+    rig->ctrl.update();
+    const uint8_t *p = run.base;
+    while (p < limit && *p == PAINT) p++;
+    run.deepest = std::max<size_t>(run.deepest, sp - reinterpret_cast<uintptr_t>(p));
+    rig->finish(*run.scenario);
+  }
+  return nullptr;
+}
+
+size_t measure_stack(const Scenario &s, uint32_t cycles) {
+  void *stack = nullptr;
+  if (posix_memalign(&stack, 4096, STACK_SIZE) != 0) return 0;
+  StackRun run{&s, cycles, static_cast<uint8_t *>(stack)};
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setstack(&attr, stack, STACK_SIZE);
+  pthread_t thread;
+  if (pthread_create(&thread, &attr, stack_thread, &run) == 0) pthread_join(thread, nullptr);
+  pthread_attr_destroy(&attr);
+  std::free(stack);
+  return run.deepest;
+}
+
+// ---------------------------------------------------------------------------
+// One scenario
+// ---------------------------------------------------------------------------
+
+#ifdef OPEN_ZONING_STAGE_TIMING
+// Stages reported per update(), in pipeline order
+const Stage REPORTED[] = {Stage::PASS1, Stage::PASS1_5, Stage::PASS2,   Stage::PASS2_5,       Stage::PASS3,
+                          Stage::PASS4, Stage::PASS5,   Stage::COMMIT,  Stage::APPLY_DAMPERS, Stage::APPLY_OUTPUTS,
+                          Stage::PUBLISH};
+#endif
+
+using Metrics = std::vector<std::pair<std::string, double>>;
+
+struct Options {
+  uint32_t cycles{20000};
+  uint32_t repeats{5};
+  const char *only{nullptr};
+  double tolerance{15.0};
+  const char *save{nullptr};
+  const char *compare{nullptr};
+};
+
+#ifdef OPEN_ZONING_STAGE_TIMING
+constexpr size_t NUM_REPORTED = sizeof(REPORTED) / sizeof(REPORTED[0]);
+#else
+constexpr size_t NUM_REPORTED = 0;
+#endif
+
+/// Fastest ns seen for each cycle: update() in column 0, then each reported
+/// stage. Runs are deterministic (same inputs, same virtual clock), so cycle
+/// c does the same work in every repeat; its minimum drops the interrupts
+/// and the slow stretches of a shared machine that hit one repeat.
+class CycleMinima {
+ public:
+  static constexpr size_t COLUMNS = 1 + NUM_REPORTED;
+
+  explicit CycleMinima(uint32_t cycles) : ns_(static_cast<size_t>(cycles) * COLUMNS, UINT64_MAX) {}
+  void add(uint32_t cycle, size_t column, uint64_t ns) {
+    uint64_t &best = ns_[cycle * COLUMNS + column];
+    if (ns < best) best = ns;
+  }
+  /// Mean over the cycles of one column
+  double mean(size_t column) const {
+    const size_t cycles = ns_.size() / COLUMNS;
+    uint64_t total = 0;
+    for (size_t c = 0; c < cycles; c++) total += ns_[c * COLUMNS + column];
+    return static_cast<double>(total) / cycles;
+  }
+
+ protected:
+  std::vector<uint64_t> ns_;
+};
+
+/// One run of the scenario on a fresh controller, timing update() or, with
+/// `stages`, each reported stage by its own StageTimer on a nanosecond clock
+/// (a pass skipped by a settled core counts 0: the figures are per update())
+void timed_run(const Scenario &s, uint32_t cycles, bool stages, PerfCounters *perf, CycleMinima *minima,
+               bool *reached) {
+  std::unique_ptr<Rig> rig(new Rig());
+  const uint64_t overhead = clock_overhead(now_ns);
+#ifdef OPEN_ZONING_STAGE_TIMING
+  // Without stages, the stage timers read a clock that returns at once
+  StageTimings &timings = rig->ctrl.get_stage_timings();
+  timings.set_clock(stages ? &ns_clock : &zero_clock);
+  const uint64_t stage_overhead = clock_overhead(ns_clock);
+#endif
+  if (perf) perf->reset();
+  for (uint32_t c = 0; c < cycles; c++) {
+    rig->apply(s);
+    if (perf) perf->start();
+    const uint64_t t0 = now_ns();
+    rig->ctrl.update();
+    const uint64_t t1 = now_ns();
+    if (perf) perf->stop();
+    if (minima && !stages) minima->add(c, 0, t1 - t0 > overhead ? t1 - t0 - overhead : 0);
+#ifdef OPEN_ZONING_STAGE_TIMING
+    if (minima && stages) {
+      for (size_t k = 0; k < NUM_REPORTED; k++) {
+        StageStats &st = timings.get(REPORTED[k]);
+        const uint64_t timed = st.count * stage_overhead;
+        minima->add(c, 1 + k, st.total_us > timed ? st.total_us - timed : 0);
+        st = StageStats{};
+      }
+    }
+#endif
+    rig->finish(s);
+  }
+  *reached = rig->reached;
+}
+
+using Results = std::vector<std::pair<std::string, Metrics>>;
+
+/// Every selected scenario. The repeats go round the scenarios, so a slow
+/// stretch of the machine lands on one repeat of each rather than on every
+/// repeat of one. `missed` counts the scenarios that never reach their state.
+Results run_scenarios(const std::vector<const Scenario *> &scenarios, const Options &opt, PerfCounters &perf,
+                      int *missed) {
+  std::vector<CycleMinima> minima(scenarios.size(), CycleMinima(opt.cycles));
+  std::vector<char> reached(scenarios.size());
+  for (uint32_t r = 0; r <= opt.repeats; r++) {
+    for (size_t k = 0; k < scenarios.size(); k++) {
+      bool ok = false;
+      CycleMinima *m = r == 0 ? nullptr : &minima[k];  // the first round warms up
+      timed_run(*scenarios[k], opt.cycles, false, nullptr, m, &ok);
+      if (NUM_REPORTED > 0) timed_run(*scenarios[k], opt.cycles, true, nullptr, m, &ok);
+      reached[k] = ok;
+    }
+  }
+
+  Results all;
+  for (size_t k = 0; k < scenarios.size(); k++) {
+    const Scenario &s = *scenarios[k];
+    Metrics m;
+    m.emplace_back("update_ns", minima[k].mean(0));
+    // Instructions and branches do not vary between runs: one is enough
+    if (perf.available()) {
+      uint64_t instructions = 0, branches = 0;
+      bool ok = false;
+      timed_run(s, opt.cycles, false, &perf, nullptr, &ok);
+      perf.read(&instructions, &branches);
+      m.emplace_back("instructions", static_cast<double>(instructions) / opt.cycles);
+      m.emplace_back("branches", static_cast<double>(branches) / opt.cycles);
+    }
+#ifdef OPEN_ZONING_STAGE_TIMING
+    for (size_t j = 0; j < NUM_REPORTED; j++)
+      m.emplace_back(std::string(StageTimings::stage_name(REPORTED[j])) + "_ns", minima[k].mean(1 + j));
+#endif
+    m.emplace_back("stack_bytes", static_cast<double>(measure_stack(s, std::min<uint32_t>(opt.cycles, 500))));
+    all.emplace_back(s.name, m);
+    if (!reached[k]) {
+      std::printf("%s: target state never reached\n", s.name);
+      (*missed)++;
+    }
+  }
+  return all;
+}
+
+// ---------------------------------------------------------------------------
+// Baseline file: "scenario metric value" per line, '#' comments; the build
+// lines record what the numbers were measured on
+// ---------------------------------------------------------------------------
+
+using Baseline = std::map<std::string, std::map<std::string, double>>;
+
+Metrics build_info(const Options &opt) {
+  Metrics b;
+  b.emplace_back("zones", MAX_ZONES);
+  b.emplace_back("units", MAX_UNITS);
+#ifdef OPEN_ZONING_STAGE_TIMING
+  b.emplace_back("stage_timing", 1);
+#else
+  b.emplace_back("stage_timing", 0);
+#endif
+  b.emplace_back("cycles", opt.cycles);
+  return b;
+}
+
+/// CPU model and count, kernel and architecture: what the timings of a
+/// baseline belong to (comment lines, for the reader)
+std::string machine_info() {
+  std::string cpu = "unknown CPU";
+  long cpus = 1;
+#ifdef __linux__
+  std::ifstream info("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(info, line)) {
+    if (line.compare(0, 10, "model name") != 0) continue;
+    const size_t colon = line.find(':');
+    if (colon != std::string::npos) cpu = line.substr(line.find_first_not_of(' ', colon + 1));
+    break;
+  }
+  cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  utsname u{};
+  if (uname(&u) == 0) return cpu + " x" + std::to_string(cpus) + ", " + u.sysname + " " + u.release + " " + u.machine;
+#endif
+  return cpu + " x" + std::to_string(cpus);
+}
+
+bool save_results(const char *path, const Metrics &build, const Results &all) {
+  FILE *f = std::fopen(path, "w");
+  if (f == nullptr) return false;
+  std::fprintf(f, "# oz_bench baseline: scenario metric value (ns per update(), counts per update(), bytes)\n");
+#if defined(__clang__)
+  std::fprintf(f, "# build type: %s, compiler: clang %s\n", OZ_BENCH_BUILD_TYPE, __clang_version__);
+#else
+  std::fprintf(f, "# build type: %s, compiler: gcc %s\n", OZ_BENCH_BUILD_TYPE, __VERSION__);
+#endif
+  std::fprintf(f, "# machine: %s\n", machine_info().c_str());
+  for (const auto &kv : build) std::fprintf(f, "build %s %g\n", kv.first.c_str(), kv.second);
+  for (const auto &sc : all) {
+    for (const auto &kv : sc.second) std::fprintf(f, "%s %s %.1f\n", sc.first.c_str(), kv.first.c_str(), kv.second);
+  }
+  return std::fclose(f) == 0;
+}
+
+bool load_results(const char *path, Baseline *out) {
+  std::ifstream in(path);
+  if (!in) return false;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream fields(line);
+    std::string scenario, metric;
+    double value;
+    if (!(fields >> scenario >> metric >> value)) return false;
+    (*out)[scenario][metric] = value;
+  }
+  return true;
+}
+
+/// Smallest change worth reporting: timer noise, a few bytes of alignment
+double floor_of(const std::string &metric) {
+  if (metric == "stack_bytes") return 16;
+  if (metric.size() > 3 && metric.compare(metric.size() - 3, 3, "_ns") == 0) return 2;
+  return 1;
+}
+
+/// Prints the metrics that moved beyond the tolerance; returns the regressions
+int compare_results(const Baseline &base, const Metrics &build,
+                    const Results &all, double tolerance) {
+  auto b = base.find("build");
+  for (const auto &kv : build) {
+    if (b == base.end() || !b->second.count(kv.first) || b->second.at(kv.first) != kv.second)
+      std::printf("note: baseline not built with %s %g\n", kv.first.c_str(), kv.second);
+  }
+  int regressions = 0, improvements = 0;
+  for (const auto &sc : all) {
+    auto s = base.find(sc.first);
+    if (s == base.end()) continue;
+    for (const auto &kv : sc.second) {
+      auto it = s->second.find(kv.first);
+      if (it == s->second.end()) continue;
+      const double was = it->second, now = kv.second;
+      if (std::abs(now - was) < floor_of(kv.first) || std::abs(now - was) <= was * tolerance / 100.0) continue;
+      const bool worse = now > was;
+      (worse ? regressions : improvements)++;
+      std::printf("%-12s %-16s %10.1f -> %10.1f  %+6.1f%%  %s\n", sc.first.c_str(), kv.first.c_str(), was, now,
+                  was > 0 ? 100.0 * (now - was) / was : 100.0, worse ? "REGRESSION" : "faster");
+    }
+  }
+  std::printf("%d regression(s), %d improvement(s) beyond %.0f%%\n", regressions, improvements, tolerance);
+  return regressions;
+}
+
+void print_table(const Results &all) {
+  if (all.empty()) return;
+  std::printf("%-16s", "");
+  for (const auto &sc : all) std::printf(" %12s", sc.first.c_str());
+  std::printf("\n");
+  const Metrics &rows = all.front().second;
+  for (size_t k = 0; k < rows.size(); k++) {
+    std::printf("%-16s", rows[k].first.c_str());
+    for (const auto &sc : all) std::printf(" %12.1f", sc.second[k].second);
+    std::printf("\n");
+  }
+}
+
+bool parse_number(const char *arg, double *out) {
+  char *end = nullptr;
+  *out = std::strtod(arg, &end);
+  return end != arg && *end == '\0' && *out > 0;
+}
+
+}  // namespace
+}  // namespace open_zoning
+}  // namespace esphome
+
+using namespace esphome::open_zoning;
+
+int main(int argc, char **argv) {
+  Options opt;
+  for (int k = 1; k < argc; k++) {
+    const char *a = argv[k];
+    const char *value = k + 1 < argc ? argv[k + 1] : nullptr;
+    double n = 0;
+    if (value == nullptr) {
+      a = nullptr;
+    } else if (std::strcmp(a, "-c") == 0 && parse_number(value, &n)) {
+      opt.cycles = static_cast<uint32_t>(n);
+    } else if (std::strcmp(a, "-r") == 0 && parse_number(value, &n)) {
+      opt.repeats = static_cast<uint32_t>(n);
+    } else if (std::strcmp(a, "-t") == 0 && parse_number(value, &n)) {
+      opt.tolerance = n;
+    } else if (std::strcmp(a, "-s") == 0) {
+      opt.only = value;
+    } else if (std::strcmp(a, "--save") == 0) {
+      opt.save = value;
+    } else if (std::strcmp(a, "--compare") == 0) {
+      opt.compare = value;
+    } else {
+      a = nullptr;
+    }
+    if (a == nullptr) {
+      std::fprintf(stderr, "usage: %s [-c cycles] [-r repeats] [-s scenario] [-t tolerance%%] [--save file] "
+                   "[--compare file]\n", argv[0]);
+      return 2;
+    }
+    k++;
+  }
+
+  Baseline base;
+  if (opt.compare && !load_results(opt.compare, &base)) {
+    std::fprintf(stderr, "%s: cannot read baseline\n", opt.compare);
+    return 2;
+  }
+
+  std::vector<const Scenario *> scenarios;
+  for (const Scenario &s : SCENARIOS) {
+    if (opt.only == nullptr || std::strcmp(opt.only, s.name) == 0) scenarios.push_back(&s);
+  }
+  if (scenarios.empty()) {
+    std::fprintf(stderr, "%s: no such scenario\n", opt.only);
+    return 2;
+  }
+
+  PerfCounters perf;
+  std::printf("oz_bench: %u cycles, fastest of %u repeats, %u zones, %u unit(s)%s%s\n", opt.cycles, opt.repeats, MAX_ZONES,
+              MAX_UNITS, perf.available() ? "" : ", no perf counters",
+#ifdef OPEN_ZONING_STAGE_TIMING
+              ""
+#else
+              ", no stage timing"
+#endif
+  );
+
+  int missed = 0;
+  const Results all = run_scenarios(scenarios, opt, perf, &missed);
+  print_table(all);
+
+  const Metrics build = build_info(opt);
+  if (opt.save && !save_results(opt.save, build, all)) {
+    std::fprintf(stderr, "%s: cannot write\n", opt.save);
+    return 2;
+  }
+  int regressions = 0;
+  if (opt.compare) regressions = compare_results(base, build, all, opt.tolerance);
+  return missed == 0 && regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+// Replays a timestamped thermostat script (host/scripts/*.oz) through the
+// whole OpenZoningController on the virtual clock and prints its log.
+//
+//   oz_replay [-v] [-q] script.oz
+//
+// -v adds the DEBUG events, -q prints only failures and the summary.
+// Exit status: 0 when every expectation holds, 1 otherwise, 2 on a bad script.
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "platform.h"
+#include "replay.h"
+
+using esphome::open_zoning::ReplayScript;
+
+int main(int argc, char **argv) {
+  bool verbose = false, quiet = false;
+  const char *path = nullptr;
+  for (int k = 1; k < argc; k++) {
+    if (std::strcmp(argv[k], "-v") == 0) verbose = true;
+    else if (std::strcmp(argv[k], "-q") == 0) quiet = true;
+    else path = argv[k];
+  }
+  if (path == nullptr) {
+    std::fprintf(stderr, "usage: %s [-v] [-q] script.oz\n", argv[0]);
+    return 2;
+  }
+  std::ifstream in(path);
+  if (!in) {
+    std::fprintf(stderr, "%s: cannot open\n", path);
+    return 2;
+  }
+  ReplayScript script;
+  std::string error;
+  if (!script.parse(in, &error)) {
+    std::fprintf(stderr, "%s: %s\n", path, error.c_str());
+    return 2;
+  }
+
+  esphome::host::reset();
+  const int failures = esphome::open_zoning::run_replay(script, quiet ? nullptr : stdout, verbose);
+  if (quiet || failures > 0)
+    std::printf("%s: %d failed expectation(s)\n", path, failures);
+  return failures == 0 ? 0 : 1;
+}
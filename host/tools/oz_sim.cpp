@@ -0,0 +1,128 @@
+// Runs ControlCore against a simulated building for a season
+// (src/thermal_plant.*: RC zones, two-stage thermostats, one central unit)
+// and reports how the settings use the equipment.
+//
+//   oz_sim [-d days] [-z zones] [-o outdoor_mean] [-a outdoor_amplitude]
+//          [-s key value]...
+//
+// -s takes the settings of a replay script header (YAML key names,
+// durations as 5min or 1h30min): -s min_cycle_time 8min -s min_active_zones 2
+// -s damper_idle_hold on.
+// Exit status: 0, 2 on bad arguments.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include "platform.h"
+#include "replay.h"
+#include "thermal_plant.h"
+
+using namespace esphome::open_zoning;
+
+namespace {
+
+/// "1:05" (h:mm) of a duration
+std::string hours_minutes(uint64_t ms) {
+  char buf[24];
+  const uint64_t minutes = (ms + 30000) / 60000;
+  std::snprintf(buf, sizeof(buf), "%llu:%02llu", static_cast<unsigned long long>(minutes / 60),
+                static_cast<unsigned long long>(minutes % 60));
+  return buf;
+}
+
+/// "5min", "1h", "90s": the largest unit that divides the duration
+std::string setting_duration(uint32_t ms) {
+  char buf[24];
+  if (ms != 0 && ms % 3600000 == 0) std::snprintf(buf, sizeof(buf), "%uh", ms / 3600000);
+  else if (ms != 0 && ms % 60000 == 0) std::snprintf(buf, sizeof(buf), "%umin", ms / 60000);
+  else if (ms % 1000 == 0) std::snprintf(buf, sizeof(buf), "%us", ms / 1000);
+  else std::snprintf(buf, sizeof(buf), "%ums", ms);
+  return buf;
+}
+
+bool parse_float(const char *arg, float *out) {
+  char *end = nullptr;
+  *out = std::strtof(arg, &end);
+  return end != arg && *end == '\0';
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  float days = 30, mean = 8, amplitude = 7, zones = MAX_ZONES;
+  std::string header;
+  bool ok = true;
+  for (int k = 1; k < argc && ok; k++) {
+    const char *a = argv[k];
+    if (std::strcmp(a, "-s") == 0 && k + 2 < argc) {
+      header += std::string("set ") + argv[k + 1] + " " + argv[k + 2] + "\n";
+      k += 2;
+    } else if (k + 1 < argc && std::strcmp(a, "-d") == 0) {
+      ok = parse_float(argv[++k], &days) && days > 0;
+    } else if (k + 1 < argc && std::strcmp(a, "-z") == 0) {
+      ok = parse_float(argv[++k], &zones);
+    } else if (k + 1 < argc && std::strcmp(a, "-o") == 0) {
+      ok = parse_float(argv[++k], &mean);
+    } else if (k + 1 < argc && std::strcmp(a, "-a") == 0) {
+      ok = parse_float(argv[++k], &amplitude) && amplitude >= 0;
+    } else {
+      ok = false;
+    }
+  }
+  if (!ok) {
+    std::fprintf(stderr, "usage: %s [-d days] [-z zones] [-o outdoor_mean] [-a outdoor_amplitude] [-s key value]...\n",
+                 argv[0]);
+    return 2;
+  }
+
+  // The settings go through the replay script header: same keys, same checks
+  ReplayScript script;
+  std::string error;
+  std::istringstream text("zones " + std::to_string(static_cast<int>(zones)) + "\n" + header);
+  if (!script.parse(text, &error)) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return 2;
+  }
+
+  esphome::host::reset();
+  esphome::host::set_log_sink(nullptr);
+  static ControlCore core;  // kept off the stack like the adapter's member
+  script.configure(&core);
+  ThermalPlant plant;
+  plant.set_num_zones(script.num_zones());
+  plant.set_weather(mean, amplitude);
+
+  PlantLoop loop(&core, &plant);
+  loop.driver().set_poll_interval(script.poll_ms());
+  loop.driver().set_event_latency(script.event_latency_ms());
+  loop.start();
+  loop.run_for(static_cast<uint64_t>(days * 86400000.0));
+  const PlantMetrics &m = loop.metrics();
+
+  std::printf("oz_sim: %g days, %u zones, outdoor %.1f °C ± %.1f\n", days, script.num_zones(), mean, amplitude);
+  std::printf("settings: min_cycle_time %s, purge_duration %s, stage2_escalation_delay %s, min_active_zones %u\n",
+              setting_duration(core.get_min_cycle_time_ms()).c_str(),
+              setting_duration(core.get_purge_duration_ms()).c_str(),
+              setting_duration(core.get_stage2_escalation_ms()).c_str(), core.get_min_active_zones());
+  std::printf("damper policy: min dwell %s, idle hold %s, close lookahead %s\n",
+              setting_duration(core.get_damper_min_dwell_ms()).c_str(), core.get_damper_idle_hold() ? "on" : "off",
+              setting_duration(core.get_damper_close_lookahead_ms()).c_str());
+  std::printf("compressor  %u starts, %.2f/h, %.1f h running\n", m.compressor_starts, m.starts_per_hour(),
+              m.hours(m.compressor_ms));
+  std::printf("stage 2     %.1f h\n", m.hours(m.stage2_ms));
+  std::printf("fan         %.1f h, purge %.1f h\n", m.hours(m.fan_ms), m.hours(m.purge_fan_ms));
+  std::printf("zone  calls  to setpoint (mean  max)  damper moves  unmet h\n");
+  uint32_t moves = 0;
+  for (uint8_t i = 0; i < script.num_zones(); i++) {
+    const PlantMetrics::ZoneMetrics &z = m.zones[i];
+    moves += z.damper_moves;
+    std::printf("%4u  %5u  %17s %6s  %12u  %7.1f\n", i + 1, z.calls,
+                hours_minutes(z.satisfied ? z.to_setpoint_ms / z.satisfied : 0).c_str(),
+                hours_minutes(z.max_to_setpoint_ms).c_str(), z.damper_moves, m.hours(z.unmet_ms));
+  }
+  std::printf("damper moves %u, %.1f/day\n", moves, moves / (m.hours(m.elapsed_ms) / 24.0));
+  return 0;
+}